@@ -0,0 +1,553 @@
+/*--------
+ * Module:			arrow.c
+ *
+ * Description:		This module exports the rows of results as Apache
+ *					Arrow arrays through the Arrow C Data Interface.
+ *
+ * Classes:			none
+ *
+ * API functions:	none (see SQL_ATTR_PGOPT_ARROW_BATCH)
+ *
+ * Comments:		See "readme.txt" for copyright and license information.
+ *--------
+ */
+
+#include "arrow.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "statement.h"
+#include "qresult.h"
+#include "connection.h"
+#include "pgtypes.h"
+#include "convert.h"
+#include "multibyte.h"
+
+/*
+ *	The Arrow types the columns are exported as. The SQL types of the
+ *	columns decide them, so the driver options (BoolsAsChar, the int8
+ *	handling etc) apply as they do for SQLDescribeCol. The other types
+ *	(numeric included, to keep its precision) are exported as strings,
+ *	or as binaries unless the client encoding is UTF-8.
+ */
+enum
+{
+	ARROW_BOOL = 0
+	,ARROW_INT8
+	,ARROW_INT16
+	,ARROW_INT32
+	,ARROW_UINT32
+	,ARROW_INT64
+	,ARROW_FLOAT
+	,ARROW_DOUBLE
+	,ARROW_DATE32
+	,ARROW_TIME64
+	,ARROW_TIMESTAMP
+	,ARROW_TIMESTAMPTZ
+	,ARROW_UTF8
+	,ARROW_BINARY
+};
+
+static const struct
+{
+	const char *format;
+	int		width;		/* of the values, 0 for the variable-length */
+} arrow_types[] =
+{
+	{"b", 0}	/* bit-packed */
+	,{"c", 1}
+	,{"s", 2}
+	,{"i", 4}
+	,{"I", 4}	/* oid, xid */
+	,{"l", 8}
+	,{"f", 4}
+	,{"g", 8}
+	,{"tdD", 4}	/* days since the epoch */
+	,{"ttu", 8}	/* microseconds since midnight */
+	,{"tsu:", 8}	/* microseconds since the epoch */
+	,{"tsu:UTC", 8}
+	,{"u", 0}
+	,{"z", 0}
+};
+
+/* a column being built, the private data of its array */
+typedef struct
+{
+	OID		field_type;
+	int		kind;
+	UCHAR	   *validity;
+	char	   *values;		/* the fixed-width values, or the data */
+	Int4	   *offsets;	/* of the data of the variable-length values */
+	SQLLEN		data_size;
+	SQLLEN		data_alloc;
+	int64_t		null_count;
+	const void *buffers[3];
+} ArrowColumn;
+
+static int
+arrow_kind(const StatementClass *stmt, OID field_type, int col)
+{
+	const ConnectionClass *conn = SC_get_conn(stmt);
+
+	switch (pgtype_to_concise_type(stmt, field_type, col, conn->connInfo.drivers.unknown_sizes))
+	{
+		case SQL_BIT:
+			return ARROW_BOOL;
+		case SQL_TINYINT:
+			return ARROW_INT8;
+		case SQL_SMALLINT:
+			return ARROW_INT16;
+		case SQL_INTEGER:
+			if (PG_TYPE_OID == field_type ||
+			    PG_TYPE_XID == field_type)
+				return ARROW_UINT32;
+			return ARROW_INT32;
+		case SQL_BIGINT:
+			return ARROW_INT64;
+		case SQL_REAL:
+			if (PG_TYPE_MONEY != field_type)
+				return ARROW_FLOAT;
+			break;
+		case SQL_FLOAT:
+		case SQL_DOUBLE:
+			if (PG_TYPE_MONEY != field_type)
+				return ARROW_DOUBLE;
+			break;
+		case SQL_TYPE_DATE:
+		case SQL_DATE:
+			if (PG_TYPE_DATE == field_type)
+				return ARROW_DATE32;
+			break;
+		case SQL_TYPE_TIME:
+		case SQL_TIME:
+			if (PG_TYPE_TIME == field_type)
+				return ARROW_TIME64;
+			break;
+		case SQL_TYPE_TIMESTAMP:
+		case SQL_TIMESTAMP:
+			if (PG_TYPE_TIMESTAMP_NO_TMZONE == field_type)
+				return ARROW_TIMESTAMP;
+			if (PG_TYPE_DATETIME == field_type)
+				return ARROW_TIMESTAMPTZ;
+			break;
+		case SQL_BINARY:
+		case SQL_VARBINARY:
+		case SQL_LONGVARBINARY:
+			if (PG_TYPE_BYTEA == field_type)
+				return ARROW_BINARY;
+			break;
+	}
+	return UTF8 == conn->ccsc ? ARROW_UTF8 : ARROW_BINARY;
+}
+
+static void
+free_column(ArrowColumn *col)
+{
+	free(col->validity);
+	free(col->values);
+	free(col->offsets);
+	free(col);
+}
+
+/* make room for the rows [0, alloc) of all the columns */
+static BOOL
+reserve_rows(ArrowColumn **cols, int num_cols, SQLLEN used, SQLLEN alloc)
+{
+	int		i;
+	void   *p;
+
+	for (i = 0; i < num_cols; i++)
+	{
+		ArrowColumn *col = cols[i];
+		int		width = arrow_types[col->kind].width;
+
+		if (NULL == (p = realloc(col->validity, (alloc + 7) / 8)))
+			return FALSE;
+		col->validity = p;
+		memset(col->validity + (used + 7) / 8, 0, (alloc + 7) / 8 - (used + 7) / 8);
+		if (ARROW_BOOL == col->kind)
+		{
+			if (NULL == (p = realloc(col->values, (alloc + 7) / 8)))
+				return FALSE;
+			col->values = p;
+			memset(col->values + (used + 7) / 8, 0, (alloc + 7) / 8 - (used + 7) / 8);
+		}
+		else if (width > 0)
+		{
+			if (NULL == (p = realloc(col->values, width * alloc)))
+				return FALSE;
+			col->values = p;
+		}
+		else
+		{
+			if (NULL == (p = realloc(col->offsets, sizeof(Int4) * (alloc + 1))))
+				return FALSE;
+			col->offsets = p;
+			col->offsets[0] = 0;
+		}
+	}
+	return TRUE;
+}
+
+/* make room for len bytes more of variable-length data */
+static BOOL
+reserve_data(ArrowColumn *col, SQLLEN len)
+{
+	SQLLEN	alloc;
+	void   *p;
+
+	if (col->data_size + len <= col->data_alloc)
+		return TRUE;
+	/* the offsets are 32-bit */
+	if (col->data_size + len > INT_MAX)
+		return FALSE;
+	for (alloc = col->data_alloc > 0 ? col->data_alloc : 4096; alloc < col->data_size + len; alloc *= 2)
+		;
+	if (alloc > INT_MAX)
+		alloc = INT_MAX;
+	if (NULL == (p = realloc(col->values, alloc)))
+		return FALSE;
+	col->values = p;
+	col->data_alloc = alloc;
+	return TRUE;
+}
+
+/* append the text value of the row-th row */
+static BOOL
+append_value(ArrowColumn *col, SQLLEN row, const char *value)
+{
+	Int8	ival;
+	SQLLEN	len;
+	BOOL	valid = (NULL != value);
+
+	if (valid)
+	{
+		switch (col->kind)
+		{
+			case ARROW_BOOL:
+				if ('t' == value[0] || '1' == value[0])
+					col->values[row / 8] |= (1 << (row % 8));
+				break;
+			case ARROW_INT8:
+				((SCHAR *) col->values)[row] = (SCHAR) pg_atoi(value);
+				break;
+			case ARROW_INT16:
+				((Int2 *) col->values)[row] = (Int2) pg_atoi(value);
+				break;
+			case ARROW_INT32:
+				((Int4 *) col->values)[row] = (Int4) pg_atol(value);
+				break;
+			case ARROW_UINT32:
+				((UInt4 *) col->values)[row] = (UInt4) strtoul(value, NULL, 10);
+				break;
+			case ARROW_INT64:
+				((Int8 *) col->values)[row] = pg_atoll(value);
+				break;
+			case ARROW_FLOAT:
+				((float *) col->values)[row] = (float) pg_atof(value);
+				break;
+			case ARROW_DOUBLE:
+				((double *) col->values)[row] = pg_atof(value);
+				break;
+			case ARROW_DATE32:
+				if ((valid = datetime_to_epoch(col->field_type, value, &ival)))
+					((Int4 *) col->values)[row] = (Int4) ival;
+				break;
+			case ARROW_TIME64:
+			case ARROW_TIMESTAMP:
+			case ARROW_TIMESTAMPTZ:
+				/*
+				 * infinity is exported as NULL, as are the timestamps
+				 * whose microseconds since the epoch overflow (after
+				 * 294247-01-10)
+				 */
+				if ((valid = datetime_to_epoch(col->field_type, value, &ival)))
+					((Int8 *) col->values)[row] = ival;
+				break;
+			case ARROW_BINARY:
+				if (PG_TYPE_BYTEA == col->field_type)
+				{
+					len = convert_from_pgbinary(value, NULL, 0);
+					if (!reserve_data(col, len))
+						return FALSE;
+					convert_from_pgbinary(value, col->values + col->data_size, len);
+					col->data_size += len;
+					break;
+				}
+				/* fall through */
+			case ARROW_UTF8:
+				len = strlen(value);
+				if (!reserve_data(col, len))
+					return FALSE;
+				memcpy(col->values + col->data_size, value, len);
+				col->data_size += len;
+				break;
+		}
+	}
+	if (valid)
+		col->validity[row / 8] |= (1 << (row % 8));
+	else
+		col->null_count++;
+	if (NULL != col->offsets)
+		col->offsets[row + 1] = (Int4) col->data_size;
+	return TRUE;
+}
+
+static void
+release_child_schema(struct ArrowSchema *schema)
+{
+	free((char *) schema->name);
+	schema->release = NULL;
+}
+
+static void
+release_schema(struct ArrowSchema *schema)
+{
+	int64_t	i;
+
+	for (i = 0; i < schema->n_children; i++)
+	{
+		if (schema->children[i]->release)
+			schema->children[i]->release(schema->children[i]);
+	}
+	free(schema->private_data);
+	schema->release = NULL;
+}
+
+static void
+release_child_array(struct ArrowArray *array)
+{
+	free_column((ArrowColumn *) array->private_data);
+	array->release = NULL;
+}
+
+static void
+release_array(struct ArrowArray *array)
+{
+	int64_t	i;
+
+	for (i = 0; i < array->n_children; i++)
+	{
+		if (array->children[i]->release)
+			array->children[i]->release(array->children[i]);
+	}
+	free(array->private_data);
+	array->release = NULL;
+}
+
+/*
+ *	Build the schema and the array of the struct of the num_cols columns
+ *	of nrows rows. The columns are owned by the array from now on.
+ */
+static BOOL
+export_batch(const QResultClass *res, ArrowColumn **cols, int num_cols, SQLLEN nrows, PG_ARROW_BATCH *batch)
+{
+	struct ArrowSchema *schemas, **schema_children;
+	struct ArrowArray *arrays, **array_children;
+	char	   *schema_mem, *array_mem;
+	int		i;
+
+	/*
+	 *	The children of the schema or the array and the pointers to them,
+	 *	followed by the only buffer (no validity bitmap) of the struct.
+	 */
+	schema_mem = calloc(1, (sizeof(struct ArrowSchema) + sizeof(struct ArrowSchema *)) * num_cols + sizeof(void *));
+	array_mem = calloc(1, (sizeof(struct ArrowArray) + sizeof(struct ArrowArray *)) * num_cols + sizeof(void *));
+	if (NULL == schema_mem || NULL == array_mem)
+	{
+		free(schema_mem);
+		free(array_mem);
+		return FALSE;
+	}
+	schemas = (struct ArrowSchema *) schema_mem;
+	schema_children = (struct ArrowSchema **) (schemas + num_cols);
+	arrays = (struct ArrowArray *) array_mem;
+	array_children = (struct ArrowArray **) (arrays + num_cols);
+	for (i = 0; i < num_cols; i++)
+	{
+		ArrowColumn *col = cols[i];
+
+		schemas[i].format = arrow_types[col->kind].format;
+		schemas[i].name = strdup(QR_get_fieldname(res, i));
+		schemas[i].flags = ARROW_FLAG_NULLABLE;
+		schemas[i].release = release_child_schema;
+		schema_children[i] = schemas + i;
+
+		col->buffers[0] = col->validity;
+		if (NULL != col->offsets)
+		{
+			col->buffers[1] = col->offsets;
+			col->buffers[2] = col->values;
+			arrays[i].n_buffers = 3;
+		}
+		else
+		{
+			col->buffers[1] = col->values;
+			arrays[i].n_buffers = 2;
+		}
+		arrays[i].length = nrows;
+		arrays[i].null_count = col->null_count;
+		arrays[i].buffers = col->buffers;
+		arrays[i].release = release_child_array;
+		arrays[i].private_data = col;
+		array_children[i] = arrays + i;
+	}
+
+	memset(&batch->schema, 0, sizeof(batch->schema));
+	batch->schema.format = "+s";
+	batch->schema.name = "";
+	batch->schema.n_children = num_cols;
+	batch->schema.children = schema_children;
+	batch->schema.release = release_schema;
+	batch->schema.private_data = schema_mem;
+
+	memset(&batch->array, 0, sizeof(batch->array));
+	batch->array.length = nrows;
+	batch->array.n_buffers = 1;
+	batch->array.buffers = (const void **) (array_children + num_cols);
+	batch->array.n_children = num_cols;
+	batch->array.children = array_children;
+	batch->array.release = release_array;
+	batch->array.private_data = array_mem;
+	return TRUE;
+}
+
+/*
+ *	SQLGetStmtAttr(SQL_ATTR_PGOPT_ARROW_BATCH).
+ *
+ *	The rows are fetched one by one as PGAPI_Fetch() does, so that the
+ *	declare/fetch mode, the keysets and SQLFetch() calls before or after
+ *	work as usual, but their values are appended to the Arrow arrays
+ *	instead of being copied into the bound columns.
+ */
+RETCODE
+SC_fetch_arrow_batch(StatementClass *stmt, PG_ARROW_BATCH *batch)
+{
+	CSTR func = "SC_fetch_arrow_batch";
+	QResultClass *res = SC_get_Curres(stmt);
+	ColumnInfoClass *coli;
+	ArrowColumn **cols = NULL;
+	SQLLEN		nrows = 0, alloc = 0, curt;
+	SQLUINTEGER	retrieve_data = stmt->options.retrieve_data;
+	int		num_cols = 0, i;
+	const char *value;
+	RETCODE		ret = SQL_SUCCESS;
+
+	MYLOG(0, "entering stmt=%p max_rows=" FORMAT_LEN "\n", stmt, (SQLLEN) batch->max_rows);
+	if (!res)
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_fetch_arrow_batch.", func);
+		return SQL_ERROR;
+	}
+	if (stmt->status != STMT_FINISHED)
+	{
+		SC_set_error(stmt, STMT_SEQUENCE_ERROR, "Arrow batches can only be fetched after the successful execution on a SQL statement", func);
+		return SQL_ERROR;
+	}
+	if (batch->max_rows <= 0)
+	{
+		SC_set_error(stmt, STMT_INVALID_ARGUMENT_NO, "max_rows of the Arrow batch must be positive", func);
+		return SQL_ERROR;
+	}
+	coli = QR_get_fields(res);
+	num_cols = QR_NumPublicResultCols(res);
+	for (i = 0; i < num_cols; i++)
+	{
+		if (CI_get_format(coli, i))
+		{
+			SC_set_error(stmt, STMT_RESTRICTED_DATA_TYPE_ERROR, "Results in binary format can't be exported as Arrow arrays", func);
+			return SQL_ERROR;
+		}
+	}
+
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	if (num_cols > 0 &&
+	    NULL == (cols = (ArrowColumn **) calloc(num_cols, sizeof(ArrowColumn *))))
+		goto no_memory;
+	for (i = 0; i < num_cols; i++)
+	{
+		if (NULL == (cols[i] = (ArrowColumn *) calloc(1, sizeof(ArrowColumn))))
+			goto no_memory;
+		cols[i]->field_type = CI_get_oid(coli, i);
+		cols[i]->kind = arrow_kind(stmt, cols[i]->field_type, i);
+	}
+
+	/* only move the cursor in SC_fetch() */
+	stmt->options.retrieve_data = SQL_RD_OFF;
+	while (nrows < batch->max_rows)
+	{
+		if (stmt->rowset_start < 0)
+			SC_set_rowset_start(stmt, 0, TRUE);
+		QR_set_reqsize(res, 1);
+		SC_inc_rowset_start(stmt, stmt->last_fetch_count_include_ommitted);
+		ret = SC_fetch(stmt);
+		if (SQL_NO_DATA_FOUND == ret || SQL_ERROR == ret)
+			break;
+		if (0 == stmt->last_fetch_count)
+			continue;	/* a deleted row */
+		if (nrows >= alloc)
+		{
+			SQLLEN	new_alloc = alloc > 0 ? alloc * 2 : 1024;
+
+			if (new_alloc > batch->max_rows)
+				new_alloc = (SQLLEN) batch->max_rows;
+			if (!reserve_rows(cols, num_cols, alloc, new_alloc))
+				goto no_memory;
+			alloc = new_alloc;
+		}
+		curt = GIdx2CacheIdx(stmt->currTuple, stmt, res);
+		for (i = 0; i < num_cols; i++)
+		{
+			if (SC_is_fetchcursor(stmt) && NULL != QR_get_cursor(res))
+				value = QR_get_value_backend(res, i);
+			else
+				value = QR_get_value_backend_row(res, curt, i);
+			if (!append_value(cols[i], nrows, value))
+			{
+				SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't store the values of the Arrow batch", func);
+				ret = SQL_ERROR;
+				goto cleanup;
+			}
+		}
+		nrows++;
+	}
+	if (SQL_ERROR == ret)
+		goto cleanup;
+	if (0 == nrows)
+	{
+		ret = SQL_NO_DATA_FOUND;
+		goto cleanup;
+	}
+	for (i = 0; i < num_cols; i++)
+	{
+		/* the data buffers mustn't be null even if empty */
+		if (NULL != cols[i]->offsets && !reserve_data(cols[i], 1))
+			goto no_memory;
+	}
+	if (!export_batch(res, cols, num_cols, nrows, batch))
+		goto no_memory;
+	MYLOG(0, "exported " FORMAT_LEN " rows\n", nrows);
+	free(cols);
+	cols = NULL;
+	ret = SQL_SUCCESS;
+	goto cleanup;
+
+no_memory:
+	SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate the Arrow batch", func);
+	ret = SQL_ERROR;
+cleanup:
+#undef	return
+	stmt->options.retrieve_data = retrieve_data;
+	if (cols)
+	{
+		for (i = 0; i < num_cols; i++)
+		{
+			if (cols[i])
+				free_column(cols[i]);
+		}
+		free(cols);
+	}
+	return ret;
+}
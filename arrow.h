@@ -0,0 +1,90 @@
+/* File:			arrow.h
+ *
+ * Description:		See "arrow.c"
+ *
+ * Comments:		See "readme.txt" for copyright and license information.
+ *
+ */
+
+#ifndef __ARROW_H__
+#define __ARROW_H__
+
+#include "psqlodbc.h"
+
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/*
+ *	The structures of the Apache Arrow C Data Interface
+ *	(https://arrow.apache.org/docs/format/CDataInterface.html),
+ *	which are defined by each producer and consumer.
+ */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED	1
+#define ARROW_FLAG_NULLABLE		2
+#define ARROW_FLAG_MAP_KEYS_SORTED	4
+
+struct ArrowSchema
+{
+	/* Array type description */
+	const char *format;
+	const char *name;
+	const char *metadata;
+	int64_t		flags;
+	int64_t		n_children;
+	struct ArrowSchema **children;
+	struct ArrowSchema *dictionary;
+
+	/* Release callback */
+	void		(*release) (struct ArrowSchema *);
+	/* Opaque producer-specific data */
+	void	   *private_data;
+};
+
+struct ArrowArray
+{
+	/* Array data description */
+	int64_t		length;
+	int64_t		null_count;
+	int64_t		offset;
+	int64_t		n_buffers;
+	int64_t		n_children;
+	const void **buffers;
+	struct ArrowArray **children;
+	struct ArrowArray *dictionary;
+
+	/* Release callback */
+	void		(*release) (struct ArrowArray *);
+	/* Opaque producer-specific data */
+	void	   *private_data;
+};
+#endif	/* ARROW_C_DATA_INTERFACE */
+
+/*
+ *	The Value of SQLGetStmtAttr(SQL_ATTR_PGOPT_ARROW_BATCH).
+ *
+ *	Fetches up to max_rows rows of the current result from the cursor
+ *	position, as SQLFetch() would, into a struct array ("+s") having a
+ *	child array per result column. schema and array are then owned by
+ *	the caller, who should release them with their release callbacks.
+ *	Returns SQL_NO_DATA, leaving schema and array untouched, once all the
+ *	rows were fetched.
+ */
+typedef struct
+{
+	int64_t		max_rows;	/* in: the maximum rows of the batch */
+	struct ArrowSchema	schema;	/* out */
+	struct ArrowArray	array;	/* out */
+} PG_ARROW_BATCH;
+
+RETCODE		SC_fetch_arrow_batch(StatementClass *stmt, PG_ARROW_BATCH *batch);
+
+#ifdef	__cplusplus
+}
+#endif
+#endif	/* __ARROW_H__ */
@@ -51,10 +51,14 @@
 #define STMT_INCREMENT 16		/* how many statement holders to allocate
 								 * at a time */
 
+#ifndef	LIBPQ_HAS_PIPELINING
 static SQLRETURN CC_lookup_lo(ConnectionClass *self);
+#endif /* LIBPQ_HAS_PIPELINING */
 static int  CC_close_eof_cursors(ConnectionClass *self);
 
 static void LIBPQ_update_transaction_status(ConnectionClass *self);
+static void CC_clear_prepared_cache(ConnectionClass *self);
+static BOOL CC_pool_checkin(ConnectionClass *self);
 
 
 static void CC_set_error_if_not_set(ConnectionClass *self, int errornumber, const char *errormsg, const char *func)
@@ -310,6 +314,12 @@ CC_initialize(ConnectionClass *rv, BOOL lockinit)
 	rv->status = CONN_NOT_CONNECTED;
 	rv->transact_status = CONN_IN_AUTOCOMMIT;		/* autocommit by default */
 	rv->unnamed_prepared_stmt = NULL;
+	rv->copy_stream_res = NULL;
+	rv->pool_key = NULL;
+	rv->session_changed = FALSE;
+	rv->set_since_commit = FALSE;
+	rv->async_stmt = NULL;
+	rv->read_ahead_res = NULL;
 
 	rv->stmts = (StatementClass **) malloc(sizeof(StatementClass *) * STMT_INCREMENT);
 	if (!rv->stmts)
@@ -544,7 +554,7 @@ CC_set_autocommit(ConnectionClass *self, BOOL on)
 }
 
 /* Clear cached table info */
-static void
+void
 CC_clear_col_info(ConnectionClass *self, BOOL destroy)
 {
 	if (self->col_info)
@@ -574,6 +584,7 @@ CC_clear_col_info(ConnectionClass *self, BOOL destroy)
 			}
 		}
 		self->ntables = 0; /* Now we have cleared COL_INFO cached objects table. */
+		self->coli_indexed = FALSE;
 		if (destroy)
 		{
 			/* We destroying COL_INFO cache completely. */
@@ -582,6 +593,16 @@ CC_clear_col_info(ConnectionClass *self, BOOL destroy)
 			self->coli_allocated = 0;
 		}
 	}
+	if (destroy)
+	{
+		if (self->coli_name_index)
+			free(self->coli_name_index);
+		self->coli_name_index = NULL;
+		if (self->coli_oid_index)
+			free(self->coli_oid_index);
+		self->coli_oid_index = NULL;
+		self->coli_index_size = 0;
+	}
 }
 
 static void
@@ -675,10 +696,23 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	/* even if we are in auto commit. */
 	if (self->pqconn)
 	{
-		QLOG(0, "PQfinish: %p\n", self->pqconn);
-		PQfinish(self->pqconn);
+		if (keepCommunication || !CC_pool_checkin(self))
+		{
+			QLOG(0, "PQfinish: %p\n", self->pqconn);
+			PQfinish(self->pqconn);
+		}
 		self->pqconn = NULL;
 	}
+	self->copy_stream_res = NULL;
+	if (self->pool_key)
+	{
+		free(self->pool_key);
+		self->pool_key = NULL;
+	}
+	self->session_changed = FALSE;
+	self->set_since_commit = FALSE;
+	self->async_stmt = NULL;
+	self->read_ahead_res = NULL;
 
 	MYLOG(0, "after PQfinish\n");
 
@@ -754,6 +788,9 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	}
 	/* Free cached table info */
 	CC_clear_col_info(self, TRUE);
+	/* The server-side plans have gone with the connection */
+	CC_clear_prepared_cache(self);
+	CC_clear_describe_cache(self);
 	if (self->num_discardp > 0 && self->discardp)
 	{
 		for (i = 0; i < self->num_discardp; i++)
@@ -1090,12 +1127,18 @@ static int handle_show_results(const QResultClass *res);
 #define	ISOLATION_SHOW_QUERY "show " TRANSACTION_ISOLATION
 
 static int LIBPQ_connect(ConnectionClass *self);
+#ifdef	LIBPQ_HAS_PIPELINING
+static BOOL CC_send_startup_queries(ConnectionClass *self, char *settings_ok);
+#endif /* LIBPQ_HAS_PIPELINING */
 static char
 LIBPQ_CC_connect(ConnectionClass *self, char *salt_para)
 {
 	int		ret;
 	CSTR		func = "LIBPQ_CC_connect";
+#ifndef	LIBPQ_HAS_PIPELINING
 	QResultClass	*res;
+	const char	*datestyle;
+#endif /* LIBPQ_HAS_PIPELINING */
 
 	MYLOG(0, "entering...\n");
 
@@ -1104,28 +1147,18 @@ LIBPQ_CC_connect(ConnectionClass *self, char *salt_para)
 
 	if (ret = LIBPQ_connect(self), ret <= 0)
 		return ret;
+#ifdef	LIBPQ_HAS_PIPELINING
+	/* CC_connect() sends DateStyle and the isolation query in its pipeline */
+	return ret;
+#else
 
-	/* Check current DateStyle first */
-	res = CC_send_query(self, "SHOW DateStyle;", NULL, READ_ONLY_QUERY, NULL);
-	if (QR_command_maybe_successful(res))
-	{
-
-		if (res->command && (stricmp(res->command, "SHOW") == 0) 
-			&& (strcmp(QR_get_fieldname(res, 0), "DateStyle") == 0)){
-			const char * datestyle = QR_get_value_backend_text(res, 0, 0);
-			/* Only set DateStyle if it's not already ISO */
-			if (datestyle && (strncmp(datestyle, "ISO", 3) != 0))
-			{
-				QR_Destructor(res);
-				res = CC_send_query(self, "SET DateStyle = 'ISO';" ISOLATION_SHOW_QUERY, NULL, READ_ONLY_QUERY, NULL);
-			}
-			else
-			{
-				QR_Destructor(res);
-				res = CC_send_query(self, ISOLATION_SHOW_QUERY, NULL, READ_ONLY_QUERY, NULL);
-			}
-		}
-	}
+	/* The server reports the current DateStyle */
+	datestyle = PQparameterStatus(self->pqconn, "DateStyle");
+	/* Only set DateStyle if it's not already ISO */
+	if (NULL == datestyle || strncmp(datestyle, "ISO", 3) != 0)
+		res = CC_send_query(self, "SET DateStyle = 'ISO';" ISOLATION_SHOW_QUERY, NULL, READ_ONLY_QUERY, NULL);
+	else
+		res = CC_send_query(self, ISOLATION_SHOW_QUERY, NULL, READ_ONLY_QUERY, NULL);
 
 	if (QR_command_maybe_successful(res))
 	{
@@ -1137,6 +1170,7 @@ LIBPQ_CC_connect(ConnectionClass *self, char *salt_para)
 	QR_Destructor(res);
 
 	return ret;
+#endif /* LIBPQ_HAS_PIPELINING */
 }
 
 char
@@ -1165,6 +1199,17 @@ CC_connect(ConnectionClass *self, char *salt_para)
 	 * rules.  Therefore, these functions call the corresponding local
 	 * function instead.
 	 */
+#ifdef	LIBPQ_HAS_PIPELINING
+	retsend = TRUE;
+	if (!CC_send_startup_queries(self, &retsend))
+	{
+		ret = 0;
+		goto cleanup;
+	}
+	if (CC_get_errornumber(self) > 0 &&
+	    NULL != (errmsg = CC_get_errormsg(self)))
+		saverr = strdup(errmsg);
+#else
 
 	/* Per Datasource settings */
 	retsend = CC_send_settings(self, GET_NAME(self->connInfo.conn_settings));
@@ -1211,6 +1256,7 @@ CC_connect(ConnectionClass *self, char *salt_para)
 			goto cleanup;
 		}
 	}
+#endif /* LIBPQ_HAS_PIPELINING */
 
 	CC_clear_error(self);
 	if (self->server_isolation != self->isolation)
@@ -1388,6 +1434,16 @@ isolation_str_to_enum(const char *str_isolation)
 	return isolation;
 }
 
+static void CC_set_server_isolation(ConnectionClass *conn, const char *str_isolation)
+{
+	conn->server_isolation = isolation_str_to_enum(str_isolation);
+	MYLOG(0, "isolation " FORMAT_UINTEGER " to be " FORMAT_UINTEGER "\n", conn->server_isolation, conn->isolation);
+	if (0 == conn->isolation)
+		conn->isolation = conn->server_isolation;
+	if (0 == conn->default_isolation)
+		conn->default_isolation = conn->server_isolation;
+}
+
 static int handle_show_results(const QResultClass *res)
 {
 	int			count = 0;
@@ -1401,12 +1457,7 @@ static int handle_show_results(const QResultClass *res)
 			continue;
 		if (strcmp(QR_get_fieldname(qres, 0), TRANSACTION_ISOLATION) == 0)
 		{
-			conn->server_isolation = isolation_str_to_enum(QR_get_value_backend_text(qres, 0, 0));
-			MYLOG(0, "isolation " FORMAT_UINTEGER " to be " FORMAT_UINTEGER "\n", conn->server_isolation, conn->isolation);
-			if (0 == conn->isolation)
-				conn->isolation = conn->server_isolation;
-			if (0 == conn->default_isolation)
-				conn->default_isolation = conn->server_isolation;
+			CC_set_server_isolation(conn, QR_get_value_backend_text(qres, 0, 0));
 			count++;
 		}
 	}
@@ -1674,26 +1725,52 @@ MYLOG(0, "entering\n");
 	CONNLOCK_RELEASE(conn);
 }
 
+/*
+ *	Does the query set search_path or the role, which changes what
+ *	"$user" in search_path means ? Every statement of a multi-statement
+ *	query is checked.
+ */
 static BOOL
-is_setting_search_path(const char *query)
+is_setting_name_lookup(const char *query)
 {
-	const char *q = query;
-	if (strnicmp(q, "set", 3) != 0)
-		return FALSE;
-	q += 3;
-	while (isspace(*q)) q++;
-	for (; *q;)
+	const char	*q;
+	char		quote = '\0';
+	BOOL		stmt_start = TRUE, in_set = FALSE;
+	size_t		len;
+
+	for (q = query; *q; q++)
 	{
-		if (IS_NOT_SPACE(*q))
+		if ('\0' != quote)
 		{
-			if (strnicmp(q, "search_path", 11) == 0)
-				return TRUE;
-			q++;
-			while (IS_NOT_SPACE(*q))
-				q++;
+			if (quote == *q)
+				quote = '\0';
+			continue;
 		}
-		else
-			q++;
+		if (LITERAL_QUOTE == *q || IDENTIFIER_QUOTE == *q)
+		{
+			quote = *q;
+			stmt_start = FALSE;
+			continue;
+		}
+		if (';' == *q)
+		{
+			stmt_start = TRUE;
+			in_set = FALSE;
+			continue;
+		}
+		if (!IS_NOT_SPACE(*q) || NULL != strchr("=,", *q))
+			continue;
+		for (len = 1; IS_NOT_SPACE(q[len]) && NULL == strchr(";=,'\"", q[len]); len++)
+			;
+		if (stmt_start)
+			in_set = (3 == len && strnicmp(q, "set", 3) == 0);
+		else if (in_set &&
+			 ((11 == len && strnicmp(q, "search_path", 11) == 0) ||
+			  (4 == len && strnicmp(q, "role", 4) == 0) ||
+			  (13 == len && strnicmp(q, "authorization", 13) == 0)))
+			return TRUE;
+		stmt_start = FALSE;
+		q += len - 1;
 	}
 	return FALSE;
 }
@@ -1747,6 +1824,12 @@ CC_internal_rollback(ConnectionClass *self, int rollback_type, BOOL ignore_abort
 	char		cmd[128];
 	PGresult   *pgres = NULL;
 
+	/*
+	 * PQexec() would discard the pending results, and the FETCH sent
+	 * ahead may be what aborted the transaction.
+	 */
+	CC_complete_copy_stream(self);
+	CC_complete_read_ahead(self);
 	if (!CC_is_in_error_trans(self))
 		return 1;
 	switch (rollback_type)
@@ -1848,6 +1931,49 @@ CC_abort_copy(ConnectionClass *self)
 		PQclear(pgres);
 }
 
+/*
+ * The connection can't be used for anything else while a COPY TO STDOUT
+ * result is being read. Read the rest of its rows into the tuple cache of
+ * the result, the application fetches them from there. The memory isn't
+ * bounded here; docs/config-opt.html (CopyStream) tells the applications
+ * to avoid this.
+ */
+void
+CC_complete_copy_stream(ConnectionClass *self)
+{
+	QResultClass	*res;
+
+	if (res = self->copy_stream_res, NULL == res)
+		return;
+	MYLOG(0, "reading the rest of the COPY stream of %p\n", res);
+	QR_read_copy_rows(res, -1);
+}
+
+/*
+ * Likewise, the FETCH sent ahead for a declare/fetch result must be
+ * finished before the connection is used for anything else. The result
+ * keeps the PGresult until its tuple cache runs out.
+ */
+void
+CC_complete_read_ahead(ConnectionClass *self)
+{
+	QResultClass	*res;
+	PGresult	*pgres;
+
+	if (res = self->read_ahead_res, NULL == res)
+		return;
+	self->read_ahead_res = NULL;
+	MYLOG(0, "receiving the rows read ahead for %p\n", res);
+	while (self->pqconn && (pgres = PQgetResult(self->pqconn)) != NULL)
+	{
+		if (NULL == res->read_ahead_pgres)
+			res->read_ahead_pgres = pgres;
+		else
+			PQclear(pgres);
+	}
+	LIBPQ_update_transaction_status(self);
+}
+
 /*
  *	The "result_in" is only used by QR_next_tuple() to fetch another group of rows into
  *	the same existing QResultClass (this occurs when the tuple cache is depleted and
@@ -1915,14 +2041,26 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 		termPQExpBuffer(&pbuf);
 		return rhold;
 	}
+	/* PQexec() would discard the results the statement is waiting for */
+	if (NULL != self->async_stmt)
+	{
+		CC_set_error(self, CONN_IN_USE, "The connection is busy with an asynchronous execution", func);
+		return rhold;
+	}
 
 	ENTER_INNER_CONN_CS(self, func_cs_count);
+	CC_complete_copy_stream(self);
+	CC_complete_read_ahead(self);
 /* Indicate that we are sending a query to the backend */
 	if ((NULL == query) || (query[0] == '\0'))
 	{
 		CLEANUP_FUNC_CONN_CS(func_cs_count, self);
 		return rhold;
 	}
+	/* The read-only queries of the driver itself leave the session as is */
+	if (CONN_NOT_CONNECTED != self->status &&
+	    (NULL != stmt || 0 == (flag & READ_ONLY_QUERY)))
+		self->session_changed = TRUE;
 
 	/*
 	 *	In case the round trip time can be ignored, the query
@@ -2037,7 +2175,18 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 		CC_set_error(self, CONNECTION_COMMUNICATION_ERROR, errmsg, func);
 		goto cleanup;
 	}
+#ifdef	LIBPQ_HAS_CHUNK_MODE
+	/* receive the rows in chunks of the cache size */
+	{
+		int	chunk_size = (qi && qi->row_size > 0) ? (int) qi->row_size : self->connInfo.drivers.fetch_max;
+
+		if (chunk_size <= 1 ||
+		    !PQsetChunkedRowsMode(self->pqconn, chunk_size))
+			PQsetSingleRowMode(self->pqconn);
+	}
+#else
 	PQsetSingleRowMode(self->pqconn);
+#endif /* LIBPQ_HAS_CHUNK_MODE */
 
 	cmdres = qi ? qi->result_in : NULL;
 	if (cmdres)
@@ -2090,6 +2239,7 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 				MYLOG(0, " setting cmdbuffer = '%s'\n", cmdbuffer);
 
 				my_trim(cmdbuffer); /* get rid of trailing space */
+				CC_check_statement_caches(self, cmdbuffer, query);
 				if (strnicmp(cmdbuffer, bgncmd, strlen(bgncmd)) == 0)
 				{
 					CC_set_in_trans(self);
@@ -2162,7 +2312,7 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 					if (self->current_schema_valid &&
 						strnicmp(cmdbuffer, "SET", 3) == 0)
 					{
-						if (is_setting_search_path(query))
+						if (is_setting_name_lookup(query))
 							reset_current_schema(self);
 					}
 				}
@@ -2196,6 +2346,9 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 			case PGRES_TUPLES_OK:
 				QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(pgres));
 			case PGRES_SINGLE_TUPLE:
+#ifdef	LIBPQ_HAS_CHUNK_MODE
+			case PGRES_TUPLES_CHUNK:
+#endif /* LIBPQ_HAS_CHUNK_MODE */
 				if (query_completed)
 				{
 					QR_concat(res, QR_Constructor());
@@ -2493,6 +2646,8 @@ CC_send_function(ConnectionClass *self, const char *fn_name, void *result_buf, i
 	/* Finish the pending extended query first */
 #define	return DONT_CALL_RETURN_FROM_HERE???
 	ENTER_INNER_CONN_CS(self, func_cs_count);
+	CC_complete_copy_stream(self);
+	CC_complete_read_ahead(self);
 
 	SPRINTF_FIXED(sqlbuffer, "SELECT pg_catalog.%s%s", fn_name,
 			 func_param_str[nargs]);
@@ -2583,6 +2738,108 @@ cleanup:
 }
 
 
+/*
+ *	Execute the named prepared statement with binary parameters and
+ *	get the result in text format. If query is not NULL, the statement
+ *	is prepared first. This is a light-weight alternative of
+ *	CC_send_query() for the internal read-only queries whose parameters
+ *	would be costly to expand into the query text (e.g. keyset reloads).
+ */
+QResultClass *
+CC_exec_prepared(ConnectionClass *self, const char *plan_name, const char *query, int nParams, const Oid *paramTypes, const char * const *paramValues, const int *paramLengths, const int *paramFormats, UDWORD flag, StatementClass *stmt)
+{
+	CSTR	func = "CC_exec_prepared";
+	QResultClass	*res = NULL;
+	PGresult	*pgres = NULL;
+	int		func_cs_count = 0;
+
+	MYLOG(0, "conn=%p, plan_name=%s, nParams=%d\n", self, plan_name, nParams);
+
+	if (!self->pqconn)
+	{
+		CC_set_error(self, CONNECTION_COULD_NOT_SEND, "The connection is down", func);
+		return NULL;
+	}
+	/* PQexecPrepared() would discard the results the statement is waiting for */
+	if (NULL != self->async_stmt)
+	{
+		CC_set_error(self, CONN_IN_USE, "The connection is busy with an asynchronous execution", func);
+		return NULL;
+	}
+
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	CC_complete_copy_stream(self);
+	CC_complete_read_ahead(self);
+	if (CONN_NOT_CONNECTED != self->status)
+		self->session_changed = TRUE;
+	if (stmt &&
+	    CC_is_in_trans(self) && !CC_is_in_error_trans(self) &&
+	    !CC_started_rbpoint(self))
+	{
+		unsigned int svpopt = 0;
+
+		if (0 != (flag & READ_ONLY_QUERY))
+			svpopt |= SVPOPT_RDONLY;
+		if (SQL_ERROR == SetStatementSvp(SC_get_ancestor(stmt), svpopt))
+		{
+			SC_set_error(stmt, STMT_INTERNAL_ERROR, "internal savepoint error", func);
+			goto cleanup;
+		}
+	}
+	if (0 != (flag & GO_INTO_TRANSACTION) && !CC_begin(self))
+	{
+		CC_set_error(self, CONN_EXEC_ERROR, "Could not begin a transaction", func);
+		goto cleanup;
+	}
+
+	if (NULL == (res = QR_Constructor()))
+	{
+		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Could not create result info in exec_prepared.", func);
+		goto cleanup;
+	}
+	if (NULL != query)
+	{
+		QLOG(0, "PQprepare: %p '%s' plan=%s\n", self->pqconn, query, plan_name);
+		pgres = PQprepare(self->pqconn, plan_name, query, nParams, paramTypes);
+		if (PQresultStatus(pgres) != PGRES_COMMAND_OK)
+		{
+			handle_pgres_error(self, pgres, "exec_prepared", res, TRUE);
+			goto cleanup;
+		}
+		QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+		PQclear(pgres);
+	}
+	QLOG(0, "PQexecPrepared: %p plan=%s nParams=%d\n", self->pqconn, plan_name, nParams);
+	pgres = PQexecPrepared(self->pqconn, plan_name, nParams,
+						   paramValues, paramLengths, paramFormats, 0);
+	if (PQresultStatus(pgres) != PGRES_TUPLES_OK)
+	{
+		handle_pgres_error(self, pgres, "exec_prepared", res, TRUE);
+		goto cleanup;
+	}
+	QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(pgres));
+	if (0 != (flag & CREATE_KEYSET))
+	{
+		QR_set_haskeyset(res);
+		if (stmt)
+		{
+			if (stmt->num_key_fields < 0) /* for safety */
+				CheckPgClassInfo(stmt);
+			res->num_key_fields = stmt->num_key_fields;
+		}
+	}
+	CC_from_PGresult(res, stmt, self, NULL, &pgres);
+
+cleanup:
+#undef	return
+	if (pgres)
+		PQclear(pgres);
+	LIBPQ_update_transaction_status(self);
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+	return res;
+}
+
 char
 CC_send_settings(ConnectionClass *self, const char *set_query)
 {
@@ -2651,6 +2908,19 @@ CC_send_settings(ConnectionClass *self, const char *set_query)
  *	If a real Large Object oid type is made part of Postgres, this function
  *	will go away and the define 'PG_TYPE_LO' will be updated.
  */
+#define	LO_LOOKUP_QUERY	"select oid, typbasetype from pg_type where typname = '"  PG_TYPE_LO_NAME "'"
+
+static void
+CC_set_lo_type(ConnectionClass *self, OID lobj_type, OID basetype)
+{
+	self->lobj_type = lobj_type;
+	if (PG_TYPE_OID == basetype)
+		self->lo_is_domain = 1;
+	else if (0 != basetype)
+		self->lobj_type = 0;
+}
+
+#ifndef	LIBPQ_HAS_PIPELINING
 static SQLRETURN
 CC_lookup_lo(ConnectionClass *self)
 {
@@ -2659,26 +2929,264 @@ CC_lookup_lo(ConnectionClass *self)
 
 	MYLOG(0, "entering...\n");
 
-	res = CC_send_query(self, "select oid, typbasetype from pg_type where typname = '"  PG_TYPE_LO_NAME "'",
-		NULL, READ_ONLY_QUERY, NULL);
+	res = CC_send_query(self, LO_LOOKUP_QUERY, NULL, READ_ONLY_QUERY, NULL);
 
 	if (!QR_command_maybe_successful(res))
 		ret = SQL_ERROR;
-	else if (QR_command_maybe_successful(res) && QR_get_num_cached_tuples(res) > 0)
+	else if (QR_get_num_cached_tuples(res) > 0)
+		CC_set_lo_type(self,
+			QR_get_value_backend_int(res, 0, 0, NULL),
+			QR_get_value_backend_int(res, 0, 1, NULL));
+	QR_Destructor(res);
+	MYLOG(0, "Got the large object oid: %d\n", self->lobj_type);
+	return ret;
+}
+#else
+
+enum {
+	STARTUP_DATESTYLE
+	,STARTUP_ISOLATION
+	,STARTUP_SETTINGS
+	,STARTUP_LO
+	,STARTUP_ENCODING
+};
+
+typedef struct
+{
+	int			kind;
+	const char	*query;
+} StartupQuery;
+
+/*
+ *	Send the startup queries in one pipeline with a sync point after
+ *	each, so a failing ConnSettings statement doesn't abort the others.
+ *	*settings_ok is set to FALSE when one of them fails.
+ */
+static BOOL
+CC_pipeline_startup_queries(ConnectionClass *self, const StartupQuery *queries, int nqueries, char *settings_ok)
+{
+	CSTR		func = "CC_pipeline_startup_queries";
+	PGconn		*pqconn = self->pqconn;
+	PGresult	*pgres;
+	int			nsent, i;
+	BOOL		failed = FALSE;
+
+	if (nqueries <= 0)
+		return TRUE;
+	QLOG(0, "PQenterPipelineMode: %p\n", pqconn);
+	if (!PQenterPipelineMode(pqconn))
+	{
+		CC_set_error(self, CONN_EXEC_ERROR, PQerrorMessage(pqconn), func);
+		return FALSE;
+	}
+	for (nsent = 0; nsent < nqueries; nsent++)
 	{
-		OID	basetype;
+		QLOG(0, "PQsendQueryParams: %p '%s' nParams=0\n", pqconn, queries[nsent].query);
+		if (!PQsendQueryParams(pqconn, queries[nsent].query, 0, NULL, NULL, NULL, NULL, 0) ||
+		    !PQpipelineSync(pqconn))
+		{
+			CC_set_error(self, CONNECTION_COMMUNICATION_ERROR, PQerrorMessage(pqconn), func);
+			failed = TRUE;
+			break;
+		}
+	}
 
-		self->lobj_type = QR_get_value_backend_int(res, 0, 0, NULL);
-		basetype = QR_get_value_backend_int(res, 0, 1, NULL);
-		if (PG_TYPE_OID == basetype)
-			self->lo_is_domain = 1;
-		else if (0 != basetype)
-			self->lobj_type = 0;
+	for (i = 0; i < nsent; i++)
+	{
+		const char	*query = queries[i].query;
+		BOOL		ok;
+
+		if (pgres = PQgetResult(pqconn), NULL == pgres)
+		{
+			CC_set_error(self, CONNECTION_NO_RESPONSE, "Could not receive the response, communication down ??", func);
+			failed = TRUE;
+			break;
+		}
+		switch (PQresultStatus(pgres))
+		{
+			case PGRES_COMMAND_OK:
+				QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+				ok = TRUE;
+				break;
+			case PGRES_TUPLES_OK:
+				QLOG(0, "\tok: - 'T' - %s ntuples=%d\n", PQcmdStatus(pgres), PQntuples(pgres));
+				ok = TRUE;
+				break;
+			case PGRES_EMPTY_QUERY:
+				ok = TRUE;
+				break;
+			default:
+				QLOG(0, "\terror: - (%d) - %s", PQresultStatus(pgres), PQresultErrorMessage(pgres));
+				ok = FALSE;
+				break;
+		}
+		switch (queries[i].kind)
+		{
+			case STARTUP_ISOLATION:
+				if (ok && PQntuples(pgres) > 0)
+					CC_set_server_isolation(self, PQgetvalue(pgres, 0, 0));
+				break;
+			case STARTUP_SETTINGS:
+				MYLOG(0, "status %d from '%s'\n", ok, query);
+				if (!ok)
+				{
+					*settings_ok = FALSE;
+					CC_set_error(self, CONNECTION_SERVER_REPORTED_SEVERITY_ERROR, PQresultErrorMessage(pgres), func);
+				}
+				ok = TRUE;
+				break;
+			case STARTUP_LO:
+				if (ok)
+				{
+					if (PQntuples(pgres) > 0)
+						CC_set_lo_type(self,
+							(OID) strtoul(PQgetvalue(pgres, 0, 0), NULL, 10),
+							(OID) strtoul(PQgetvalue(pgres, 0, 1), NULL, 10));
+					MYLOG(0, "Got the large object oid: %d\n", self->lobj_type);
+				}
+				break;
+		}
+		if (!ok && !failed)
+		{
+			CC_set_error(self, CONN_EXEC_ERROR, PQresultErrorMessage(pgres), func);
+			failed = TRUE;
+		}
+		PQclear(pgres);
+		/* consume the end of the results of this query and the sync */
+		while (pgres = PQgetResult(pqconn), NULL != pgres)
+			PQclear(pgres);
+		if (pgres = PQgetResult(pqconn), NULL != pgres)
+		{
+			if (PGRES_PIPELINE_SYNC != PQresultStatus(pgres))
+				MYLOG(0, "unexpected result status %d instead of PGRES_PIPELINE_SYNC\n", PQresultStatus(pgres));
+			PQclear(pgres);
+		}
 	}
-	QR_Destructor(res);
-	MYLOG(0, "Got the large object oid: %d\n", self->lobj_type);
+
+	QLOG(0, "PQexitPipelineMode: %p\n", pqconn);
+	if (!PQexitPipelineMode(pqconn))
+	{
+		MYLOG(0, "could not exit pipeline mode: %s\n", PQerrorMessage(pqconn));
+		failed = TRUE;
+	}
+	if (failed && CONNECTION_BAD == PQstatus(pqconn))
+		CC_on_abort(self, CONN_DEAD);
+	return !failed;
+}
+
+/*
+ *	Send the queries which follow the authentication in one pipeline so
+ *	that they cost a single round trip, in the order of the sequential
+ *	version: DateStyle, the isolation level, the ConnSettings statements,
+ *	the lo type lookup and client_encoding.
+ *	ConnSettings which may contain ODBC escapes still go through
+ *	CC_send_settings() to have the escapes converted, between two
+ *	pipelines for the queries before and after them.
+ *	*settings_ok is set to FALSE when a ConnSettings statement fails.
+ */
+static BOOL
+CC_send_startup_queries(ConnectionClass *self, char *settings_ok)
+{
+	CSTR		func = "CC_send_startup_queries";
+	ConnInfo	*ci = &(self->connInfo);
+	PGconn		*pqconn = self->pqconn;
+	StartupQuery	*queries = NULL;
+	int			nqueries = 0, nbefore, i;
+	const char	*datestyle, *dbencoding, *encoding, *settings = GET_NAME(ci->conn_settings);
+	char		*cs = NULL, *ptr, encquery[64];
+	BOOL		ret = FALSE, escaped_settings;
+#ifdef	HAVE_STRTOK_R
+	char	*last;
+#endif /* HAVE_STRTOK_R */
+
+	MYLOG(0, "entering...\n");
+
+	/* Both DateStyle and client_encoding are reported by the server */
+	datestyle = PQparameterStatus(pqconn, "DateStyle");
+	CC_determine_locale_encoding(self);
+#ifdef UNICODE_SUPPORT
+	if (CC_is_in_unicode_driver(self))
+		encoding = "UTF8";
+	else	/* for unicode drivers require ANSI behavior */
+#endif /* UNICODE_SUPPORT */
+		encoding = self->locale_encoding;
+	dbencoding = PQparameterStatus(pqconn, "client_encoding");
+	escaped_settings = (NULL != settings && NULL != strchr(settings, '{'));
+
+	/* ConnSettings are split at ';' as CC_send_settings() does */
+	i = 4;
+	if (NULL != settings && !escaped_settings)
+	{
+		if (NULL == (cs = strdup(settings)))
+		{
+			CC_set_error(self, CONN_NO_MEMORY_ERROR, "Couldn't alloc buffer for query.", func);
+			goto cleanup;
+		}
+		for (ptr = cs; *ptr; ptr++)
+		{
+			if (';' == *ptr)
+				i++;
+		}
+		i++;
+	}
+	if (NULL == (queries = (StartupQuery *) malloc(i * sizeof(StartupQuery))))
+	{
+		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Couldn't alloc startup queries.", func);
+		goto cleanup;
+	}
+	if (NULL == datestyle || strncmp(datestyle, "ISO", 3) != 0)
+	{
+		queries[nqueries].kind = STARTUP_DATESTYLE;
+		queries[nqueries++].query = "SET DateStyle = 'ISO'";
+	}
+	queries[nqueries].kind = STARTUP_ISOLATION;
+	queries[nqueries++].query = ISOLATION_SHOW_QUERY;
+	if (NULL != cs)
+	{
+#ifdef	HAVE_STRTOK_R
+		for (ptr = strtok_r(cs, ";", &last); ptr; ptr = strtok_r(NULL, ";", &last))
+#else
+		for (ptr = strtok(cs, ";"); ptr; ptr = strtok(NULL, ";"))
+#endif /* HAVE_STRTOK_R */
+		{
+			queries[nqueries].kind = STARTUP_SETTINGS;
+			queries[nqueries++].query = ptr;
+		}
+	}
+	nbefore = nqueries;
+	queries[nqueries].kind = STARTUP_LO;
+	queries[nqueries++].query = LO_LOOKUP_QUERY;
+	/* ConnSettings may have changed client_encoding */
+	if (encoding &&
+	    (NULL != settings || !dbencoding || stricmp(encoding, dbencoding)))
+	{
+		SPRINTF_FIXED(encquery, "set client_encoding to '%s'", encoding);
+		queries[nqueries].kind = STARTUP_ENCODING;
+		queries[nqueries++].query = encquery;
+	}
+
+	PQsetNoticeReceiver(pqconn, receive_libpq_notice, NULL);
+	if (!escaped_settings)
+		ret = CC_pipeline_startup_queries(self, queries, nqueries, settings_ok);
+	else if (CC_pipeline_startup_queries(self, queries, nbefore, settings_ok))
+	{
+		if (!CC_send_settings(self, settings))
+			*settings_ok = FALSE;
+		if (CONN_DOWN != self->status)
+			ret = CC_pipeline_startup_queries(self, queries + nbefore, nqueries - nbefore, settings_ok);
+	}
+	if (ret)
+		CC_set_client_encoding(self, encoding);
+
+cleanup:
+	if (queries)
+		free(queries);
+	if (cs)
+		free(cs);
+	MYLOG(0, "leaving %d\n", ret);
 	return ret;
 }
+#endif /* LIBPQ_HAS_PIPELINING */
 
 
 /*
@@ -2781,6 +3289,339 @@ int	CC_discard_marked_objects(ConnectionClass *conn)
 	return 1;
 }
 
+/*
+ *	Cache of named prepared statements.
+ *
+ *	Statements which execute the same query with the same parameter types
+ *	share one server-side plan and its describe result. Entries which no
+ *	statement uses are evicted in LRU order when the cache is full.
+ */
+static void
+free_prepared_info(PREPARED_INFO *pinfo)
+{
+	if (pinfo->desc)
+		PQclear(pinfo->desc);
+	if (pinfo->param_types)
+		free(pinfo->param_types);
+	if (pinfo->query)
+		free(pinfo->query);
+	free(pinfo);
+}
+
+static BOOL
+same_query(const PREPARED_INFO *pinfo, const char *query, Int2 num_params, const OID *param_types)
+{
+	if (pinfo->num_params != num_params ||
+	    strcmp(pinfo->query, query) != 0)
+		return FALSE;
+	if (num_params > 0 &&
+	    memcmp(pinfo->param_types, param_types, sizeof(OID) * num_params) != 0)
+		return FALSE;
+	return TRUE;
+}
+
+static void
+CC_clear_prepared_cache(ConnectionClass *self)
+{
+	int	i;
+
+	for (i = 0; i < self->num_prepared; i++)
+		free_prepared_info(self->prepared_cache[i]);
+	self->num_prepared = 0;
+	if (self->prepared_cache)
+	{
+		free(self->prepared_cache);
+		self->prepared_cache = NULL;
+	}
+}
+
+/*
+ *	Discard the shared plans which may be stale. The plans still in use
+ *	are deallocated by their statements because they are no longer in
+ *	the cache when released.
+ */
+static void
+CC_discard_prepared_cache(ConnectionClass *self)
+{
+	int	i;
+	PREPARED_INFO	*pinfo;
+
+	for (i = 0; i < self->num_prepared; i++)
+	{
+		pinfo = self->prepared_cache[i];
+		if (0 == pinfo->refcnt)
+			CC_mark_a_object_to_discard(self, 's', pinfo->plan_name);
+		free_prepared_info(pinfo);
+	}
+	self->num_prepared = 0;
+}
+
+/*
+ *	The names are counted apart from the LRU counter so that they don't
+ *	depend on how often the cache is looked up. plan_name should have
+ *	PLAN_NAME_SIZE bytes.
+ */
+void
+CC_prepared_cache_name(ConnectionClass *conn, char *plan_name, size_t size)
+{
+	snprintf(plan_name, size, "_PLAN_C%p_%u", conn, ++conn->plan_name_count);
+}
+
+PREPARED_INFO *
+CC_lookup_prepared(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types)
+{
+	int	i;
+	PREPARED_INFO	*pinfo;
+
+	for (i = 0; i < conn->num_prepared; i++)
+	{
+		pinfo = conn->prepared_cache[i];
+		if (!same_query(pinfo, query, num_params, param_types))
+			continue;
+		pinfo->refcnt++;
+		pinfo->acc_count = ++conn->prepared_count;
+		MYLOG(0, "hit plan=%s refcnt=%d\n", pinfo->plan_name, pinfo->refcnt);
+		return pinfo;
+	}
+
+	return NULL;
+}
+
+/*
+ *	Register the plan just prepared by a statement. The cache takes the
+ *	ownership of desc when TRUE is returned.
+ */
+BOOL
+CC_add_prepared(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types, const char *plan_name, PGresult *desc)
+{
+	int	i, cache_size = conn->connInfo.prepared_cache_size;
+	PREPARED_INFO	*pinfo;
+
+	if (cache_size <= 0)
+		return FALSE;
+	if (NULL == conn->prepared_cache)
+	{
+		if (NULL == (conn->prepared_cache = (PREPARED_INFO **) malloc(sizeof(PREPARED_INFO *) * cache_size)))
+			return FALSE;
+		conn->num_prepared = 0;
+	}
+	if (conn->num_prepared >= cache_size)
+	{
+		int	lru = -1;
+
+		for (i = 0; i < conn->num_prepared; i++)
+		{
+			pinfo = conn->prepared_cache[i];
+			if (pinfo->refcnt > 0)
+				continue;
+			if (lru < 0 || pinfo->acc_count < conn->prepared_cache[lru]->acc_count)
+				lru = i;
+		}
+		/* all the plans are in use */
+		if (lru < 0)
+			return FALSE;
+		pinfo = conn->prepared_cache[lru];
+		MYLOG(0, "evicting plan=%s\n", pinfo->plan_name);
+		if (CC_mark_a_object_to_discard(conn, 's', pinfo->plan_name) < 0)
+			return FALSE;
+		free_prepared_info(pinfo);
+		conn->prepared_cache[lru] = conn->prepared_cache[--conn->num_prepared];
+	}
+	if (NULL == (pinfo = (PREPARED_INFO *) malloc(sizeof(PREPARED_INFO))))
+		return FALSE;
+	pg_memset(pinfo, 0, sizeof(*pinfo));
+	if (NULL == (pinfo->query = strdup(query)))
+	{
+		free_prepared_info(pinfo);
+		return FALSE;
+	}
+	if (num_params > 0)
+	{
+		if (NULL == (pinfo->param_types = (OID *) malloc(sizeof(OID) * num_params)))
+		{
+			free_prepared_info(pinfo);
+			return FALSE;
+		}
+		memcpy(pinfo->param_types, param_types, sizeof(OID) * num_params);
+	}
+	pinfo->num_params = num_params;
+	STRCPY_FIXED(pinfo->plan_name, plan_name);
+	pinfo->refcnt = 1;
+	pinfo->acc_count = ++conn->prepared_count;
+	pinfo->desc = desc;
+	conn->prepared_cache[conn->num_prepared++] = pinfo;
+	MYLOG(0, "added plan=%s num_prepared=%d\n", plan_name, conn->num_prepared);
+
+	return TRUE;
+}
+
+/*
+ *	The statement no longer uses the plan. Returns FALSE if the plan
+ *	isn't cached i.e. the statement should deallocate it by itself.
+ */
+BOOL
+CC_release_prepared(ConnectionClass *conn, const char *plan_name)
+{
+	int	i;
+
+	if (NULL == plan_name)
+		return FALSE;
+	for (i = 0; i < conn->num_prepared; i++)
+	{
+		if (strcmp(conn->prepared_cache[i]->plan_name, plan_name) == 0)
+		{
+			conn->prepared_cache[i]->refcnt--;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ *	Cache of the describe results of the unnamed statements.
+ *
+ *	Describing a prepared statement before its execution parses the query
+ *	into the unnamed statement only to get the result columns and the
+ *	parameter types. The results are kept here keyed by the processed
+ *	query text and the parameter types, so that describing the same query
+ *	again needs no round trip. The entries are reused in LRU order.
+ */
+void
+CC_clear_describe_cache(ConnectionClass *self)
+{
+	int	i;
+
+	for (i = 0; i < self->num_described; i++)
+		free_prepared_info(self->describe_cache[i]);
+	self->num_described = 0;
+	if (self->describe_cache)
+	{
+		free(self->describe_cache);
+		self->describe_cache = NULL;
+	}
+}
+
+PGresult *
+CC_lookup_described(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types)
+{
+	int	i;
+	PREPARED_INFO	*pinfo;
+
+	for (i = 0; i < conn->num_described; i++)
+	{
+		pinfo = conn->describe_cache[i];
+		if (!same_query(pinfo, query, num_params, param_types))
+			continue;
+		pinfo->acc_count = ++conn->described_count;
+		MYLOG(0, "hit described query=%s\n", query);
+		return pinfo->desc;
+	}
+
+	return NULL;
+}
+
+/*
+ *	Register the result of PQdescribePrepared() for the unnamed statement.
+ *	The cache takes the ownership of desc when TRUE is returned.
+ */
+BOOL
+CC_add_described(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types, PGresult *desc)
+{
+	int	i, cache_size = conn->connInfo.describe_cache_size;
+	PREPARED_INFO	*pinfo;
+
+	if (cache_size <= 0)
+		return FALSE;
+	if (NULL == conn->describe_cache)
+	{
+		if (NULL == (conn->describe_cache = (PREPARED_INFO **) malloc(sizeof(PREPARED_INFO *) * cache_size)))
+			return FALSE;
+		conn->num_described = 0;
+	}
+	if (conn->num_described >= cache_size)
+	{
+		int	lru = 0;
+
+		for (i = 1; i < conn->num_described; i++)
+		{
+			if (conn->describe_cache[i]->acc_count < conn->describe_cache[lru]->acc_count)
+				lru = i;
+		}
+		free_prepared_info(conn->describe_cache[lru]);
+		conn->describe_cache[lru] = conn->describe_cache[--conn->num_described];
+	}
+	if (NULL == (pinfo = (PREPARED_INFO *) malloc(sizeof(PREPARED_INFO))))
+		return FALSE;
+	pg_memset(pinfo, 0, sizeof(*pinfo));
+	if (NULL == (pinfo->query = strdup(query)))
+	{
+		free_prepared_info(pinfo);
+		return FALSE;
+	}
+	if (num_params > 0)
+	{
+		if (NULL == (pinfo->param_types = (OID *) malloc(sizeof(OID) * num_params)))
+		{
+			free_prepared_info(pinfo);
+			return FALSE;
+		}
+		memcpy(pinfo->param_types, param_types, sizeof(OID) * num_params);
+	}
+	pinfo->num_params = num_params;
+	pinfo->acc_count = ++conn->described_count;
+	pinfo->desc = desc;
+	conn->describe_cache[conn->num_described++] = pinfo;
+	MYLOG(0, "added described query=%s num_described=%d\n", query, conn->num_described);
+
+	return TRUE;
+}
+
+/*
+ *	Forget the cached descriptions and the shared plans when the command
+ *	just completed may have changed them i.e. DDL, a change of search_path
+ *	or the role, a rollback of such commands or a COMMIT which undoes SET
+ *	LOCAL. Neither DDL executed inside functions nor the changes made by
+ *	the other sessions are detected.
+ */
+void
+CC_check_statement_caches(ConnectionClass *self, const char *cmdtag, const char *query)
+{
+	BOOL	clear;
+
+	if (NULL == cmdtag)
+		return;
+	if (strnicmp(cmdtag, "SET", 3) == 0)
+	{
+		self->set_since_commit = TRUE;
+		clear = (NULL != query && is_setting_name_lookup(query));
+	}
+	else if (strnicmp(cmdtag, "COMMIT", 6) == 0)
+	{
+		clear = self->set_since_commit;
+		self->set_since_commit = FALSE;
+	}
+	else
+		clear = (strnicmp(cmdtag, "CREATE", 6) == 0 ||
+			 strnicmp(cmdtag, "ALTER", 5) == 0 ||
+			 strnicmp(cmdtag, "DROP", 4) == 0 ||
+			 strnicmp(cmdtag, "ROLLBACK", 8) == 0 ||
+			 strnicmp(cmdtag, "RESET", 5) == 0 ||
+			 strnicmp(cmdtag, "DISCARD", 7) == 0 ||
+			 strnicmp(cmdtag, "DO", 2) == 0);
+	if (!clear)
+		return;
+	if (self->num_described > 0)
+	{
+		MYLOG(0, "clearing the describe cache by %s\n", cmdtag);
+		CC_clear_describe_cache(self);
+	}
+	if (self->num_prepared > 0)
+	{
+		MYLOG(0, "discarding the shared plans by %s\n", cmdtag);
+		CC_discard_prepared_cache(self);
+	}
+}
+
 static void
 LIBPQ_update_transaction_status(ConnectionClass *self)
 {
@@ -2954,6 +3795,136 @@ log_redacted_pqopt(const char *conninfo)
 	}
 }
 
+/*
+ *	The key of the driver-internal connection pool.
+ *	The per datasource settings are part of it because they are
+ *	sent to the server on every connect.
+ */
+static char *
+pool_key_build(const char **opts, const char **vals, const char *conn_settings)
+{
+	size_t		len, pos;
+	int			i;
+	char		*key;
+
+	len = strlen(conn_settings) + 1;
+	for (i = 0; opts[i]; i++)
+		len += strlen(opts[i]) + strlen(SAFE_STR(vals[i])) + 2;
+	if (NULL == (key = malloc(len)))
+		return NULL;
+	for (i = 0, pos = 0; opts[i]; i++)
+		pos += snprintf(key + pos, len - pos, "%s=%s\n", opts[i], SAFE_STR(vals[i]));
+	snprintf(key + pos, len - pos, "%s", conn_settings);
+
+	return key;
+}
+
+/*
+ *	Take a usable server connection with the same key out of the pool.
+ *	PQconsumeInput() notices the connections the server has closed
+ *	meanwhile; PoolHealthCheck adds a round trip with an empty query.
+ */
+static PGconn *
+CC_pool_checkout(ConnectionClass *self)
+{
+	ConnInfo	*ci = &(self->connInfo);
+	PGconn		*pqconn;
+	PGnotify	*notify;
+	PGresult	*pgres;
+	BOOL		alive;
+
+	while (NULL != (pqconn = EN_pool_acquire(CC_get_env(self), self->pool_key, ci->pool_idle_timeout)))
+	{
+		alive = (PQconsumeInput(pqconn) &&
+				 CONNECTION_OK == PQstatus(pqconn) &&
+				 PQTRANS_IDLE == PQtransactionStatus(pqconn));
+		while (NULL != (notify = PQnotifies(pqconn)))
+			PQfreemem(notify);
+		if (alive && ci->pool_health_check)
+		{
+			QLOG(0, "PQexec: %p ''\n", pqconn);
+			pgres = PQexec(pqconn, "");
+			alive = (PGRES_EMPTY_QUERY == PQresultStatus(pgres));
+			PQclear(pgres);
+		}
+		if (alive)
+		{
+			MYLOG(0, "reusing the pooled connection %p\n", pqconn);
+			return pqconn;
+		}
+		QLOG(0, "PQfinish: %p\n", pqconn);
+		PQfinish(pqconn);
+	}
+
+	return NULL;
+}
+
+/*
+ *	Reset the session and park the server connection in the pool instead
+ *	of closing it. The reset command is skipped when nothing but the
+ *	connect-time settings has been sent on the session.
+ *	Returns FALSE when the connection should be closed.
+ */
+static BOOL
+CC_pool_checkin(ConnectionClass *self)
+{
+	ConnInfo	*ci = &(self->connInfo);
+	PGconn		*pqconn = self->pqconn;
+	PGresult	*pgres;
+	const char	*resetcmd;
+	BOOL		ok;
+
+	if (NULL == self->pool_key || CONN_CONNECTED != self->status)
+		return FALSE;
+	/* a COPY TO STDOUT or a FETCH is still in progress */
+	if (NULL != self->copy_stream_res ||
+	    NULL != self->read_ahead_res)
+		return FALSE;
+	if (CONNECTION_OK != PQstatus(pqconn))
+		return FALSE;
+	switch (PQtransactionStatus(pqconn))
+	{
+		case PQTRANS_IDLE:
+			break;
+		case PQTRANS_INTRANS:
+		case PQTRANS_INERROR:
+			/* PQfinish() would also discard the transaction */
+			QLOG(0, "PQexec: %p '%s'\n", pqconn, "ROLLBACK");
+			pgres = PQexec(pqconn, "ROLLBACK");
+			ok = (PGRES_COMMAND_OK == PQresultStatus(pgres));
+			PQclear(pgres);
+			if (!ok)
+				return FALSE;
+			self->session_changed = TRUE;
+			break;
+		default:
+			return FALSE;
+	}
+	if (self->session_changed)
+	{
+		resetcmd = NAME_IS_VALID(ci->pool_reset_command) ? GET_NAME(ci->pool_reset_command) : DEFAULT_POOLRESETCOMMAND;
+		/* Without a reset command only untouched sessions are reused */
+		if ('\0' == resetcmd[0])
+			return FALSE;
+		QLOG(0, "PQexec: %p '%s'\n", pqconn, resetcmd);
+		pgres = PQexec(pqconn, resetcmd);
+		switch (PQresultStatus(pgres))
+		{
+			case PGRES_COMMAND_OK:
+			case PGRES_TUPLES_OK:
+				ok = (PQTRANS_IDLE == PQtransactionStatus(pqconn));
+				break;
+			default:
+				ok = FALSE;
+		}
+		PQclear(pgres);
+		if (!ok)
+			return FALSE;
+	}
+
+	return EN_pool_release(CC_get_env(self), self->pool_key, pqconn, ci->conn_pool_size, ci->pool_idle_timeout);
+}
+
 static int
 LIBPQ_connect(ConnectionClass *self)
 {
@@ -3085,6 +4056,17 @@ LIBPQ_connect(ConnectionClass *self)
 		}
 	}
 	opts[cnt] = vals[cnt] = NULL;
+
+	if (self->pool_key)
+	{
+		free(self->pool_key);
+		self->pool_key = NULL;
+	}
+	if (ci->conn_pool_size > 0 &&
+	    NULL != (self->pool_key = pool_key_build(opts, vals, SAFE_NAME(ci->conn_settings))))
+		pqconn = CC_pool_checkout(self);
+	if (pqconn)
+		goto connected;
 	/* Ok, we're all set to connect */
 
 	if (get_qlog() > 0 || get_mylog() > 0)
@@ -3107,6 +4089,7 @@ LIBPQ_connect(ConnectionClass *self)
 		CC_set_error(self, CONN_OPENDB_ERROR, "PQconnectdb error", func);
 		goto cleanup;
 	}
+connected:
 	self->pqconn = pqconn;
 
 	pqret = PQstatus(pqconn);
@@ -258,6 +258,21 @@ enum {
 }
 #define col_info_initialize(coli) (pg_memset(coli, 0, sizeof(COL_INFO)))
 
+/*	"_PLAN_C" + pointer + "_" + 32-bit counter */
+#define PLAN_NAME_SIZE	48
+
+/*	This is used to share named prepared statements among the statements */
+struct prepared_info
+{
+	Int2		refcnt;		/* number of statements using the plan */
+	Int2		num_params;
+	OID		*param_types;
+	char		*query;
+	char		plan_name[PLAN_NAME_SIZE];
+	PGresult	*desc;		/* the result of PQdescribePrepared() */
+	UInt4		acc_count;
+};
+
  /* Translation DLL entry points */
 #ifdef WIN32
 #define DLLHANDLE HINSTANCE
@@ -297,6 +312,10 @@ struct ConnectionClass_
 	Int2		coli_allocated;
 	Int2		ntables;
 	COL_INFO	**col_info;
+	BOOL		coli_indexed;	/* the indexes below are up to date */
+	Int4		coli_index_size;
+	Int2		*coli_name_index;	/* by schema and table name */
+	Int2		*coli_oid_index;	/* by table oid */
 	long		translation_option;
 	HINSTANCE	translation_handle;
 	DataSourceToDriverProc DataSourceToDriver;
@@ -336,6 +355,19 @@ struct ConnectionClass_
 	Int2		max_identifier_length;
 	Int2		num_discardp;
 	char		**discardp;
+	Int2		num_prepared;
+	PREPARED_INFO	**prepared_cache;
+	UInt4		prepared_count;	/* for LRU */
+	UInt4		plan_name_count;	/* for naming the shared plans */
+	Int2		num_described;
+	PREPARED_INFO	**describe_cache;	/* descriptions of unnamed plans */
+	UInt4		described_count;	/* for LRU */
+	char		set_since_commit;	/* SET LOCAL may be undone by COMMIT */
+	QResultClass	*copy_stream_res;	/* the result reading COPY TO STDOUT */
+	char		*pool_key;	/* the connection string pooled under */
+	char		session_changed;	/* the session needs a reset before pooled */
+	StatementClass	*async_stmt;	/* the statement executing asynchronously */
+	QResultClass	*read_ahead_res;	/* the result whose next FETCH is in flight */
 	int		num_descs;
 	SQLUINTEGER	default_isolation;	/* server's default isolation initially unknown */
 	DescriptorClass	**descs;
@@ -365,6 +397,8 @@ struct ConnectionClass_
 #define CC_is_onlyread(x)			(x->connInfo.onlyread[0] == '1')
 #define CC_fake_mss(x)	(/* 0 != (x)->ms_jet && */ 0 < (x)->connInfo.fake_mss)
 #define CC_accessible_only(x)	(0 < (x)->connInfo.accessible_only)
+#define CC_adaptive_fetch(x)	(0 < (x)->connInfo.fetch_target_bytes)
+#define CC_first_fetch_size(x)	(CC_adaptive_fetch(x) ? (x)->connInfo.fetch_min_rows : (x)->connInfo.drivers.fetch_max)
 #define CC_default_is_c(x)	(CC_is_in_ansi_app(x) || x->ms_jet /* not only */ || TRUE /* but for any other ? */)
 
 #ifdef	_HANDLE_ENLIST_IN_DTC_
@@ -425,7 +459,9 @@ void		handle_pgres_error(ConnectionClass *self, const PGresult *pgres,
 				   const char *comment,
 				   QResultClass *res, BOOL error_not_a_notice);
 void		CC_clear_error(ConnectionClass *self);
+void		CC_clear_col_info(ConnectionClass *self, BOOL destroy);
 int		CC_send_function(ConnectionClass *conn, const char *fn_name, void *result_buf, int *actual_result_len, int result_is_int, LO_ARG *argv, int nargs);
+QResultClass	*CC_exec_prepared(ConnectionClass *self, const char *plan_name, const char *query, int nParams, const Oid *paramTypes, const char * const *paramValues, const int *paramLengths, const int *paramFormats, UDWORD flag, StatementClass *stmt);
 char		CC_send_settings(ConnectionClass *self, const char *set_query);
 void		CC_initialize_pg_version(ConnectionClass *conn);
 void		CC_log_error(const char *func, const char *desc, const ConnectionClass *self);
@@ -436,8 +472,18 @@ void		CC_on_abort_partial(ConnectionClass *conn);
 void		ProcessRollback(ConnectionClass *conn, BOOL undo, BOOL partial);
 const char	*CC_get_current_schema(ConnectionClass *conn);
 int             CC_mark_a_object_to_discard(ConnectionClass *conn, int type, const char *plan);
+PREPARED_INFO	*CC_lookup_prepared(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types);
+BOOL		CC_add_prepared(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types, const char *plan_name, PGresult *desc);
+BOOL		CC_release_prepared(ConnectionClass *conn, const char *plan_name);
+void		CC_prepared_cache_name(ConnectionClass *conn, char *plan_name, size_t size);
+PGresult	*CC_lookup_described(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types);
+BOOL		CC_add_described(ConnectionClass *conn, const char *query, Int2 num_params, const OID *param_types, PGresult *desc);
+void		CC_clear_describe_cache(ConnectionClass *conn);
+void		CC_check_statement_caches(ConnectionClass *conn, const char *cmdtag, const char *query);
 int             CC_discard_marked_objects(ConnectionClass *conn);
 void		CC_abort_copy(ConnectionClass *self);
+void		CC_complete_copy_stream(ConnectionClass *self);
+void		CC_complete_read_ahead(ConnectionClass *self);
 
 int		CC_get_max_idlen(ConnectionClass *self);
 char	CC_get_escape(const ConnectionClass *self);
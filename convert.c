@@ -201,7 +201,6 @@ static const char *mapFunction(const char *func, int param_count, const char * k
 static BOOL convert_money(const char *s, char *sout, size_t soutmax);
 static char parse_datetime(const char *buf, SIMPLE_TIME *st);
 size_t convert_linefeeds(const char *s, char *dst, size_t max, BOOL convlf, BOOL *changed);
-static size_t convert_from_pgbinary(const char *value, char *rgbValue, SQLLEN cbValueMax);
 static int convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType,
 	 PTR rgbValue, SQLLEN cbValueMax, SQLLEN *pcbValue);
 static int conv_from_octal(const char *s);
@@ -230,51 +229,310 @@ static SQLLEN pg_bin2whex(const char *src, SQLWCHAR *dst, SQLLEN length);
 
 
 /*
- *	Macros for unsigned long handling.
+ *	Decimal decoding of the fetched integers.
+ *
+ *	parse_decimal() accepts what strtoul() accepts in base 10 and
+ *	reports the sign and the overflow of the magnitude separately,
+ *	so that the ATOI*() macros below return exactly what strtol(),
+ *	strtoul(), strtoll() and strtoull() would, the saturation on
+ *	overflow included, without going through the library functions
+ *	or the secure_sscanf() fallback for every value.
  */
-#ifdef	WIN32
-#define	ATOI32U(val)	strtoul(val, NULL, 10)
-#elif	defined(HAVE_STRTOUL)
+#ifdef	ODBCINT64
+#define	UINT64_ALL	(~(unsigned ODBCINT64) 0)
+
+static void
+parse_decimal(const char *str, unsigned ODBCINT64 *val, BOOL *negative, BOOL *overflow)
+{
+	const UCHAR	*p = (const UCHAR *) str;
+	unsigned ODBCINT64	v = 0;
+	unsigned int	d;
+	int		i;
+
+	while (isspace(*p))
+		p++;
+	*negative = ('-' == *p);
+	if ('-' == *p || '+' == *p)
+		p++;
+	*overflow = FALSE;
+	/* 19 digits never overflow */
+	for (i = 0; i < 19 && (d = *p - '0') <= 9; i++, p++)
+		v = v * 10 + d;
+	for (; (d = *p - '0') <= 9; p++)
+	{
+		if (v > (UINT64_ALL - d) / 10)
+			*overflow = TRUE;
+		else if (!*overflow)
+			v = v * 10 + d;
+	}
+	*val = v;
+}
+
+/* strtol() like decoding of the values whose maximum is max */
+static ODBCINT64
+signed_decimal(const char *str, unsigned ODBCINT64 max)
+{
+	unsigned ODBCINT64	val;
+	BOOL	negative, overflow;
+
+	parse_decimal(str, &val, &negative, &overflow);
+	if (!negative)
+		return (overflow || val > max) ? (ODBCINT64) max : (ODBCINT64) val;
+	if (overflow || val > max + 1)
+		return -(ODBCINT64) max - 1;
+	return 0 == val ? 0 : -(ODBCINT64) (val - 1) - 1;
+}
+
+/* strtoul() like decoding of the values whose maximum is max */
+static unsigned ODBCINT64
+unsigned_decimal(const char *str, unsigned ODBCINT64 max)
+{
+	unsigned ODBCINT64	val;
+	BOOL	negative, overflow;
+
+	parse_decimal(str, &val, &negative, &overflow);
+	if (overflow || val > max)
+		return max;
+	return negative ? (0 - val) & max : val;
+}
+
+#define	ATOI32(val)	((SQLINTEGER) signed_decimal(val, LONG_MAX))
+#define	ATOI32U(val)	((SQLUINTEGER) unsigned_decimal(val, ULONG_MAX))
+#define	ATOI64(val)	((ODBCINT64) signed_decimal(val, UINT64_ALL >> 1))
+#define	ATOI64U(val)	unsigned_decimal(val, UINT64_ALL)
+#else
+#define	ATOI32(val)	pg_atol(val)
+#ifdef	HAVE_STRTOUL
 #define	ATOI32U(val)	strtoul(val, NULL, 10)
 #else /* HAVE_STRTOUL */
 #define	ATOI32U(val)	strtol(val, NULL, 10)
-#endif /* WIN32 */
+#endif /* HAVE_STRTOUL */
+#endif /* ODBCINT64 */
+
+static void ResolveNumericParam(const SQL_NUMERIC_STRUCT *ns, char *chrform);
+static void parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL *overflow);
 
 /*
- *	Macros for BIGINT handling.
+ *	Fixed-format parsing of the ISO DateStyle output.
+ *
+ *	The connection always runs with DateStyle ISO, so the dates, times
+ *	and timestamps the server sends are parsed by hand here. Anything
+ *	else (e.g. the literals of parameters) makes these return NULL or
+ *	FALSE, and the callers fall back to secure_sscanf().
  */
-#ifdef	ODBCINT64
-#ifdef	WIN32
-#define	ATOI64(val)	_strtoi64(val, NULL, 10)
-#define	ATOI64U(val)	_strtoui64(val, NULL, 10)
-#elif	(SIZEOF_LONG == 8)
-#define	ATOI64(val)	strtol(val, NULL, 10)
-#define	ATOI64U(val)	strtoul(val, NULL, 10)
-#else
-#if	defined(HAVE_STRTOLL)
-#define	ATOI64(val)	strtoll(val, NULL, 10)
-#define	ATOI64U(val)	strtoull(val, NULL, 10)
-#else
-static ODBCINT64 ATOI64(const char *val)
+#define	IS_DIGIT(c)	((unsigned) ((c) - '0') <= 9)
+
+static const char *
+parse_2digits(const char *p, int *val)
 {
-	int status;
-	ODBCINT64 ll;
-	secure_sscanf(val, &status, "%lld", ARG_LLONG(&ll));
-	return ll;
+	if (!IS_DIGIT(p[0]) || !IS_DIGIT(p[1]))
+		return NULL;
+	*val = (p[0] - '0') * 10 + (p[1] - '0');
+	return p + 2;
 }
-static unsigned ODBCINT64 ATOI64U(const char *val)
+
+/* "YYYY-MM-DD" */
+static const char *
+parse_iso_date(const char *p, SIMPLE_TIME *st)
 {
-	int status;
-	unsigned ODBCINT64 ll;
-	secure_sscanf(val, &status, "%llu", ARG_ULLONG(&ll));
-	return ll;
+	int	yh, yl, m, d;
+
+	if (NULL == (p = parse_2digits(p, &yh)) ||
+	    NULL == (p = parse_2digits(p, &yl)) ||
+	    '-' != *p ||
+	    NULL == (p = parse_2digits(p + 1, &m)) ||
+	    '-' != *p ||
+	    NULL == (p = parse_2digits(p + 1, &d)))
+		return NULL;
+	st->y = yh * 100 + yl;
+	st->m = m;
+	st->d = d;
+	return p;
 }
-#endif /* HAVE_STRTOLL */
-#endif /* WIN32 */
-#endif /* ODBCINT64 */
 
-static void ResolveNumericParam(const SQL_NUMERIC_STRUCT *ns, char *chrform);
-static void parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL *overflow);
+/* "HH:MM:SS[.fffffffff][{+|-}HH[:MM[:SS]]]" */
+static const char *
+parse_iso_time(const char *p, SIMPLE_TIME *st, BOOL *bZone, int *zone)
+{
+	int	i, tz;
+
+	if (NULL == (p = parse_2digits(p, &st->hh)) ||
+	    ':' != *p ||
+	    NULL == (p = parse_2digits(p + 1, &st->mm)) ||
+	    ':' != *p ||
+	    NULL == (p = parse_2digits(p + 1, &st->ss)))
+		return NULL;
+	st->fr = 0;
+	if ('.' == *p)
+	{
+		if (!IS_DIGIT(*(++p)))
+			return NULL;
+		/* in nanoseconds, the digits after the 9th are ignored */
+		for (i = 0; IS_DIGIT(*p); p++, i++)
+		{
+			if (i < 9)
+				st->fr = st->fr * 10 + (*p - '0');
+		}
+		for (; i < 9; i++)
+			st->fr *= 10;
+	}
+	if ('+' == *p || '-' == *p)
+	{
+		/* only the hours of the time zone matter */
+		if (!IS_DIGIT(p[1]))
+			return NULL;
+		for (tz = 0, i = 1; IS_DIGIT(p[i]); i++)
+			tz = tz * 10 + (p[i] - '0');
+		*bZone = TRUE;
+		*zone = ('-' == *p ? -tz : tz);
+		for (p += i; ':' == p[0] && IS_DIGIT(p[1]) && IS_DIGIT(p[2]); p += 3)
+			;
+	}
+	return p;
+}
+
+/*
+ *	Parse a date, a time or a timestamp, optionally followed by " BC".
+ *	st, bZone and zone are set only if the whole string is recognized.
+ */
+static BOOL
+parse_iso_datetime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
+{
+	SIMPLE_TIME	wst = *st;
+	BOOL		wbZone = FALSE;
+	int		wzone = 0;
+	const char	*p;
+
+	if (NULL != (p = parse_iso_date(str, &wst)))
+	{
+		if (' ' == p[0] && IS_DIGIT(p[1]))
+		{
+			if (NULL == (p = parse_iso_time(p + 1, &wst, &wbZone, &wzone)))
+				return FALSE;
+			if (0 == strcmp(p, " BC"))
+			{
+				wst.y = -wst.y;
+				p += 3;
+			}
+		}
+		else
+		{
+			/* a date, whose BC is ignored as before */
+			wst.hh = wst.mm = wst.ss = 0;
+			if (0 == strcmp(p, " BC"))
+				p += 3;
+		}
+	}
+	else if (NULL == (p = parse_iso_time(str, &wst, &wbZone, &wzone)))
+		return FALSE;
+	if ('\0' != *p)
+		return FALSE;
+	*st = wst;
+	*bZone = wbZone;
+	*zone = wzone;
+	return TRUE;
+}
+
+/*
+ *	The seconds of the time zone "{+|-}HH[:MM[:SS]]" following the time
+ *	at p, whose fraction is skipped.
+ */
+static int
+zone_seconds(const char *p)
+{
+	int	sign, val, secs = 0, unit = 3600;
+
+	if ('.' == *p)
+	{
+		for (p++; IS_DIGIT(*p); p++)
+			;
+	}
+	if ('+' != *p && '-' != *p)
+		return 0;
+	sign = ('-' == *p ? -1 : 1);
+	for (val = 0, p++; IS_DIGIT(*p); p++)
+		val = val * 10 + (*p - '0');
+	secs = val * unit;
+	for (; ':' == p[0] && NULL != parse_2digits(p + 1, &val) && unit > 1; p += 3)
+	{
+		unit /= 60;
+		secs += val * unit;
+	}
+	return sign * secs;
+}
+
+/*
+ *	The value of a date, time or timestamp sent by the server, as the days
+ *	(date) or the microseconds (time, timestamp) since 1970-01-01, midnight
+ *	for time. The time zones of timestamptz are applied, and the years
+ *	after 9999 (up to 6 digits) are accepted.
+ *	Returns FALSE for infinity, for anything not in the ISO format and for
+ *	the microseconds out of the range of Int8.
+ */
+BOOL
+datetime_to_epoch(OID field_type, const char *str, Int8 *val)
+{
+	SIMPLE_TIME	st;
+	BOOL		bZone = FALSE;
+	int		zone = 0, zsecs = 0, y, era, yoe, doy, ylen, yhigh = 0;
+	const char	*p, *t;
+	Int8		days, secs;
+
+	memset(&st, 0, sizeof(st));
+	if (PG_TYPE_TIME == field_type)
+	{
+		if (NULL == (p = parse_iso_time(str, &st, &bZone, &zone)) ||
+		    bZone || '\0' != *p)
+			return FALSE;
+		*val = ((Int8) ((st.hh * 60 + st.mm) * 60 + st.ss)) * 1000000 + st.fr / 1000;
+		return TRUE;
+	}
+	/* the digits of the year before its last 4 */
+	for (ylen = 0; IS_DIGIT(str[ylen]); ylen++)
+		;
+	if (ylen > 6)
+		return FALSE;
+	for (; ylen > 4; ylen--, str++)
+		yhigh = yhigh * 10 + (*str - '0');
+	if (NULL == (p = parse_iso_date(str, &st)))
+		return FALSE;
+	st.y += yhigh * 10000;
+	if (PG_TYPE_DATE != field_type)
+	{
+		if (' ' != *p)
+			return FALSE;
+		t = p + 1;
+		if (NULL == (p = parse_iso_time(t, &st, &bZone, &zone)))
+			return FALSE;
+		if (bZone)
+			zsecs = zone_seconds(t + 8);
+	}
+	y = st.y;
+	if (0 == strcmp(p, " BC"))
+	{
+		y = 1 - y;
+		p += 3;
+	}
+	if ('\0' != *p)
+		return FALSE;
+
+	/* the days from the civil date */
+	y -= (st.m <= 2);
+	era = (y >= 0 ? y : y - 399) / 400;
+	yoe = y - era * 400;
+	doy = (153 * (st.m + (st.m > 2 ? -3 : 9)) + 2) / 5 + st.d - 1;
+	days = (Int8) era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+	if (PG_TYPE_DATE == field_type)
+	{
+		*val = days;
+		return TRUE;
+	}
+	secs = days * 86400 + (st.hh * 60 + st.mm) * 60 + st.ss - zsecs;
+	if (secs >= INT64_MAX / 1000000 || secs <= INT64_MIN / 1000000)
+		return FALSE;
+	*val = secs * 1000000 + st.fr / 1000;
+	return TRUE;
+}
 
 /*
  *	TIMESTAMP <-----> SIMPLE_TIME
@@ -299,90 +557,96 @@ timestamp2stime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
 	*zone = 0;
 	st->fr = 0;
 	st->infinity = 0;
-	rest[0] = '\0';
-	bc[0] = '\0';
-	if ((scnt = secure_sscanf(str, &status, "%4d-%2d-%2d %2d:%2d:%2d%31s %15s",
-					ARG_INT(&y), ARG_INT(&m), ARG_INT(&d),
-					ARG_INT(&hh), ARG_INT(&mm), ARG_INT(&ss),
-					ARG_STR(&rest, sizeof(rest)), ARG_STR(&bc, sizeof(bc)))) < 6)
-	{
-		if (scnt == 3) /* date */
+	if (0 == strnicmp(str, INFINITY_STRING, 8) ||
+	    0 == strnicmp(str, MINFINITY_STRING, 9))
+		return FALSE;	/* the callers handle them */
+	if (!parse_iso_datetime(str, st, bZone, zone))
+	{
+		rest[0] = '\0';
+		bc[0] = '\0';
+		if ((scnt = secure_sscanf(str, &status, "%4d-%2d-%2d %2d:%2d:%2d%31s %15s",
+						ARG_INT(&y), ARG_INT(&m), ARG_INT(&d),
+						ARG_INT(&hh), ARG_INT(&mm), ARG_INT(&ss),
+						ARG_STR(&rest, sizeof(rest)), ARG_STR(&bc, sizeof(bc)))) < 6)
 		{
-			st->y  = y;
-			st->m  = m;
-			st->d  = d;
-			st->hh = 0;
-			st->mm = 0;
-			st->ss = 0;
-			return TRUE;
+			if (scnt == 3) /* date */
+			{
+				st->y  = y;
+				st->m  = m;
+				st->d  = d;
+				st->hh = 0;
+				st->mm = 0;
+				st->ss = 0;
+				return TRUE;
+			}
+			if ((scnt = secure_sscanf(str, &status, "%2d:%2d:%2d%31s %15s",
+							ARG_INT(&hh), ARG_INT(&mm), ARG_INT(&ss),
+							ARG_STR(&rest, sizeof(rest)), ARG_STR(&bc, sizeof(bc)))) < 3)
+				return FALSE;
+			else
+			{
+				st->hh = hh;
+				st->mm = mm;
+				st->ss = ss;
+				if (scnt == 3) /* time */
+					return TRUE;
+			}
 		}
-		if ((scnt = secure_sscanf(str, &status, "%2d:%2d:%2d%31s %15s",
-						ARG_INT(&hh), ARG_INT(&mm), ARG_INT(&ss),
-						ARG_STR(&rest, sizeof(rest)), ARG_STR(&bc, sizeof(bc)))) < 3)
-			return FALSE;
 		else
 		{
+			st->y  = y;
+			st->m  = m;
+			st->d  = d;
 			st->hh = hh;
 			st->mm = mm;
 			st->ss = ss;
-			if (scnt == 3) /* time */
+			if (scnt == 6)
 				return TRUE;
 		}
-	}
-	else
-	{
-		st->y  = y;
-		st->m  = m;
-		st->d  = d;
-		st->hh = hh;
-		st->mm = mm;
-		st->ss = ss;
-		if (scnt == 6)
-			return TRUE;
-	}
-	switch (rest[0])
-	{
-		case '+':
-			*bZone = TRUE;
-			*zone = pg_atoi(&rest[1]);
-			break;
-		case '-':
-			*bZone = TRUE;
-			*zone = -pg_atoi(&rest[1]);
-			break;
-		case '.':
-			if ((ptr = strchr(rest, '+')) != NULL)
-			{
+		switch (rest[0])
+		{
+			case '+':
 				*bZone = TRUE;
-				*zone = pg_atoi(&ptr[1]);
-				*ptr = '\0';
-			}
-			else if ((ptr = strchr(rest, '-')) != NULL)
-			{
+				*zone = pg_atoi(&rest[1]);
+				break;
+			case '-':
 				*bZone = TRUE;
-				*zone = -pg_atoi(&ptr[1]);
-				*ptr = '\0';
-			}
-			for (i = 1; i < 10; i++)
-			{
-				if (!isdigit((UCHAR) rest[i]))
-					break;
-			}
-			for (; i < 10; i++)
-				rest[i] = '0';
-			rest[i] = '\0';
-			st->fr = pg_atoi(&rest[1]);
-			break;
-		case 'B':
-			if (stricmp(rest, "BC") == 0)
-				st->y *= -1;
-			return TRUE;
-		default:
-			return TRUE;
-	}
-	if (stricmp(bc, "BC") == 0)
-	{
-		st->y *= -1;
+				*zone = -pg_atoi(&rest[1]);
+				break;
+			case '.':
+				if ((ptr = strchr(rest, '+')) != NULL)
+				{
+					*bZone = TRUE;
+					*zone = pg_atoi(&ptr[1]);
+					*ptr = '\0';
+				}
+				else if ((ptr = strchr(rest, '-')) != NULL)
+				{
+					*bZone = TRUE;
+					*zone = -pg_atoi(&ptr[1]);
+					*ptr = '\0';
+				}
+				for (i = 1; i < 10; i++)
+				{
+					if (!isdigit((UCHAR) rest[i]))
+						break;
+				}
+				for (; i < 10; i++)
+					rest[i] = '0';
+				rest[i] = '\0';
+				st->fr = pg_atoi(&rest[1]);
+				break;
+			case 'B':
+				if (stricmp(rest, "BC") == 0)
+					st->y *= -1;
+				return TRUE;
+			default:
+				return TRUE;
+		}
+		if (stricmp(bc, "BC") == 0)
+		{
+			st->y *= -1;
+		}
 	}
 	if (!withZone || !*bZone || st->y < 1970)
 		return TRUE;
@@ -578,6 +842,82 @@ static int getPrecisionPart(int precision, const char * precPart)
 	return pg_atoi(fraction);
 }
 
+/*
+ *	Parse the day-time intervals in the postgres IntervalStyle,
+ *	"[-]HH:MM:SS[.f]" and "[-]D day[s] [-]HH:MM:SS[.f]", by hand.
+ *	Returns FALSE for the other formats, which are left to
+ *	secure_sscanf().
+ */
+static BOOL
+parse_day_time_interval(SQLINTERVAL itype, int precision, const char *str, SQL_INTERVAL_STRUCT *st)
+{
+	const char	*p = str;
+	char		fraction[10];
+	int		days = 0, hours, minutes, seconds, i;
+	BOOL		sign = FALSE, hsign;
+
+	if (SQL_IS_YEAR == itype || SQL_IS_MONTH == itype || SQL_IS_YEAR_TO_MONTH == itype)
+		return FALSE;
+	if ((hsign = ('-' == *p)))
+		p++;
+	for (hours = 0, i = 0; IS_DIGIT(*p) && i < 9; p++, i++)
+		hours = hours * 10 + (*p - '0');
+	if (0 == i)
+		return FALSE;
+	if (' ' == *p)
+	{
+		/* the days and the time must have the same sign */
+		days = hours;
+		sign = hsign;
+		if (0 != strncmp(p, " day", 4))
+			return FALSE;
+		p += 4;
+		if ('s' == *p)
+			p++;
+		if (' ' != *p++)
+			return FALSE;
+		if ((hsign = ('-' == *p)))
+			p++;
+		if (hsign != sign)
+			return FALSE;
+		for (hours = 0, i = 0; IS_DIGIT(*p) && i < 9; p++, i++)
+			hours = hours * 10 + (*p - '0');
+		if (0 == i)
+			return FALSE;
+	}
+	else
+		sign = hsign;
+	if (':' != *p ||
+	    NULL == (p = parse_2digits(p + 1, &minutes)) ||
+	    ':' != *p ||
+	    NULL == (p = parse_2digits(p + 1, &seconds)))
+		return FALSE;
+	fraction[0] = '\0';
+	if ('.' == *p)
+	{
+		for (p++, i = 0; IS_DIGIT(*p); p++)
+		{
+			if (i < (int) sizeof(fraction) - 1)
+				fraction[i++] = *p;
+		}
+		if (0 == i)
+			return FALSE;
+		fraction[i] = '\0';
+	}
+	if ('\0' != *p)
+		return FALSE;
+
+	st->interval_type = itype;
+	st->interval_sign = sign ? SQL_TRUE : SQL_FALSE;
+	st->intval.day_second.day = days;
+	st->intval.day_second.hour = hours;
+	st->intval.day_second.minute = minutes;
+	st->intval.day_second.second = seconds;
+	if (fraction[0])
+		st->intval.day_second.fraction = getPrecisionPart(precision, fraction);
+	return TRUE;
+}
+
 static BOOL
 interval2istruct(SQLSMALLINT ctype, int precision, const char *str, SQL_INTERVAL_STRUCT *st)
 {
@@ -588,6 +928,8 @@ interval2istruct(SQLSMALLINT ctype, int precision, const char *str, SQL_INTERVAL
 	int 		status = 0;
 
 	pg_memset(st, 0, sizeof(SQL_INTERVAL_STRUCT));
+	if (parse_day_time_interval(itype, precision, str, st))
+		return TRUE;
 	if ((scnt = secure_sscanf(str, &status, "%d-%d",
 					ARG_INT(&years), ARG_INT(&mons))) >=2)
 	{
@@ -791,28 +1133,616 @@ static void set_client_decimal_point(char *num)
 			break;
 		}
 	}
-}
-#else
-static void set_server_decimal_point(char *num) {}
-static void set_client_decimal_point(char *num, BOOL) {}
-#endif /* HAVE_LOCALE_H */
-
-/*	This is called by SQLFetch() */
-int
-copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, int col)
-{
-	ARDFields *opts = SC_get_ARDF(stmt);
-	BindInfoClass *bic;
-	SQLULEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+}
+#else
+static void set_server_decimal_point(char *num) {}
+static void set_client_decimal_point(char *num, BOOL) {}
+#endif /* HAVE_LOCALE_H */
+
+/*
+ *	Results in binary format.
+ *
+ *	If the BinaryResults option is on and the types of all the result
+ *	columns of a prepared statement are listed below, the results are
+ *	requested in binary format. Values of fixed-width types fetched into
+ *	bound columns of their natural C type are stored without any parsing,
+ *	the other values are converted to the text representation first and
+ *	go through copy_and_convert_field().
+ */
+int
+binary_result_handling(OID pgtype)
+{
+	switch (pgtype)
+	{
+		case PG_TYPE_BOOL:
+		case PG_TYPE_BYTEA:
+		case PG_TYPE_INT2:
+		case PG_TYPE_INT4:
+		case PG_TYPE_INT8:
+		case PG_TYPE_OID:
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+		case PG_TYPE_NUMERIC:
+		case PG_TYPE_DATE:
+		case PG_TYPE_TIME:
+		case PG_TYPE_TIMESTAMP_NO_TMZONE:
+		case PG_TYPE_UUID:
+			return BINRES_DECODE;
+		case PG_TYPE_NAME:
+		case PG_TYPE_TEXT:
+		case PG_TYPE_UNKNOWN:
+		case PG_TYPE_BPCHAR:
+		case PG_TYPE_VARCHAR:
+			return BINRES_AS_TEXT;
+	}
+	return BINRES_UNSUPPORTED;
+}
+
+/*
+ *	Can the results of the statement be requested in binary format ?
+ */
+static BOOL
+use_binary_results(const StatementClass *stmt)
+{
+	const ConnectionClass	*conn = SC_get_conn(stmt);
+	QResultClass	*res = stmt->parsed;
+	int		i, num_fields;
+
+	if (!conn->connInfo.binary_results)
+		return FALSE;
+	/* the result columns must be known before the execution */
+	if (NULL == res || NULL == QR_get_fields(res) ||
+	    (num_fields = QR_NumResultCols(res)) <= 0)
+		return FALSE;
+	/* keysets and cursors are read in text format */
+	if (0 != stmt->multi_statement ||
+	    SC_is_fetchcursor(stmt) ||
+	    STMT_TYPE_PROCCALL == stmt->statement_type ||
+	    SQL_CONCUR_READ_ONLY != stmt->options.scroll_concurrency)
+		return FALSE;
+	for (i = 0; i < num_fields; i++)
+	{
+		if (BINRES_UNSUPPORTED == binary_result_handling(QR_get_field_type(res, i)))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+#define	POSTGRES_EPOCH_JDATE	2451545		/* date2j(2000, 1, 1) */
+#define	USECS_PER_HOUR		((Int8) 3600000000)
+#define	USECS_PER_DAY		(24 * USECS_PER_HOUR)
+#define	NUMERIC_NEG		0x4000
+#define	NUMERIC_NAN		0xC000
+#define	NUMERIC_PINF		0xD000
+#define	NUMERIC_NINF		0xF000
+
+/* the integers of the binary format, in network byte order */
+UInt2
+binary_get_uint16(const char *p)
+{
+	const UCHAR	*u = (const UCHAR *) p;
+
+	return (UInt2) ((u[0] << 8) | u[1]);
+}
+
+UInt4
+binary_get_uint32(const char *p)
+{
+	const UCHAR	*u = (const UCHAR *) p;
+
+	return ((UInt4) u[0] << 24) | ((UInt4) u[1] << 16) | ((UInt4) u[2] << 8) | u[3];
+}
+
+static Int8
+binary_get_int64(const char *p)
+{
+	return (Int8) (((SQLUBIGINT) binary_get_uint32(p) << 32) | binary_get_uint32(p + 4));
+}
+
+/* the same as j2date() of the backend */
+static void
+binary_j2date(int jd, int *year, int *month, int *day)
+{
+	unsigned int	julian, quad, extra;
+	int		y;
+
+	julian = jd;
+	julian += 32044;
+	quad = julian / 146097;
+	extra = (julian - quad * 146097) * 4 + 3;
+	julian += 60 + quad * 3 + extra / 146097;
+	quad = julian / 1461;
+	julian -= quad * 1461;
+	y = julian * 4 / 1461;
+	julian = ((y != 0) ? ((julian + 305) % 365) : ((julian + 306) % 366))
+		+ 123;
+	y += quad * 4;
+	*year = y - 4800;
+	quad = julian * 2141 / 65536;
+	*day = julian - 7834 * quad / 256;
+	*month = (quad + 10) % 12 + 1;
+}
+
+/*
+ *	Decode a binary date or timestamp into SIMPLE_TIME.
+ *	The year is negative for BC dates, as timestamp2stime() does.
+ *	Returns FALSE for infinite values.
+ */
+static BOOL
+binary_to_stime(OID pgtype, const char *value, SIMPLE_TIME *st)
+{
+	Int8	usecs = 0;
+	int	days;
+
+	pg_memset(st, 0, sizeof(*st));
+	if (PG_TYPE_DATE == pgtype)
+	{
+		days = (Int4) binary_get_uint32(value);
+		if (INT_MAX == days || INT_MIN == days)
+			return FALSE;
+	}
+	else
+	{
+		usecs = binary_get_int64(value);
+		if (INT64_MAX == usecs || INT64_MIN == usecs)
+			return FALSE;
+		days = (int) (usecs / USECS_PER_DAY);
+		usecs -= days * USECS_PER_DAY;
+		if (usecs < 0)
+		{
+			usecs += USECS_PER_DAY;
+			days--;
+		}
+	}
+	binary_j2date(days + POSTGRES_EPOCH_JDATE, &st->y, &st->m, &st->d);
+	if (st->y <= 0)
+		st->y = -(1 - st->y);
+	st->hh = (int) (usecs / USECS_PER_HOUR);
+	usecs -= st->hh * USECS_PER_HOUR;
+	st->mm = (int) (usecs / 60000000);
+	usecs -= st->mm * 60000000;
+	st->ss = (int) (usecs / 1000000);
+	st->fr = (int) (usecs - st->ss * 1000000) * 1000;
+	return TRUE;
+}
+
+/*
+ *	Convert a value in binary format into the text representation
+ *	the server would have sent. Returns buf, a malloc'ed buffer if buf
+ *	is too small (*allocated is set) or NULL if the value is invalid.
+ */
+static char *
+binary_value_to_text(OID pgtype, const char *value, SQLLEN len, char *buf, size_t bufsize, BOOL *allocated)
+{
+	SIMPLE_TIME	st;
+	int		i, prec;
+
+	*allocated = FALSE;
+	switch (pgtype)
+	{
+		case PG_TYPE_BOOL:
+			if (len != 1)
+				return NULL;
+			snprintf(buf, bufsize, "%c", value[0] ? 't' : 'f');
+			return buf;
+		case PG_TYPE_INT2:
+			if (len != 2)
+				return NULL;
+			snprintf(buf, bufsize, "%d", (Int2) binary_get_uint16(value));
+			return buf;
+		case PG_TYPE_INT4:
+			if (len != 4)
+				return NULL;
+			snprintf(buf, bufsize, "%d", (Int4) binary_get_uint32(value));
+			return buf;
+		case PG_TYPE_OID:
+			if (len != 4)
+				return NULL;
+			snprintf(buf, bufsize, "%u", binary_get_uint32(value));
+			return buf;
+		case PG_TYPE_INT8:
+			if (len != 8)
+				return NULL;
+			snprintf(buf, bufsize, FORMATI64, binary_get_int64(value));
+			return buf;
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+			{
+				double	dval;
+				float	fval;
+				UInt4	ival;
+				Int8	lval;
+
+				if (PG_TYPE_FLOAT4 == pgtype)
+				{
+					if (len != 4)
+						return NULL;
+					ival = binary_get_uint32(value);
+					memcpy(&fval, &ival, sizeof(fval));
+					dval = fval;
+				}
+				else
+				{
+					if (len != 8)
+						return NULL;
+					lval = binary_get_int64(value);
+					memcpy(&dval, &lval, sizeof(dval));
+				}
+				if (isnan(dval))
+					snprintf(buf, bufsize, "%s", NAN_STRING);
+				else if (isinf(dval))
+					snprintf(buf, bufsize, "%s", dval < 0 ? MINFINITY_STRING : INFINITY_STRING);
+				else if (PG_TYPE_FLOAT4 == pgtype)
+				{
+					/* the shortest form which reads back the same value */
+					for (prec = PG_REAL_DIGITS - 3; prec < PG_REAL_DIGITS; prec++)
+					{
+						snprintf(buf, bufsize, "%.*g", prec, dval);
+						if ((float) strtod(buf, NULL) == fval)
+							break;
+					}
+					snprintf(buf, bufsize, "%.*g", prec, dval);
+				}
+				else
+				{
+					for (prec = PG_DOUBLE_DIGITS - 2; prec < PG_DOUBLE_DIGITS; prec++)
+					{
+						snprintf(buf, bufsize, "%.*g", prec, dval);
+						if (strtod(buf, NULL) == dval)
+							break;
+					}
+					snprintf(buf, bufsize, "%.*g", prec, dval);
+				}
+			}
+			return buf;
+		case PG_TYPE_NUMERIC:
+			{
+				int	ndigits, weight, sign, dscale, d, written;
+				size_t	needed;
+				char	*ptr;
+
+				if (len < 8)
+					return NULL;
+				ndigits = (Int2) binary_get_uint16(value);
+				weight = (Int2) binary_get_uint16(value + 2);
+				sign = binary_get_uint16(value + 4);
+				dscale = binary_get_uint16(value + 6);
+				if (ndigits < 0 || len != 8 + 2 * ndigits)
+					return NULL;
+				switch (sign)
+				{
+					case NUMERIC_NAN:
+						snprintf(buf, bufsize, "%s", NAN_STRING);
+						return buf;
+					case NUMERIC_PINF:
+						snprintf(buf, bufsize, "%s", INFINITY_STRING);
+						return buf;
+					case NUMERIC_NINF:
+						snprintf(buf, bufsize, "%s", MINFINITY_STRING);
+						return buf;
+				}
+				needed = (weight >= 0 ? (weight + 1) * 4 : 1) + dscale + 4;
+				if (needed > bufsize)
+				{
+					if (NULL == (ptr = malloc(needed)))
+						return NULL;
+					*allocated = TRUE;
+					buf = ptr;
+				}
+				ptr = buf;
+				if (NUMERIC_NEG == sign)
+					*ptr++ = '-';
+				if (weight < 0)
+					*ptr++ = '0';
+				for (d = 0; d <= weight; d++)
+				{
+					int	dig = d < ndigits ? binary_get_uint16(value + 8 + 2 * d) : 0;
+
+					ptr += sprintf(ptr, d > 0 ? "%04d" : "%d", dig);
+				}
+				if (dscale > 0)
+				{
+					*ptr++ = '.';
+					for (d = weight + 1, written = 0; written < dscale; d++)
+					{
+						char	four[8];
+						int	dig = (d >= 0 && d < ndigits) ? binary_get_uint16(value + 8 + 2 * d) : 0;
+
+						sprintf(four, "%04d", dig);
+						for (i = 0; i < 4 && written < dscale; i++, written++)
+							*ptr++ = four[i];
+					}
+				}
+				*ptr = '\0';
+			}
+			return buf;
+		case PG_TYPE_DATE:
+			if (len != 4)
+				return NULL;
+			if (!binary_to_stime(pgtype, value, &st))
+				snprintf(buf, bufsize, "%sinfinity", (Int4) binary_get_uint32(value) < 0 ? "-" : "");
+			else if (st.y < 0)
+				snprintf(buf, bufsize, "%.4d-%.2d-%.2d BC", -st.y, st.m, st.d);
+			else
+				snprintf(buf, bufsize, "%.4d-%.2d-%.2d", st.y, st.m, st.d);
+			return buf;
+		case PG_TYPE_TIME:
+		case PG_TYPE_TIMESTAMP_NO_TMZONE:
+			if (len != 8)
+				return NULL;
+			if (PG_TYPE_TIME == pgtype)
+			{
+				Int8	usecs = binary_get_int64(value);
+
+				pg_memset(&st, 0, sizeof(st));
+				st.hh = (int) (usecs / USECS_PER_HOUR);
+				usecs -= st.hh * USECS_PER_HOUR;
+				st.mm = (int) (usecs / 60000000);
+				usecs -= st.mm * 60000000;
+				st.ss = (int) (usecs / 1000000);
+				st.fr = (int) (usecs - st.ss * 1000000) * 1000;
+				i = snprintf(buf, bufsize, "%.2d:%.2d:%.2d", st.hh, st.mm, st.ss);
+				if (st.fr > 0)
+				{
+					snprintf(buf + i, bufsize - i, ".%06d", st.fr / 1000);
+					for (i = (int) strlen(buf) - 1; '0' == buf[i]; i--)
+						buf[i] = '\0';
+				}
+			}
+			else if (!binary_to_stime(pgtype, value, &st))
+				snprintf(buf, bufsize, "%sinfinity", binary_get_int64(value) < 0 ? "-" : "");
+			else
+				stime2timestamp(&st, buf, bufsize, FALSE, 6);
+			return buf;
+		case PG_TYPE_UUID:
+			if (len != 16)
+				return NULL;
+			{
+				char	*ptr = buf;
+
+				if (bufsize < 37)
+					return NULL;
+				for (i = 0; i < 16; i++)
+				{
+					if (4 == i || 6 == i || 8 == i || 10 == i)
+						*ptr++ = '-';
+					ptr += sprintf(ptr, "%02x", (UCHAR) value[i]);
+				}
+			}
+			return buf;
+		case PG_TYPE_BYTEA:
+			{
+				char	*ptr;
+
+				if ((size_t) (len * 2 + 3) > bufsize)
+				{
+					if (NULL == (ptr = malloc(len * 2 + 3)))
+						return NULL;
+					*allocated = TRUE;
+					buf = ptr;
+				}
+				ptr = buf;
+				*ptr++ = '\\';
+				*ptr++ = 'x';
+				for (i = 0; i < len; i++)
+				{
+					*ptr++ = "0123456789abcdef"[((UCHAR) value[i]) >> 4];
+					*ptr++ = "0123456789abcdef"[((UCHAR) value[i]) & 0x0f];
+				}
+				*ptr = '\0';
+			}
+			return buf;
+	}
+	return NULL;
+}
+
+/*
+ *	copy_and_convert_field() for a value in binary format.
+ */
+int
+copy_and_convert_binary_field(StatementClass *stmt,
+		OID field_type, int atttypmod,
+		void *value, SQLLEN valuelen,
+		SQLSMALLINT fCType, int precision,
+		PTR rgbValue, SQLLEN cbValueMax,
+		SQLLEN *pcbValue, SQLLEN *pIndicator)
+{
+	CSTR func = "copy_and_convert_binary_field";
+	const ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	SQLSETPOSIROW		bind_row = stmt->bind_row;
+	int			bind_size = opts->bind_size;
+	SQLLEN			pcbValueOffset;
+	const char	*val = value;
+	SQLSMALLINT	ctype = fCType;
+	SIMPLE_TIME	st;
+	SQLLEN		len = -1;
+	char		textbuf[128], *text;
+	BOOL		allocated;
+	int			result;
+
+	if (NULL == value)
+		return copy_and_convert_field(stmt, field_type, atttypmod, value,
+			fCType, precision, rgbValue, cbValueMax, pcbValue, pIndicator);
+
+	/*
+	 * Store fixed-width values into bound columns directly. SQLGetData()
+	 * calls take the general route which keeps track of the data left.
+	 */
+	if (SQL_C_DEFAULT == ctype)
+		ctype = pgtype_attr_to_ctype(conn, field_type, atttypmod);
+#define	BIN_TARGET(type) (bind_size > 0 ? (type *) ((char *) rgbValue + bind_size * bind_row) : (type *) rgbValue + bind_row)
+	if (stmt->current_col < 0 &&
+	    NULL == conn->DataSourceToDriver &&
+	    NULL != rgbValue)
+	{
+		switch (field_type)
+		{
+			case PG_TYPE_INT2:
+				if (2 != valuelen)
+					break;
+				switch (ctype)
+				{
+					case SQL_C_SHORT:
+					case SQL_C_SSHORT:
+						len = 2;
+						*BIN_TARGET(SQLSMALLINT) = (Int2) binary_get_uint16(val);
+						break;
+					case SQL_C_LONG:
+					case SQL_C_SLONG:
+						len = 4;
+						*BIN_TARGET(SQLINTEGER) = (Int2) binary_get_uint16(val);
+						break;
+#ifdef ODBCINT64
+					case SQL_C_SBIGINT:
+						len = 8;
+						*BIN_TARGET(SQLBIGINT) = (Int2) binary_get_uint16(val);
+						break;
+#endif /* ODBCINT64 */
+				}
+				break;
+			case PG_TYPE_INT4:
+				if (4 != valuelen)
+					break;
+				switch (ctype)
+				{
+					case SQL_C_LONG:
+					case SQL_C_SLONG:
+						len = 4;
+						*BIN_TARGET(SQLINTEGER) = (Int4) binary_get_uint32(val);
+						break;
+#ifdef ODBCINT64
+					case SQL_C_SBIGINT:
+						len = 8;
+						*BIN_TARGET(SQLBIGINT) = (Int4) binary_get_uint32(val);
+						break;
+#endif /* ODBCINT64 */
+				}
+				break;
+#ifdef ODBCINT64
+			case PG_TYPE_INT8:
+				if (8 != valuelen)
+					break;
+				if (SQL_C_SBIGINT == ctype)
+				{
+					len = 8;
+					*BIN_TARGET(SQLBIGINT) = binary_get_int64(val);
+				}
+				break;
+#endif /* ODBCINT64 */
+			case PG_TYPE_FLOAT4:
+				if (4 != valuelen)
+					break;
+				{
+					UInt4	ival = binary_get_uint32(val);
+					float	fval;
+
+					memcpy(&fval, &ival, sizeof(fval));
+					if (SQL_C_FLOAT == ctype)
+					{
+						len = 4;
+						*BIN_TARGET(SFLOAT) = fval;
+					}
+					else if (SQL_C_DOUBLE == ctype)
+					{
+						len = 8;
+						*BIN_TARGET(SDOUBLE) = fval;
+					}
+				}
+				break;
+			case PG_TYPE_FLOAT8:
+				if (8 != valuelen)
+					break;
+				if (SQL_C_DOUBLE == ctype)
+				{
+					Int8	lval = binary_get_int64(val);
+
+					len = 8;
+					memcpy(BIN_TARGET(SDOUBLE), &lval, sizeof(SDOUBLE));
+				}
+				break;
+			case PG_TYPE_BOOL:
+				if (1 != valuelen)
+					break;
+				if (SQL_C_BIT == ctype)
+				{
+					len = 1;
+					*BIN_TARGET(UCHAR) = val[0] ? (conn->connInfo.true_is_minus1 ? (UCHAR) -1 : 1) : 0;
+				}
+				break;
+			case PG_TYPE_DATE:
+				if (4 != valuelen)
+					break;
+				if ((SQL_C_DATE == ctype || SQL_C_TYPE_DATE == ctype) &&
+				    binary_to_stime(field_type, val, &st) && st.y > 0)
+				{
+					DATE_STRUCT	*ds = BIN_TARGET(DATE_STRUCT);
+
+					len = 6;
+					ds->year = st.y;
+					ds->month = st.m;
+					ds->day = st.d;
+				}
+				break;
+			case PG_TYPE_TIMESTAMP_NO_TMZONE:
+				if (8 != valuelen)
+					break;
+				if ((SQL_C_TIMESTAMP == ctype || SQL_C_TYPE_TIMESTAMP == ctype) &&
+				    binary_to_stime(field_type, val, &st) && st.y > 0)
+				{
+					TIMESTAMP_STRUCT	*ts = BIN_TARGET(TIMESTAMP_STRUCT);
+
+					len = 16;
+					ts->year = st.y;
+					ts->month = st.m;
+					ts->day = st.d;
+					ts->hour = st.hh;
+					ts->minute = st.mm;
+					ts->second = st.ss;
+					ts->fraction = st.fr;
+				}
+				break;
+			case PG_TYPE_UUID:
+				if (16 != valuelen)
+					break;
+				if (SQL_C_GUID == ctype)
+				{
+					SQLGUID	*g = BIN_TARGET(SQLGUID);
+
+					len = sizeof(SQLGUID);
+					g->Data1 = binary_get_uint32(val);
+					g->Data2 = binary_get_uint16(val + 4);
+					g->Data3 = binary_get_uint16(val + 6);
+					memcpy(g->Data4, val + 8, sizeof(g->Data4));
+				}
+				break;
+		}
+	}
+#undef	BIN_TARGET
+	if (len >= 0)
+	{
+		if (bind_size > 0)
+			pcbValueOffset = bind_size * bind_row;
+		else
+			pcbValueOffset = bind_row * sizeof(SQLLEN);
+		if (pIndicator)
+			*LENADDR_SHIFT(pIndicator, pcbValueOffset) = 0;
+		if (pcbValue)
+			*LENADDR_SHIFT(pcbValue, pcbValueOffset) = len;
+		return COPY_OK;
+	}
 
-	if (opts->allocated <= col)
-		extend_column_bindings(opts, col + 1);
-	bic = &(opts->bindings[col]);
-	SC_set_current_col(stmt, -1);
-	return copy_and_convert_field(stmt, field_type, atttypmod, value,
-		bic->returntype, bic->precision,
-		(PTR) (bic->buffer + offset), bic->buflen,
-		LENADDR_SHIFT(bic->used, offset), LENADDR_SHIFT(bic->indicator, offset));
+	/* Otherwise convert the text representation */
+	if (text = binary_value_to_text(field_type, val, valuelen, textbuf, sizeof(textbuf), &allocated), NULL == text)
+	{
+		MYLOG(0, "%s: couldn't convert the binary value of type %u len=" FORMAT_LEN "\n", func, field_type, valuelen);
+		return COPY_UNSUPPORTED_TYPE;
+	}
+	result = copy_and_convert_field(stmt, field_type, atttypmod, text,
+			fCType, precision, rgbValue, cbValueMax, pcbValue, pIndicator);
+	if (allocated)
+		free(text);
+	return result;
 }
 
 /*
@@ -855,6 +1785,9 @@ valid_int_literal(const char *str, SQLLEN len, BOOL *negative)
 
 static double get_double_value(const char *str)
 {
+	/* only the special values don't start with a digit */
+	if (IS_DIGIT(str[0]) || ('-' == str[0] && IS_DIGIT(str[1])))
+		return pg_atof(str);
 	if (stricmp(str, NAN_STRING) == 0)
 #ifdef	NAN
 		return (double) NAN;
@@ -1469,7 +2402,7 @@ MYLOG(0, "null_cvt_date_string=%d\n", conn->connInfo.cvt_null_date_string);
 					std_time.m = 1;
 					std_time.d = 1;
 				}
-				else
+				else if (NULL == parse_iso_date(value, &std_time))
 					secure_sscanf(value, &status, "%4d-%2d-%2d",
 					ARG_INT(&std_time.y), ARG_INT(&std_time.m), ARG_INT(&std_time.d));
 			}		
@@ -1859,9 +2792,9 @@ MYLOG(DETAIL_LOG_LEVEL, "2stime fr=%d\n", std_time.fr);
 			case SQL_C_BIT:
 				len = 1;
 				if (bind_size > 0)
-					*((UCHAR *) rgbValueBindRow) = pg_atoi(neut_str);
+					*((UCHAR *) rgbValueBindRow) = ATOI32(neut_str);
 				else
-					*((UCHAR *) rgbValue + bind_row) = pg_atoi(neut_str);
+					*((UCHAR *) rgbValue + bind_row) = ATOI32(neut_str);
 
 				 MYLOG(99, "SQL_C_BIT: bind_row = " FORMAT_POSIROW " val = %d, cb = " FORMAT_LEN ", rgb=%d\n",
 					bind_row, pg_atoi(neut_str), cbValueMax, *((UCHAR *)rgbValue));
@@ -1871,17 +2804,17 @@ MYLOG(DETAIL_LOG_LEVEL, "2stime fr=%d\n", std_time.fr);
 			case SQL_C_TINYINT:
 				len = 1;
 				if (bind_size > 0)
-					*((SCHAR *) rgbValueBindRow) = pg_atoi(neut_str);
+					*((SCHAR *) rgbValueBindRow) = ATOI32(neut_str);
 				else
-					*((SCHAR *) rgbValue + bind_row) = pg_atoi(neut_str);
+					*((SCHAR *) rgbValue + bind_row) = ATOI32(neut_str);
 				break;
 
 			case SQL_C_UTINYINT:
 				len = 1;
 				if (bind_size > 0)
-					*((UCHAR *) rgbValueBindRow) = pg_atoi(neut_str);
+					*((UCHAR *) rgbValueBindRow) = ATOI32(neut_str);
 				else
-					*((UCHAR *) rgbValue + bind_row) = pg_atoi(neut_str);
+					*((UCHAR *) rgbValue + bind_row) = ATOI32(neut_str);
 				break;
 
 			case SQL_C_FLOAT:
@@ -1922,26 +2855,26 @@ MYLOG(DETAIL_LOG_LEVEL, "2stime fr=%d\n", std_time.fr);
 			case SQL_C_SHORT:
 				len = 2;
 				if (bind_size > 0)
-					*((SQLSMALLINT *) rgbValueBindRow) = pg_atoi(neut_str);
+					*((SQLSMALLINT *) rgbValueBindRow) = ATOI32(neut_str);
 				else
-					*((SQLSMALLINT *) rgbValue + bind_row) = pg_atoi(neut_str);
+					*((SQLSMALLINT *) rgbValue + bind_row) = ATOI32(neut_str);
 				break;
 
 			case SQL_C_USHORT:
 				len = 2;
 				if (bind_size > 0)
-					*((SQLUSMALLINT *) rgbValueBindRow) = pg_atoi(neut_str);
+					*((SQLUSMALLINT *) rgbValueBindRow) = ATOI32(neut_str);
 				else
-					*((SQLUSMALLINT *) rgbValue + bind_row) = pg_atoi(neut_str);
+					*((SQLUSMALLINT *) rgbValue + bind_row) = ATOI32(neut_str);
 				break;
 
 			case SQL_C_SLONG:
 			case SQL_C_LONG:
 				len = 4;
 				if (bind_size > 0)
-					*((SQLINTEGER *) rgbValueBindRow) = pg_atol(neut_str);
+					*((SQLINTEGER *) rgbValueBindRow) = ATOI32(neut_str);
 				else
-					*((SQLINTEGER *) rgbValue + bind_row) = pg_atol(neut_str);
+					*((SQLINTEGER *) rgbValue + bind_row) = ATOI32(neut_str);
 				break;
 
 			case SQL_C_ULONG:
@@ -1952,109 +2885,537 @@ MYLOG(DETAIL_LOG_LEVEL, "2stime fr=%d\n", std_time.fr);
 					*((SQLUINTEGER *) rgbValue + bind_row) = ATOI32U(neut_str);
 				break;
 
-#ifdef ODBCINT64
-			case SQL_C_SBIGINT:
-				len = 8;
-				if (bind_size > 0)
-					*((SQLBIGINT *) rgbValueBindRow) = ATOI64(neut_str);
-				else
-					*((SQLBIGINT *) rgbValue + bind_row) = ATOI64(neut_str);
-				break;
+#ifdef ODBCINT64
+			case SQL_C_SBIGINT:
+				len = 8;
+				if (bind_size > 0)
+					*((SQLBIGINT *) rgbValueBindRow) = ATOI64(neut_str);
+				else
+					*((SQLBIGINT *) rgbValue + bind_row) = ATOI64(neut_str);
+				break;
+
+			case SQL_C_UBIGINT:
+				len = 8;
+				if (bind_size > 0)
+					*((SQLUBIGINT *) rgbValueBindRow) = ATOI64U(neut_str);
+				else
+					*((SQLUBIGINT *) rgbValue + bind_row) = ATOI64U(neut_str);
+				break;
+
+#endif /* ODBCINT64 */
+			case SQL_C_BINARY:
+				/* The following is for SQL_C_VARBOOKMARK */
+				if (PG_TYPE_INT4 == field_type)
+				{
+					UInt4	ival = ATOI32U(neut_str);
+
+MYLOG(DETAIL_LOG_LEVEL, "SQL_C_VARBOOKMARK value=%d\n", ival);
+					if (pcbValue)
+						*pcbValueBindRow = sizeof(ival);
+					if (cbValueMax >= sizeof(ival))
+					{
+						memcpy(rgbValueBindRow, &ival, sizeof(ival));
+						return COPY_OK;
+					}
+					else
+						return COPY_RESULT_TRUNCATED;
+				}
+				else if (PG_TYPE_UUID == field_type)
+				{
+					int rtn = char2guid(neut_str, &g);
+
+					if (COPY_OK != rtn)
+						return rtn;
+					if (pcbValue)
+						*pcbValueBindRow = sizeof(g);
+					if (cbValueMax >= sizeof(g))
+					{
+						memcpy(rgbValueBindRow, &g, sizeof(g));
+						return COPY_OK;
+					}
+					else
+						return COPY_RESULT_TRUNCATED;
+				}
+				else
+				{
+					MYLOG(0, "couldn't convert the type %d to SQL_C_BINARY\n", field_type);
+					return COPY_UNSUPPORTED_TYPE;
+				}
+				break;
+			case SQL_C_GUID:
+
+				result = char2guid(neut_str, &g);
+				if (COPY_OK != result)
+				{
+					MYLOG(0, "Could not convert to SQL_C_GUID\n");
+					return	COPY_UNSUPPORTED_TYPE;
+				}
+				len = sizeof(g);
+				if (bind_size > 0)
+					*((SQLGUID *) rgbValueBindRow) = g;
+				else
+					*((SQLGUID *) rgbValue + bind_row) = g;
+				break;
+			case SQL_C_INTERVAL_YEAR:
+			case SQL_C_INTERVAL_MONTH:
+			case SQL_C_INTERVAL_YEAR_TO_MONTH:
+			case SQL_C_INTERVAL_DAY:
+			case SQL_C_INTERVAL_HOUR:
+			case SQL_C_INTERVAL_DAY_TO_HOUR:
+			case SQL_C_INTERVAL_MINUTE:
+			case SQL_C_INTERVAL_HOUR_TO_MINUTE:
+			case SQL_C_INTERVAL_SECOND:
+			case SQL_C_INTERVAL_DAY_TO_SECOND:
+			case SQL_C_INTERVAL_HOUR_TO_SECOND:
+			case SQL_C_INTERVAL_MINUTE_TO_SECOND:
+				interval2istruct(fCType, precision, neut_str, bind_size > 0 ? (SQL_INTERVAL_STRUCT *) rgbValueBindRow : (SQL_INTERVAL_STRUCT *) rgbValue + bind_row);
+				break;
+
+			default:
+				MYLOG(0, "conversion to the type %d isn't supported\n", fCType);
+				return COPY_UNSUPPORTED_TYPE;
+		}
+	}
+
+	/* store the length of what was copied, if there's a place for it */
+	if (pcbValue)
+		*pcbValueBindRow = len;
+
+	if (result == COPY_OK && stmt->current_col >= 0)
+		gdata->gdata[stmt->current_col].data_left = 0;
+	return result;
+
+}
+
+/*
+ *	Store the integer value of the text neut_str into target as fCType,
+ *	one of the integer C types.
+ */
+static void
+store_integer(SQLSMALLINT fCType, const char *neut_str, char *target)
+{
+	switch (fCType)
+	{
+		case SQL_C_STINYINT:
+		case SQL_C_TINYINT:
+			*((SCHAR *) target) = ATOI32(neut_str);
+			break;
+		case SQL_C_UTINYINT:
+			*((UCHAR *) target) = ATOI32(neut_str);
+			break;
+		case SQL_C_SSHORT:
+		case SQL_C_SHORT:
+			*((SQLSMALLINT *) target) = ATOI32(neut_str);
+			break;
+		case SQL_C_USHORT:
+			*((SQLUSMALLINT *) target) = ATOI32(neut_str);
+			break;
+		case SQL_C_SLONG:
+		case SQL_C_LONG:
+			*((SQLINTEGER *) target) = ATOI32(neut_str);
+			break;
+		case SQL_C_ULONG:
+			*((SQLUINTEGER *) target) = ATOI32U(neut_str);
+			break;
+#ifdef	ODBCINT64
+		case SQL_C_SBIGINT:
+			*((SQLBIGINT *) target) = ATOI64(neut_str);
+			break;
+		case SQL_C_UBIGINT:
+			*((SQLUBIGINT *) target) = ATOI64U(neut_str);
+			break;
+#endif /* ODBCINT64 */
+	}
+}
+
+/*
+ *	Column-at-a-time version of the integer conversions of
+ *	copy_and_convert_field().
+ *
+ *	Decodes the text values of an int2, int4, int8 or oid column of
+ *	nrows tuples (num_fields apart in the tuple cache) into the bound
+ *	arrays from the row bind_row on. bind_size is that of the ARD,
+ *	0 meaning the column-wise binding. The callers are responsible for
+ *	the values not being binary.
+ *	Returns the number of the rows converted. The conversion stops at
+ *	a NULL without pIndicator and nothing is converted unless fCType
+ *	is an integer type; the callers should let copy_and_convert_field()
+ *	handle the rest.
+ */
+SQLLEN
+convert_integer_column(SQLSMALLINT fCType, const TupleField *tuple,
+		SQLLEN num_fields, SQLLEN nrows,
+		PTR rgbValue, SQLLEN bind_size, SQLLEN bind_row,
+		SQLLEN *pcbValue, SQLLEN *pIndicator)
+{
+	SQLLEN	i, len, cstride, lstride;
+	char	*rgbValueBindRow;
+	SQLLEN	*pcbValueBindRow = NULL, *pIndicatorBindRow = NULL;
+	const char	*neut_str;
+
+	switch (fCType)
+	{
+		case SQL_C_STINYINT:
+		case SQL_C_TINYINT:
+		case SQL_C_UTINYINT:
+			len = 1;
+			break;
+		case SQL_C_SSHORT:
+		case SQL_C_SHORT:
+		case SQL_C_USHORT:
+			len = 2;
+			break;
+		case SQL_C_SLONG:
+		case SQL_C_LONG:
+		case SQL_C_ULONG:
+			len = 4;
+			break;
+#ifdef	ODBCINT64
+		case SQL_C_SBIGINT:
+		case SQL_C_UBIGINT:
+			len = 8;
+			break;
+#endif /* ODBCINT64 */
+		default:
+			return 0;
+	}
+	if (bind_size > 0)
+	{
+		cstride = lstride = bind_size;
+	}
+	else
+	{
+		cstride = len;
+		lstride = sizeof(SQLLEN);
+	}
+	rgbValueBindRow = (char *) rgbValue + cstride * bind_row;
+	if (pcbValue)
+		pcbValueBindRow = LENADDR_SHIFT(pcbValue, lstride * bind_row);
+	if (pIndicator)
+		pIndicatorBindRow = LENADDR_SHIFT(pIndicator, lstride * bind_row);
+
+	for (i = 0; i < nrows; i++, tuple += num_fields)
+	{
+		if (!(neut_str = tuple->value))
+		{
+			if (!pIndicatorBindRow)
+				break;
+			*pIndicatorBindRow = SQL_NULL_DATA;
+		}
+		else
+		{
+			store_integer(fCType, neut_str, rgbValueBindRow);
+			if (pIndicatorBindRow)
+				*pIndicatorBindRow = 0;
+			if (pcbValueBindRow)
+				*pcbValueBindRow = len;
+		}
+		rgbValueBindRow += cstride;
+		if (pcbValueBindRow)
+			pcbValueBindRow = LENADDR_SHIFT(pcbValueBindRow, lstride);
+		if (pIndicatorBindRow)
+			pIndicatorBindRow = LENADDR_SHIFT(pIndicatorBindRow, lstride);
+	}
+
+	return i;
+}
+
+
+/*
+ *	Conversion plans.
+ *
+ *	Instead of going through the type dispatch of copy_and_convert_field()
+ *	for every column of every row, SQLFetch resolves once per bound column
+ *	how its values are to be converted. The text values of the numeric
+ *	types fetched into the fixed-width numeric C types are stored directly,
+ *	the others (NULLs included) go through copy_and_convert_field().
+ *
+ *	SQL_C_CHAR and SQL_C_WCHAR aren't planned yet: the line feed conversion,
+ *	the client encoding, the truncation and the SQLGetData state are all
+ *	handled by convert_text_field_to_sql_c(). Nor is anything planned while
+ *	a translation DLL is loaded, as the DataSourceToDriver call lives in
+ *	copy_and_convert_field().
+ */
+static int
+cp_generic(StatementClass *stmt, const ColumnPlan *plan, void *value, SQLLEN valuelen, SQLULEN offset)
+{
+	const BindInfoClass *bic = &plan->binding;
+
+	SC_set_current_col(stmt, -1);
+	if (plan->binary)
+		return copy_and_convert_binary_field(stmt, plan->field_type, plan->atttypmod,
+			value, valuelen,
+			bic->returntype, bic->precision,
+			(PTR) (bic->buffer + offset), bic->buflen,
+			LENADDR_SHIFT(bic->used, offset), LENADDR_SHIFT(bic->indicator, offset));
+	return copy_and_convert_field(stmt, plan->field_type, plan->atttypmod, value,
+		bic->returntype, bic->precision,
+		(PTR) (bic->buffer + offset), bic->buflen,
+		LENADDR_SHIFT(bic->used, offset), LENADDR_SHIFT(bic->indicator, offset));
+}
+
+/* the value of the current row is stored, set the indicator and the length */
+static int
+cp_stored(const StatementClass *stmt, const ColumnPlan *plan, SQLULEN offset)
+{
+	SQLLEN	lenoffset = offset + plan->len_stride * stmt->bind_row;
+
+	if (plan->binding.indicator)
+		*LENADDR_SHIFT(plan->binding.indicator, lenoffset) = 0;
+	if (plan->binding.used)
+		*LENADDR_SHIFT(plan->binding.used, lenoffset) = plan->len;
+	return COPY_OK;
+}
+
+static int
+cp_integer(StatementClass *stmt, const ColumnPlan *plan, void *value, SQLLEN valuelen, SQLULEN offset)
+{
+	if (!value)
+		return cp_generic(stmt, plan, value, valuelen, offset);
+	SC_set_current_col(stmt, -1);
+	store_integer(plan->ctype, value, plan->binding.buffer + offset + plan->stride * stmt->bind_row);
+	return cp_stored(stmt, plan, offset);
+}
+
+static int
+cp_double(StatementClass *stmt, const ColumnPlan *plan, void *value, SQLLEN valuelen, SQLULEN offset)
+{
+	char	*target;
+
+	if (!value)
+		return cp_generic(stmt, plan, value, valuelen, offset);
+	SC_set_current_col(stmt, -1);
+	target = plan->binding.buffer + offset + plan->stride * stmt->bind_row;
+	set_client_decimal_point((char *) value);
+	if (SQL_C_FLOAT == plan->ctype)
+		*((SFLOAT *) target) = (float) get_double_value(value);
+	else
+		*((SDOUBLE *) target) = get_double_value(value);
+	return cp_stored(stmt, plan, offset);
+}
+
+static void
+build_column_plan(const StatementClass *stmt, ColumnPlan *plan, const BindInfoClass *bic, OID field_type, int atttypmod, BOOL binary)
+{
+	const ConnectionClass *conn = SC_get_conn(stmt);
+	SQLSMALLINT	ctype = bic->returntype;
+
+	plan->binding = *bic;
+	plan->bind_size = SC_get_ARDF(stmt)->bind_size;
+	plan->field_type = field_type;
+	plan->atttypmod = atttypmod;
+	plan->binary = binary;
+	plan->translated = (NULL != conn->DataSourceToDriver);
+	plan->convert = cp_generic;
+	plan->ctype = ctype;
+	plan->len = plan->stride = plan->len_stride = 0;
+
+	if (binary || plan->translated || field_type == conn->lobj_type)
+		return;
+	switch (field_type)
+	{
+		case PG_TYPE_INT2:
+		case PG_TYPE_INT4:
+		case PG_TYPE_INT8:
+		case PG_TYPE_OID:
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+		case PG_TYPE_NUMERIC:
+			break;
+		default:
+			return;
+	}
+	if (SQL_C_DEFAULT == ctype)
+		ctype = pgtype_attr_to_ctype(conn, field_type, atttypmod);
+	switch (ctype)
+	{
+		case SQL_C_STINYINT:
+		case SQL_C_TINYINT:
+		case SQL_C_UTINYINT:
+			plan->convert = cp_integer;
+			plan->len = 1;
+			break;
+		case SQL_C_SSHORT:
+		case SQL_C_SHORT:
+		case SQL_C_USHORT:
+			plan->convert = cp_integer;
+			plan->len = 2;
+			break;
+		case SQL_C_SLONG:
+		case SQL_C_LONG:
+		case SQL_C_ULONG:
+			plan->convert = cp_integer;
+			plan->len = 4;
+			break;
+#ifdef	ODBCINT64
+		case SQL_C_SBIGINT:
+		case SQL_C_UBIGINT:
+			plan->convert = cp_integer;
+			plan->len = 8;
+			break;
+#endif /* ODBCINT64 */
+		case SQL_C_FLOAT:
+			plan->convert = cp_double;
+			plan->len = 4;
+			break;
+		case SQL_C_DOUBLE:
+			plan->convert = cp_double;
+			plan->len = 8;
+			break;
+		default:
+			return;
+	}
+	plan->ctype = ctype;
+	if (plan->bind_size > 0)
+		plan->stride = plan->len_stride = plan->bind_size;
+	else
+	{
+		plan->stride = plan->len;
+		plan->len_stride = sizeof(SQLLEN);
+	}
+}
+
+/*
+ *	Get the conversion plan of the bound column col, building it unless
+ *	it was built for the current binding and field.
+ */
+static ColumnPlan *
+get_column_plan(StatementClass *stmt, int col, OID field_type, int atttypmod, BOOL binary)
+{
+	const ARDFields *opts = SC_get_ARDF(stmt);
+	const BindInfoClass *bic = &opts->bindings[col];
+	ColumnPlan	*plan;
+
+	if (stmt->num_col_plans <= col)
+	{
+		Int2	num_plans = opts->allocated > col ? opts->allocated : col + 1;
+
+		if (!(plan = (ColumnPlan *) realloc(stmt->col_plans, sizeof(ColumnPlan) * num_plans)))
+			return NULL;
+		memset(plan + stmt->num_col_plans, 0, sizeof(ColumnPlan) * (num_plans - stmt->num_col_plans));
+		stmt->col_plans = plan;
+		stmt->num_col_plans = num_plans;
+	}
+	plan = stmt->col_plans + col;
+	if (NULL == plan->convert ||
+	    plan->field_type != field_type ||
+	    plan->atttypmod != atttypmod ||
+	    plan->binary != binary ||
+	    plan->translated != (NULL != SC_get_conn(stmt)->DataSourceToDriver) ||
+	    plan->bind_size != opts->bind_size ||
+	    plan->binding.buffer != bic->buffer ||
+	    plan->binding.buflen != bic->buflen ||
+	    plan->binding.used != bic->used ||
+	    plan->binding.indicator != bic->indicator ||
+	    plan->binding.returntype != bic->returntype ||
+	    plan->binding.precision != bic->precision ||
+	    plan->binding.scale != bic->scale)
+	{
+		MYLOG(DETAIL_LOG_LEVEL, "building the plan of col %d type=%u ctype=%d\n", col, field_type, bic->returntype);
+		build_column_plan(stmt, plan, bic, field_type, atttypmod, binary);
+	}
+	return plan;
+}
 
-			case SQL_C_UBIGINT:
-				len = 8;
-				if (bind_size > 0)
-					*((SQLUBIGINT *) rgbValueBindRow) = ATOI64U(neut_str);
-				else
-					*((SQLUBIGINT *) rgbValue + bind_row) = ATOI64U(neut_str);
-				break;
+/*	This is called by SQLFetch() */
+int
+copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, SQLLEN valuelen, BOOL binary, int col)
+{
+	ARDFields *opts = SC_get_ARDF(stmt);
+	const ColumnPlan	*plan;
+	SQLULEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
 
-#endif /* ODBCINT64 */
-			case SQL_C_BINARY:
-				/* The following is for SQL_C_VARBOOKMARK */
-				if (PG_TYPE_INT4 == field_type)
-				{
-					UInt4	ival = ATOI32U(neut_str);
+	if (opts->allocated <= col)
+		extend_column_bindings(opts, col + 1);
+	if (!(plan = get_column_plan(stmt, col, field_type, atttypmod, binary)))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate the conversion plans", __FUNCTION__);
+		return COPY_GENERAL_ERROR;
+	}
+	return plan->convert(stmt, plan, value, valuelen, offset);
+}
 
-MYLOG(DETAIL_LOG_LEVEL, "SQL_C_VARBOOKMARK value=%d\n", ival);
-					if (pcbValue)
-						*pcbValueBindRow = sizeof(ival);
-					if (cbValueMax >= sizeof(ival))
-					{
-						memcpy(rgbValueBindRow, &ival, sizeof(ival));
-						return COPY_OK;
-					}
-					else
-						return COPY_RESULT_TRUNCATED;
-				}
-				else if (PG_TYPE_UUID == field_type)
-				{
-					int rtn = char2guid(neut_str, &g);
+/*
+ *	Column-at-a-time version of copy_and_convert_field_bindinfo() for the
+ *	column-wise binding of rowsets.
+ *
+ *	Converts the column col of nrows tuples (num_fields apart in the tuple
+ *	cache) into the bound arrays from the row 0 on. The integer and floating
+ *	conversions run in tight loops over the tuples, the rest go through the
+ *	plan row by row. Returns COPY_OK, COPY_RESULT_TRUNCATED if some values
+ *	were truncated, or COPY_GENERAL_ERROR if any conversion failed; the
+ *	callers should then fetch the rowset row by row to get the diagnostics
+ *	of each row.
+ */
+int
+copy_and_convert_column(StatementClass *stmt, OID field_type, int atttypmod, BOOL binary, int col, const TupleField *tuple, SQLLEN num_fields, SQLLEN nrows)
+{
+	ARDFields *opts = SC_get_ARDF(stmt);
+	const ColumnPlan	*plan;
+	const BindInfoClass	*bic;
+	SQLULEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	SQLLEN	i = 0, *pcbValue, *pIndicator;
+	int	retval = COPY_OK;
 
-					if (COPY_OK != rtn)
-						return rtn;
-					if (pcbValue)
-						*pcbValueBindRow = sizeof(g);
-					if (cbValueMax >= sizeof(g))
-					{
-						memcpy(rgbValueBindRow, &g, sizeof(g));
-						return COPY_OK;
-					}
-					else
-						return COPY_RESULT_TRUNCATED;
-				}
-				else
-				{
-					MYLOG(0, "couldn't convert the type %d to SQL_C_BINARY\n", field_type);
-					return COPY_UNSUPPORTED_TYPE;
-				}
-				break;
-			case SQL_C_GUID:
+	if (opts->allocated <= col)
+		extend_column_bindings(opts, col + 1);
+	if (!(plan = get_column_plan(stmt, col, field_type, atttypmod, binary)))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate the conversion plans", __FUNCTION__);
+		return COPY_GENERAL_ERROR;
+	}
+	bic = &plan->binding;
+	pcbValue = LENADDR_SHIFT(bic->used, offset);
+	pIndicator = LENADDR_SHIFT(bic->indicator, offset);
+	if (cp_integer == plan->convert)
+		i = convert_integer_column(plan->ctype, tuple, num_fields, nrows,
+				bic->buffer + offset, plan->bind_size, 0,
+				pcbValue, pIndicator);
+	else if (cp_double == plan->convert)
+	{
+		char	*target = bic->buffer + offset;
+		const char	*neut_str;
 
-				result = char2guid(neut_str, &g);
-				if (COPY_OK != result)
-				{
-					MYLOG(0, "Could not convert to SQL_C_GUID\n");
-					return	COPY_UNSUPPORTED_TYPE;
-				}
-				len = sizeof(g);
-				if (bind_size > 0)
-					*((SQLGUID *) rgbValueBindRow) = g;
-				else
-					*((SQLGUID *) rgbValue + bind_row) = g;
+		for (; i < nrows; i++, target += plan->stride)
+		{
+			if (!(neut_str = tuple[num_fields * i].value))
+			{
+				if (!pIndicator)
+					break;
+				*LENADDR_SHIFT(pIndicator, plan->len_stride * i) = SQL_NULL_DATA;
+				continue;
+			}
+			set_client_decimal_point((char *) neut_str);
+			if (SQL_C_FLOAT == plan->ctype)
+				*((SFLOAT *) target) = (float) get_double_value(neut_str);
+			else
+				*((SDOUBLE *) target) = get_double_value(neut_str);
+			if (pIndicator)
+				*LENADDR_SHIFT(pIndicator, plan->len_stride * i) = 0;
+			if (pcbValue)
+				*LENADDR_SHIFT(pcbValue, plan->len_stride * i) = plan->len;
+		}
+	}
+	for (; i < nrows; i++)
+	{
+		stmt->bind_row = (SQLSETPOSIROW) i;
+		switch (plan->convert(stmt, plan, tuple[num_fields * i].value, tuple[num_fields * i].len, offset))
+		{
+			case COPY_OK:
 				break;
-			case SQL_C_INTERVAL_YEAR:
-			case SQL_C_INTERVAL_MONTH:
-			case SQL_C_INTERVAL_YEAR_TO_MONTH:
-			case SQL_C_INTERVAL_DAY:
-			case SQL_C_INTERVAL_HOUR:
-			case SQL_C_INTERVAL_DAY_TO_HOUR:
-			case SQL_C_INTERVAL_MINUTE:
-			case SQL_C_INTERVAL_HOUR_TO_MINUTE:
-			case SQL_C_INTERVAL_SECOND:
-			case SQL_C_INTERVAL_DAY_TO_SECOND:
-			case SQL_C_INTERVAL_HOUR_TO_SECOND:
-			case SQL_C_INTERVAL_MINUTE_TO_SECOND:
-				interval2istruct(fCType, precision, neut_str, bind_size > 0 ? (SQL_INTERVAL_STRUCT *) rgbValueBindRow : (SQL_INTERVAL_STRUCT *) rgbValue + bind_row);
+			case COPY_RESULT_TRUNCATED:
+				retval = COPY_RESULT_TRUNCATED;
 				break;
-
 			default:
-				MYLOG(0, "conversion to the type %d isn't supported\n", fCType);
-				return COPY_UNSUPPORTED_TYPE;
+				stmt->bind_row = 0;
+				return COPY_GENERAL_ERROR;
 		}
 	}
+	stmt->bind_row = 0;
 
-	/* store the length of what was copied, if there's a place for it */
-	if (pcbValue)
-		*pcbValueBindRow = len;
-
-	if (result == COPY_OK && stmt->current_col >= 0)
-		gdata->gdata[stmt->current_col].data_left = 0;
-	return result;
-
+	return retval;
 }
 
-
 /*--------------------------------------------------------------------
  *	Functions/Macros to get rid of query size limit.
  *
@@ -3123,6 +4484,11 @@ MYLOG(DETAIL_LOG_LEVEL, "type=" FORMAT_UINTEGER " concur=" FORMAT_UINTEGER "\n",
 			if (SQL_CURSOR_FORWARD_ONLY != stmt->options.cursor_type)
 				opt_scroll = " scroll";
 		}
+		else if (ci->copy_stream &&
+			 SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type &&
+			 SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency &&
+			 PG_VERSION_GE(conn, 9.0))
+			SC_set_copystream(stmt);
 		if (SC_is_fetchcursor(stmt))
 		{
 			snprintfcat(new_statement, qb->str_alsize,
@@ -3132,6 +4498,15 @@ MYLOG(DETAIL_LOG_LEVEL, "type=" FORMAT_UINTEGER " concur=" FORMAT_UINTEGER "\n",
 			qp->flags |= FLGP_USING_CURSOR;
 			qp->declare_pos = qb->npos;
 		}
+		else if (SC_is_copystream(stmt))
+		{
+			/*
+			 * Nothing is prepended, SC_execute() wraps the query in
+			 * COPY (...) TO STDOUT. The same restrictions as cursors
+			 * apply though.
+			 */
+			qp->flags |= FLGP_USING_CURSOR;
+		}
 		if (SQL_CONCUR_READ_ONLY != stmt->options.scroll_concurrency)
 		{
 			qb->flags |= FLGB_CREATE_KEYSET;
@@ -3156,7 +4531,10 @@ MYLOG(DETAIL_LOG_LEVEL, "type=" FORMAT_UINTEGER " concur=" FORMAT_UINTEGER "\n",
 	new_statement = qb->query_statement;
 	stmt->statement_type = qp->statement_type;
 	if (0 == (qp->flags & FLGP_USING_CURSOR))
+	{
 		SC_no_fetchcursor(stmt);
+		SC_no_copystream(stmt);
+	}
 #ifdef NOT_USED	/* this seems problematic */
 	else if (0 == (qp->flags & (FLGP_SELECT_FOR_UPDATE_OR_SHARE | FLGP_SELECT_FOR_READONLY)) &&
 		 0 == stmt->multi_statement &&
@@ -4217,8 +5595,8 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 		*nParams = pno;
 	}
 
-	/* result format is text */
-	*resultFormat = 0;
+	/* result format is text unless all the columns can be decoded */
+	*resultFormat = use_binary_results(stmt) ? 1 : 0;
 
 	ret = TRUE;
 
@@ -6244,7 +7622,7 @@ conv_from_octal(const char *s)
 
 
 /*	convert octal escapes to bytes */
-static size_t
+size_t
 convert_from_pgbinary(const char *value, char *rgbValue, SQLLEN cbValueMax)
 {
 	size_t		i,
@@ -6392,14 +7770,279 @@ convert_to_pgbinary(const char *in, char *out, size_t len, QueryBuild *qb)
 
 static const char *hextbl = "0123456789ABCDEF";
 
-#define	def_bin2hex(type) \
+/*
+ *	SIMD kernels of the hex format of bytea.
+ *
+ *	SSE2 is always there on x86-64, AVX2 is used when the CPU (and the
+ *	OS) supports it. The kernels handle the leading (or, when encoding
+ *	backwards, the trailing) whole blocks and the byte-at-a-time loops
+ *	below the rest.
+ */
+#if	defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define	HEX_SIMD
+#include <immintrin.h>
+#ifdef	_MSC_VER
+#include <intrin.h>
+#define	AVX2_FUNC
+#else
+#define	AVX2_FUNC	__attribute__((target("avx2")))
+#endif /* _MSC_VER */
+
+/* the number of bytes encoded by the SIMD kernels */
+#define	HEX_BLOCKS(length)	((length) & ~(SQLLEN) 15)
+
+static BOOL
+hex_use_avx2(void)
+{
+	static volatile int	avx2 = -1;
+
+	if (avx2 < 0)
+	{
+#ifdef	_MSC_VER
+		int	regs[4];
+		int	found = 0;
+
+		__cpuid(regs, 0);
+		if (regs[0] >= 7)
+		{
+			__cpuid(regs, 1);
+			/* OSXSAVE and AVX, and the OS saves the YMM registers */
+			if (0 != (regs[2] & (1 << 27)) &&
+			    0 != (regs[2] & (1 << 28)) &&
+			    6 == (_xgetbv(0) & 6))
+			{
+				__cpuidex(regs, 7, 0);
+				found = (0 != (regs[1] & (1 << 5)));
+			}
+		}
+		avx2 = found;
+#else
+		__builtin_cpu_init();
+		avx2 = (0 != __builtin_cpu_supports("avx2"));
+#endif /* _MSC_VER */
+	}
+	return 0 != avx2;
+}
+
+/* nibbles to the characters of hextbl */
+static __m128i
+hex_ascii_sse2(__m128i n)
+{
+	__m128i	letter = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8('A' - '0' - 10));
+
+	return _mm_add_epi8(n, _mm_add_epi8(letter, _mm_set1_epi8('0')));
+}
+
+/* 16 bytes to 32 hex characters */
+static void
+hex_encode_sse2(const UCHAR *src, __m128i *lo, __m128i *hi)
+{
+	__m128i	x = _mm_loadu_si128((const __m128i *) src);
+	__m128i	mask = _mm_set1_epi8(0x0f);
+	__m128i	h = hex_ascii_sse2(_mm_and_si128(_mm_srli_epi16(x, 4), mask));
+	__m128i	l = hex_ascii_sse2(_mm_and_si128(x, mask));
+
+	*lo = _mm_unpacklo_epi8(h, l);
+	*hi = _mm_unpackhi_epi8(h, l);
+}
+
+static AVX2_FUNC __m256i
+hex_ascii_avx2(__m256i n)
+{
+	__m256i	letter = _mm256_and_si256(_mm256_cmpgt_epi8(n, _mm256_set1_epi8(9)), _mm256_set1_epi8('A' - '0' - 10));
+
+	return _mm256_add_epi8(n, _mm256_add_epi8(letter, _mm256_set1_epi8('0')));
+}
+
+/* 32 bytes to 64 hex characters */
+static AVX2_FUNC void
+hex_encode32_avx2(const UCHAR *src, char *dst)
+{
+	__m256i	x = _mm256_loadu_si256((const __m256i *) src);
+	__m256i	mask = _mm256_set1_epi8(0x0f);
+	__m256i	h = hex_ascii_avx2(_mm256_and_si256(_mm256_srli_epi16(x, 4), mask));
+	__m256i	l = hex_ascii_avx2(_mm256_and_si256(x, mask));
+	__m256i	lo = _mm256_unpacklo_epi8(h, l);
+	__m256i	hi = _mm256_unpackhi_epi8(h, l);
+
+	_mm256_storeu_si256((__m256i *) dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+	_mm256_storeu_si256((__m256i *) (dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+/*
+ *	Encode the first length (a multiple of 16) bytes of src. Backwards,
+ *	the blocks are encoded from the last one so that dst may overlap
+ *	the rest of src.
+ */
+static void
+hex_encode_blocks(const char *src, char *dst, SQLLEN length, BOOL backwards)
+{
+	const UCHAR	*s = (const UCHAR *) src;
+	SQLLEN	i;
+	BOOL	avx2 = hex_use_avx2();
+	__m128i	lo, hi;
+
+	if (backwards)
+	{
+		for (i = length; i > 0;)
+		{
+			if (avx2 && i >= 32)
+			{
+				i -= 32;
+				hex_encode32_avx2(s + i, dst + 2 * i);
+				continue;
+			}
+			i -= 16;
+			hex_encode_sse2(s + i, &lo, &hi);
+			_mm_storeu_si128((__m128i *) (dst + 2 * i), lo);
+			_mm_storeu_si128((__m128i *) (dst + 2 * i + 16), hi);
+		}
+		return;
+	}
+	i = 0;
+	if (avx2)
+	{
+		for (; i + 32 <= length; i += 32)
+			hex_encode32_avx2(s + i, dst + 2 * i);
+	}
+	for (; i < length; i += 16)
+	{
+		hex_encode_sse2(s + i, &lo, &hi);
+		_mm_storeu_si128((__m128i *) (dst + 2 * i), lo);
+		_mm_storeu_si128((__m128i *) (dst + 2 * i + 16), hi);
+	}
+}
+
+#ifdef	UNICODE_SUPPORT
+/* the SQLWCHAR version of the above (SSE2 only) */
+static void
+hex_wencode_blocks(const char *src, SQLWCHAR *dst, SQLLEN length, BOOL backwards)
+{
+	const UCHAR	*s = (const UCHAR *) src;
+	SQLLEN	i, j;
+	__m128i	zero = _mm_setzero_si128();
+	__m128i	lo, hi;
+
+	for (j = 0; j < length; j += 16)
+	{
+		i = backwards ? length - 16 - j : j;
+		hex_encode_sse2(s + i, &lo, &hi);
+		_mm_storeu_si128((__m128i *) (dst + 2 * i), _mm_unpacklo_epi8(lo, zero));
+		_mm_storeu_si128((__m128i *) (dst + 2 * i + 8), _mm_unpackhi_epi8(lo, zero));
+		_mm_storeu_si128((__m128i *) (dst + 2 * i + 16), _mm_unpacklo_epi8(hi, zero));
+		_mm_storeu_si128((__m128i *) (dst + 2 * i + 24), _mm_unpackhi_epi8(hi, zero));
+	}
+}
+#define	HEX_WBLOCKS(length)	(2 == sizeof(SQLWCHAR) ? HEX_BLOCKS(length) : 0)
+#endif /* UNICODE_SUPPORT */
+
+/*
+ *	16 hex characters to nibbles. *valid gets the mask of the
+ *	characters which are hex digits.
+ */
+static __m128i
+hex_nibbles_sse2(__m128i c, int *valid)
+{
+	__m128i	lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+	__m128i	digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+								  _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+	__m128i	letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+								   _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+	__m128i	offset = _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8('0')),
+								  _mm_andnot_si128(digit, _mm_set1_epi8('a' - 10)));
+
+	*valid = _mm_movemask_epi8(_mm_or_si128(digit, letter));
+	return _mm_sub_epi8(lower, offset);
+}
+
+/* nibble pairs (high first) to bytes in the 16-bit lanes */
+static __m128i
+hex_pairs_sse2(__m128i n)
+{
+	return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x0f)), 4),
+						_mm_srli_epi16(n, 8));
+}
+
+static AVX2_FUNC SQLLEN
+hex_decode_avx2(const UCHAR *src, UCHAR *dst, SQLLEN length)
+{
+	SQLLEN	i;
+
+	for (i = 0; i + 64 <= length; i += 64)
+	{
+		__m256i	c1 = _mm256_loadu_si256((const __m256i *) (src + i));
+		__m256i	c2 = _mm256_loadu_si256((const __m256i *) (src + i + 32));
+		__m256i	n1, n2, lower, digit, letter, offset;
+		int		valid;
+
+#define	HEX_NIBBLES_AVX2(c, n) \
+	lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20)); \
+	digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), \
+							 _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c)); \
+	letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), \
+							  _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower)); \
+	offset = _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8('0')), \
+							 _mm256_andnot_si256(digit, _mm256_set1_epi8('a' - 10))); \
+	valid &= _mm256_movemask_epi8(_mm256_or_si256(digit, letter)); \
+	n = _mm256_sub_epi8(lower, offset); \
+	n = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(n, _mm256_set1_epi16(0x0f)), 4), \
+						_mm256_srli_epi16(n, 8))
+
+		valid = -1;
+		HEX_NIBBLES_AVX2(c1, n1);
+		HEX_NIBBLES_AVX2(c2, n2);
+#undef	HEX_NIBBLES_AVX2
+		if (-1 != valid)
+			break;
+		_mm256_storeu_si256((__m256i *) (dst + i / 2),
+							_mm256_permute4x64_epi64(_mm256_packus_epi16(n1, n2), 0xd8));
+	}
+	return i;
+}
+
+/*
+ *	Decode the leading whole blocks of hex digits. Returns the number
+ *	of the characters decoded, which stops short of the first block
+ *	containing anything else than hex digits.
+ */
+static SQLLEN
+hex_decode_blocks(const char *src, char *dst, SQLLEN length)
+{
+	const UCHAR	*s = (const UCHAR *) src;
+	UCHAR	*d = (UCHAR *) dst;
+	SQLLEN	i = 0;
+	int		valid1, valid2;
+	__m128i	n1, n2;
+
+	if (hex_use_avx2())
+		i = hex_decode_avx2(s, d, length);
+	for (; i + 32 <= length; i += 32)
+	{
+		n1 = hex_nibbles_sse2(_mm_loadu_si128((const __m128i *) (s + i)), &valid1);
+		n2 = hex_nibbles_sse2(_mm_loadu_si128((const __m128i *) (s + i + 16)), &valid2);
+		if (0xffff != (valid1 & valid2))
+			break;
+		_mm_storeu_si128((__m128i *) (d + i / 2),
+						 _mm_packus_epi16(hex_pairs_sse2(n1), hex_pairs_sse2(n2)));
+	}
+	return i;
+}
+#else
+#define	HEX_BLOCKS(length)	0
+#define	HEX_WBLOCKS(length)	0
+#define	hex_encode_blocks(src, dst, length, backwards)	((void) 0)
+#define	hex_wencode_blocks(src, dst, length, backwards)	((void) 0)
+#define	hex_decode_blocks(src, dst, length)	0
+#endif /* HEX_SIMD */
+
+#define	def_bin2hex(type, blocks, encode_blocks) \
 	(const char *src, type *dst, SQLLEN length) \
 { \
 	const char	*src_wk; \
 	UCHAR		chr; \
 	type		*dst_wk; \
 	BOOL		backwards; \
-	int		i; \
+	SQLLEN		i, nblocks = 0; \
  \
 	backwards = FALSE; \
 	if ((char *) dst < src) \
@@ -6411,16 +8054,24 @@ static const char *hextbl = "0123456789ABCDEF";
 		backwards = TRUE; \
 	if (backwards) \
 	{ \
-		for (i = 0, src_wk = src + length - 1, dst_wk = dst + 2 * length - 1; i < length; i++, src_wk--) \
+		nblocks = blocks(length); \
+		for (i = length, src_wk = src + length - 1, dst_wk = dst + 2 * length - 1; i > nblocks; i--, src_wk--) \
 		{ \
 			chr = *src_wk; \
 			*dst_wk-- = hextbl[chr % 16]; \
 			*dst_wk-- = hextbl[chr >> 4]; \
 		} \
+		if (nblocks > 0) \
+			encode_blocks(src, dst, nblocks, TRUE); \
 	} \
 	else \
 	{ \
-		for (i = 0, src_wk = src, dst_wk = dst; i < length; i++, src_wk++) \
+		/* the blocks are written before the bytes behind are read */ \
+		if ((char *) dst >= src + length || (char *) (dst + 2 * length) <= src) \
+			nblocks = blocks(length); \
+		if (nblocks > 0) \
+			encode_blocks(src, dst, nblocks, FALSE); \
+		for (i = nblocks, src_wk = src + nblocks, dst_wk = dst + 2 * nblocks; i < length; i++, src_wk++) \
 		{ \
 			chr = *src_wk; \
 			*dst_wk++ = hextbl[chr >> 4]; \
@@ -6432,11 +8083,11 @@ static const char *hextbl = "0123456789ABCDEF";
 }
 #ifdef	UNICODE_SUPPORT
 static SQLLEN
-pg_bin2whex def_bin2hex(SQLWCHAR)
+pg_bin2whex def_bin2hex(SQLWCHAR, HEX_WBLOCKS, hex_wencode_blocks)
 #endif /* UNICODE_SUPPORT */
 
 static SQLLEN
-pg_bin2hex def_bin2hex(char)
+pg_bin2hex def_bin2hex(char, HEX_BLOCKS, hex_encode_blocks)
 
 SQLLEN
 pg_hex2bin(const char *src, char *dst, SQLLEN length)
@@ -6448,7 +8099,8 @@ pg_hex2bin(const char *src, char *dst, SQLLEN length)
 	int		val;
 	BOOL		HByte = TRUE;
 
-	for (i = 0, src_wk = src, dst_wk = dst; i < length; i++, src_wk++)
+	i = hex_decode_blocks(src, dst, length);
+	for (src_wk = src + i, dst_wk = dst + i / 2; i < length; i++, src_wk++)
 	{
 		chr = *src_wk;
 		if (!chr)
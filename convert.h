@@ -10,6 +10,7 @@
 #define __CONVERT_H__
 
 #include "psqlodbc.h"
+#include "bind.h"
 
 #ifdef	__cplusplus
 extern "C" {
@@ -23,15 +24,61 @@ extern "C" {
 #define COPY_NO_DATA_FOUND						5
 #define COPY_INVALID_STRING_CONVERSION				6
 
-int	copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, int col);
+/*
+ *	Conversion plan of a bound column.
+ *
+ *	Resolved from the binding and the field of the result the first time
+ *	the column is fetched, and rebuilt once either of them changes.
+ */
+typedef int (*COLUMN_CONVERTER)(StatementClass *stmt, const ColumnPlan *plan, void *value, SQLLEN valuelen, SQLULEN offset);
+struct ColumnPlan_
+{
+	/* what the plan was built for */
+	BindInfoClass	binding;
+	SQLUINTEGER	bind_size;
+	OID		field_type;
+	int		atttypmod;
+	BOOL		binary;
+	BOOL		translated;	/* DataSourceToDriver was set */
+	/* how to convert */
+	COLUMN_CONVERTER	convert;
+	SQLSMALLINT	ctype;		/* SQL_C_DEFAULT resolved */
+	SQLLEN		len;		/* length of the converted value */
+	SQLLEN		stride;		/* distance between the rows' values */
+	SQLLEN		len_stride;	/* and the rows' lengths */
+};
+
+int	copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, SQLLEN valuelen, BOOL binary, int col);
+int	copy_and_convert_column(StatementClass *stmt, OID field_type, int atttypmod,
+			BOOL binary, int col, const TupleField *tuple,
+			SQLLEN num_fields, SQLLEN nrows);
 int	copy_and_convert_field(StatementClass *stmt,
 			OID field_type, int atttypmod,
 			void *value,
 			SQLSMALLINT fCType, int precision,
 			PTR rgbValue, SQLLEN cbValueMax, SQLLEN *pcbValue, SQLLEN *pIndicator);
+int	copy_and_convert_binary_field(StatementClass *stmt,
+			OID field_type, int atttypmod,
+			void *value, SQLLEN valuelen,
+			SQLSMALLINT fCType, int precision,
+			PTR rgbValue, SQLLEN cbValueMax, SQLLEN *pcbValue, SQLLEN *pIndicator);
+SQLLEN	convert_integer_column(SQLSMALLINT fCType, const TupleField *tuple,
+			SQLLEN num_fields, SQLLEN nrows,
+			PTR rgbValue, SQLLEN bind_size, SQLLEN bind_row,
+			SQLLEN *pcbValue, SQLLEN *pIndicator);
+
+/* binary_result_handling results */
+#define BINRES_UNSUPPORTED					0
+#define BINRES_AS_TEXT						1	/* same as the text format */
+#define BINRES_DECODE						2
+int	binary_result_handling(OID pgtype);
+UInt2	binary_get_uint16(const char *p);
+UInt4	binary_get_uint32(const char *p);
 
 int		copy_statement_with_parameters(StatementClass *stmt, BOOL);
 SQLLEN		pg_hex2bin(const char *in, char *out, SQLLEN len);
+size_t		convert_from_pgbinary(const char *value, char *rgbValue, SQLLEN cbValueMax);
+BOOL		datetime_to_epoch(OID field_type, const char *str, Int8 *val);
 size_t		findTag(const char *str, int ccsc);
 
 BOOL build_libpq_bind_params(StatementClass *stmt,
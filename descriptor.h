@@ -29,6 +29,8 @@ enum {
 	,TI_HASOIDS	=	(1L << 2)
 	,TI_COLATTRIBUTE	=	(1L << 3)
 	,TI_HASSUBCLASS	=	(1L << 4)
+	,TI_HASRULES_CHECKED	=	(1L << 5)
+	,TI_HASRULES	=	(1L << 6)
 };
 typedef struct
 {
@@ -53,6 +55,10 @@ typedef struct
 #define	TI_set_hassubclass(ti)	(ti->flags |= TI_HASSUBCLASS)
 #define	TI_has_subclass(ti)	(0 != (ti->flags & TI_HASSUBCLASS))
 #define	TI_set_has_no_subclass(ti)	(ti->flags &= (~TI_HASSUBCLASS))
+#define	TI_set_hasrules_checked(ti)	(ti->flags |= TI_HASRULES_CHECKED)
+#define	TI_checked_hasrules(ti)		(0 != (ti->flags & TI_HASRULES_CHECKED))
+#define	TI_set_hasrules(ti)	(ti->flags |= TI_HASRULES)
+#define	TI_has_rules(ti)	(0 != (ti->flags & TI_HASRULES))
 void	TI_Constructor(TABLE_INFO *, const ConnectionClass *);
 void	TI_Destructor(TABLE_INFO **, int);
 void    TI_ClearObject(TABLE_INFO *ti);
@@ -717,6 +717,50 @@ copyConnAttributes(ConnInfo *ci, const char *attribute, const char *value)
 		ci->optional_errors = pg_atoi(value);
 	else if (stricmp(attribute, INI_IGNORETIMEOUT) == 0 || stricmp(attribute, ABBR_IGNORETIMEOUT) == 0)
 		ci->ignore_timeout = pg_atoi(value);
+	else if (stricmp(attribute, INI_PIPELINEBATCH) == 0 || stricmp(attribute, ABBR_PIPELINEBATCH) == 0)
+		ci->pipeline_batch = pg_atoi(value);
+	else if (stricmp(attribute, INI_BINARYRESULTS) == 0 || stricmp(attribute, ABBR_BINARYRESULTS) == 0)
+		ci->binary_results = pg_atoi(value);
+	else if (stricmp(attribute, INI_PREPAREDCACHESIZE) == 0 || stricmp(attribute, ABBR_PREPAREDCACHESIZE) == 0)
+		ci->prepared_cache_size = pg_atoi(value);
+	else if (stricmp(attribute, INI_COPYINSERT) == 0 || stricmp(attribute, ABBR_COPYINSERT) == 0)
+		ci->copy_insert = pg_atoi(value);
+	else if (stricmp(attribute, INI_COPYSTREAM) == 0 || stricmp(attribute, ABBR_COPYSTREAM) == 0)
+		ci->copy_stream = pg_atoi(value);
+	else if (stricmp(attribute, INI_CONNPOOLSIZE) == 0 || stricmp(attribute, ABBR_CONNPOOLSIZE) == 0)
+		ci->conn_pool_size = pg_atoi(value);
+	else if (stricmp(attribute, INI_POOLIDLETIMEOUT) == 0 || stricmp(attribute, ABBR_POOLIDLETIMEOUT) == 0)
+		ci->pool_idle_timeout = pg_atoi(value);
+	else if (stricmp(attribute, INI_POOLRESETCOMMAND) == 0 || stricmp(attribute, ABBR_POOLRESETCOMMAND) == 0)
+	{
+		NULL_THE_NAME(ci->pool_reset_command);
+		ci->pool_reset_command = decode_or_remove_braces(value);
+	}
+	else if (stricmp(attribute, INI_POOLHEALTHCHECK) == 0 || stricmp(attribute, ABBR_POOLHEALTHCHECK) == 0)
+		ci->pool_health_check = pg_atoi(value);
+	else if (stricmp(attribute, INI_FETCHREADAHEAD) == 0 || stricmp(attribute, ABBR_FETCHREADAHEAD) == 0)
+		ci->fetch_read_ahead = pg_atoi(value);
+	else if (stricmp(attribute, INI_FETCHTARGETBYTES) == 0 || stricmp(attribute, ABBR_FETCHTARGETBYTES) == 0)
+		ci->fetch_target_bytes = pg_atoi(value);
+	else if (stricmp(attribute, INI_FETCHTARGETTIME) == 0 || stricmp(attribute, ABBR_FETCHTARGETTIME) == 0)
+		ci->fetch_target_time = pg_atoi(value);
+	else if (stricmp(attribute, INI_FETCHMINROWS) == 0 || stricmp(attribute, ABBR_FETCHMINROWS) == 0)
+		ci->fetch_min_rows = pg_atoi(value);
+	else if (stricmp(attribute, INI_FETCHMAXROWS) == 0 || stricmp(attribute, ABBR_FETCHMAXROWS) == 0)
+		ci->fetch_max_rows = pg_atoi(value);
+	else if (stricmp(attribute, INI_SPILLTHRESHOLD) == 0 || stricmp(attribute, ABBR_SPILLTHRESHOLD) == 0)
+		ci->spill_threshold = pg_atoi(value);
+	else if (stricmp(attribute, INI_SPILLDIRECTORY) == 0 || stricmp(attribute, ABBR_SPILLDIRECTORY) == 0)
+	{
+		NULL_THE_NAME(ci->spill_directory);
+		ci->spill_directory = decode_or_remove_braces(value);
+	}
+	else if (stricmp(attribute, INI_DESCRIBECACHESIZE) == 0 || stricmp(attribute, ABBR_DESCRIBECACHESIZE) == 0)
+		ci->describe_cache_size = pg_atoi(value);
+	else if (stricmp(attribute, INI_COLINFOCACHESIZE) == 0 || stricmp(attribute, ABBR_COLINFOCACHESIZE) == 0)
+		ci->col_info_cache_size = pg_atoi(value);
+	else if (stricmp(attribute, INI_BORROWRESULTVALUES) == 0 || stricmp(attribute, ABBR_BORROWRESULTVALUES) == 0)
+		ci->borrow_result_values = pg_atoi(value);
 	else if (stricmp(attribute, INI_SSLMODE) == 0 || stricmp(attribute, ABBR_SSLMODE) == 0)
 	{
 		switch (value[0])
@@ -1102,6 +1146,46 @@ MYLOG(0, "drivername=%s\n", drivername);
 			ci->batch_size = DEFAULT_BATCH_SIZE;
 	if (SQLGetPrivateProfileString(DSN, INI_IGNORETIMEOUT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		ci->ignore_timeout = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_PIPELINEBATCH, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->pipeline_batch = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_BINARYRESULTS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->binary_results = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_PREPAREDCACHESIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->prepared_cache_size = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_COPYINSERT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->copy_insert = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_COPYSTREAM, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->copy_stream = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_CONNPOOLSIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->conn_pool_size = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_POOLIDLETIMEOUT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->pool_idle_timeout = pg_atoi(temp);
+	SQLGetPrivateProfileString(DSN, INI_POOLRESETCOMMAND, ENTRY_TEST, temp, sizeof(temp), ODBC_INI);
+	if (strcmp(temp, ENTRY_TEST))	/* entry exists */
+		STRX_TO_NAME(ci->pool_reset_command, temp);
+	if (SQLGetPrivateProfileString(DSN, INI_POOLHEALTHCHECK, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->pool_health_check = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHREADAHEAD, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_read_ahead = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHTARGETBYTES, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_target_bytes = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHTARGETTIME, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_target_time = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHMINROWS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_min_rows = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHMAXROWS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_max_rows = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_SPILLTHRESHOLD, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->spill_threshold = pg_atoi(temp);
+	SQLGetPrivateProfileString(DSN, INI_SPILLDIRECTORY, ENTRY_TEST, temp, sizeof(temp), ODBC_INI);
+	if (strcmp(temp, ENTRY_TEST))	/* entry exists */
+		STRX_TO_NAME(ci->spill_directory, temp);
+	if (SQLGetPrivateProfileString(DSN, INI_DESCRIBECACHESIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->describe_cache_size = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_COLINFOCACHESIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->col_info_cache_size = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_BORROWRESULTVALUES, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->borrow_result_values = pg_atoi(temp);
 
 	if (SQLGetPrivateProfileString(DSN, INI_SSLMODE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		STRCPY_FIXED(ci->sslmode, temp);
@@ -1402,6 +1486,101 @@ writeDSNinfo(const ConnInfo *ci)
 								 INI_IGNORETIMEOUT,
 								 temp,
 								 ODBC_INI);
+	ITOA_FIXED(temp, ci->pipeline_batch);
+	SQLWritePrivateProfileString(DSN,
+								 INI_PIPELINEBATCH,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->binary_results);
+	SQLWritePrivateProfileString(DSN,
+								 INI_BINARYRESULTS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->prepared_cache_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_PREPAREDCACHESIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->copy_insert);
+	SQLWritePrivateProfileString(DSN,
+								 INI_COPYINSERT,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->copy_stream);
+	SQLWritePrivateProfileString(DSN,
+								 INI_COPYSTREAM,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->conn_pool_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_CONNPOOLSIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->pool_idle_timeout);
+	SQLWritePrivateProfileString(DSN,
+								 INI_POOLIDLETIMEOUT,
+								 temp,
+								 ODBC_INI);
+	if (NAME_IS_VALID(ci->pool_reset_command))
+		SQLWritePrivateProfileString(DSN,
+									 INI_POOLRESETCOMMAND,
+									 GET_NAME(ci->pool_reset_command),
+									 ODBC_INI);
+	ITOA_FIXED(temp, ci->pool_health_check);
+	SQLWritePrivateProfileString(DSN,
+								 INI_POOLHEALTHCHECK,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_read_ahead);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHREADAHEAD,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_target_bytes);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHTARGETBYTES,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_target_time);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHTARGETTIME,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_min_rows);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHMINROWS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_max_rows);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHMAXROWS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->spill_threshold);
+	SQLWritePrivateProfileString(DSN,
+								 INI_SPILLTHRESHOLD,
+								 temp,
+								 ODBC_INI);
+	if (NAME_IS_VALID(ci->spill_directory))
+		SQLWritePrivateProfileString(DSN,
+									 INI_SPILLDIRECTORY,
+									 GET_NAME(ci->spill_directory),
+									 ODBC_INI);
+	ITOA_FIXED(temp, ci->describe_cache_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_DESCRIBECACHESIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->col_info_cache_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_COLINFOCACHESIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->borrow_result_values);
+	SQLWritePrivateProfileString(DSN,
+								 INI_BORROWRESULTVALUES,
+								 temp,
+								 ODBC_INI);
 	ITOA_FIXED(temp, ci->fetch_refcursors);
 	SQLWritePrivateProfileString(DSN,
 								 INI_FETCHREFCURSORS,
@@ -1802,6 +1981,8 @@ CC_conninfo_release(ConnInfo *conninfo)
 	NULL_THE_NAME(conninfo->password);
 	NULL_THE_NAME(conninfo->conn_settings);
 	NULL_THE_NAME(conninfo->pqopt);
+	NULL_THE_NAME(conninfo->pool_reset_command);
+	NULL_THE_NAME(conninfo->spill_directory);
 	finalize_globals(&conninfo->drivers);
 }
 
@@ -1836,6 +2017,23 @@ CC_conninfo_init(ConnInfo *conninfo, UInt4 option)
 	conninfo->disable_convert_func = -1;
 	conninfo->batch_size = DEFAULT_BATCH_SIZE;
 	conninfo->ignore_timeout = DEFAULT_IGNORETIMEOUT;
+	conninfo->pipeline_batch = DEFAULT_PIPELINEBATCH;
+	conninfo->binary_results = DEFAULT_BINARYRESULTS;
+	conninfo->prepared_cache_size = DEFAULT_PREPAREDCACHESIZE;
+	conninfo->copy_insert = DEFAULT_COPYINSERT;
+	conninfo->copy_stream = DEFAULT_COPYSTREAM;
+	conninfo->conn_pool_size = DEFAULT_CONNPOOLSIZE;
+	conninfo->pool_idle_timeout = DEFAULT_POOLIDLETIMEOUT;
+	conninfo->pool_health_check = DEFAULT_POOLHEALTHCHECK;
+	conninfo->fetch_read_ahead = DEFAULT_FETCHREADAHEAD;
+	conninfo->fetch_target_bytes = DEFAULT_FETCHTARGETBYTES;
+	conninfo->fetch_target_time = DEFAULT_FETCHTARGETTIME;
+	conninfo->fetch_min_rows = DEFAULT_FETCHMINROWS;
+	conninfo->fetch_max_rows = DEFAULT_FETCHMAXROWS;
+	conninfo->spill_threshold = DEFAULT_SPILLTHRESHOLD;
+	conninfo->describe_cache_size = DEFAULT_DESCRIBECACHESIZE;
+	conninfo->col_info_cache_size = DEFAULT_COLINFOCACHESIZE;
+	conninfo->borrow_result_values = DEFAULT_BORROWRESULTVALUES;
 	conninfo->wcs_debug = -1;
 	conninfo->fetch_refcursors = -1;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
@@ -1939,6 +2137,25 @@ CC_copy_conninfo(ConnInfo *ci, const ConnInfo *sci)
 	CORR_VALCPY(keepalive_interval);
 	CORR_VALCPY(batch_size);
 	CORR_VALCPY(ignore_timeout);
+	CORR_VALCPY(pipeline_batch);
+	CORR_VALCPY(binary_results);
+	CORR_VALCPY(prepared_cache_size);
+	CORR_VALCPY(copy_insert);
+	CORR_VALCPY(copy_stream);
+	CORR_VALCPY(conn_pool_size);
+	CORR_VALCPY(pool_idle_timeout);
+	NAME_TO_NAME(ci->pool_reset_command, sci->pool_reset_command);
+	CORR_VALCPY(pool_health_check);
+	CORR_VALCPY(fetch_read_ahead);
+	CORR_VALCPY(fetch_target_bytes);
+	CORR_VALCPY(fetch_target_time);
+	CORR_VALCPY(fetch_min_rows);
+	CORR_VALCPY(fetch_max_rows);
+	CORR_VALCPY(spill_threshold);
+	NAME_TO_NAME(ci->spill_directory, sci->spill_directory);
+	CORR_VALCPY(describe_cache_size);
+	CORR_VALCPY(col_info_cache_size);
+	CORR_VALCPY(borrow_result_values);
 	CORR_VALCPY(fetch_refcursors);
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	CORR_VALCPY(xa_opt);
@@ -175,6 +175,44 @@ extern "C" {
 #define INI_DTCLOG			"Dtclog"
 #define INI_FETCHREFCURSORS		"FetchRefcursors"
 #define ABBR_FETCHREFCURSORS		"DA"
+#define INI_PIPELINEBATCH		"PipelineBatch"
+#define ABBR_PIPELINEBATCH		"DB"
+#define INI_BINARYRESULTS		"BinaryResults"
+#define ABBR_BINARYRESULTS		"DC"
+#define INI_PREPAREDCACHESIZE		"PreparedCacheSize"
+#define ABBR_PREPAREDCACHESIZE		"DD"
+#define INI_COPYINSERT			"CopyInsert"
+#define ABBR_COPYINSERT			"DE"
+#define INI_COPYSTREAM			"CopyStream"
+#define ABBR_COPYSTREAM			"DF"
+#define INI_CONNPOOLSIZE		"ConnPoolSize"
+#define ABBR_CONNPOOLSIZE		"DG"
+#define INI_POOLIDLETIMEOUT		"PoolIdleTimeout"
+#define ABBR_POOLIDLETIMEOUT		"DH"
+#define INI_POOLRESETCOMMAND		"PoolResetCommand"
+#define ABBR_POOLRESETCOMMAND		"DI"
+#define INI_POOLHEALTHCHECK		"PoolHealthCheck"
+#define ABBR_POOLHEALTHCHECK		"DJ"
+#define INI_FETCHREADAHEAD		"FetchReadAhead"
+#define ABBR_FETCHREADAHEAD		"DK"
+#define INI_FETCHTARGETBYTES		"FetchTargetBytes"
+#define ABBR_FETCHTARGETBYTES		"DL"
+#define INI_FETCHTARGETTIME		"FetchTargetTime"
+#define ABBR_FETCHTARGETTIME		"DM"
+#define INI_FETCHMINROWS		"FetchMinRows"
+#define ABBR_FETCHMINROWS		"DN"
+#define INI_FETCHMAXROWS		"FetchMaxRows"
+#define ABBR_FETCHMAXROWS		"DO"
+#define INI_SPILLTHRESHOLD		"SpillThreshold"
+#define ABBR_SPILLTHRESHOLD		"DP"
+#define INI_SPILLDIRECTORY		"SpillDirectory"
+#define ABBR_SPILLDIRECTORY		"DQ"
+#define INI_DESCRIBECACHESIZE		"DescribeCacheSize"
+#define ABBR_DESCRIBECACHESIZE		"DR"
+#define INI_COLINFOCACHESIZE		"ColumnInfoCacheSize"
+#define ABBR_COLINFOCACHESIZE		"DS"
+#define INI_BORROWRESULTVALUES		"BorrowResultValues"
+#define ABBR_BORROWRESULTVALUES		"DT"
 /* "PreferLibpq", abbreviated "D4", used to mean whether to prefer libpq.
  * libpq is now required
 #define INI_PREFERLIBPQ			"PreferLibpq"
@@ -278,6 +316,24 @@ extern "C" {
 #define DEFAULT_BATCH_SIZE		100
 #define DEFAULT_IGNORETIMEOUT		0
 #define DEFAULT_FETCHREFCURSORS		0
+#define DEFAULT_PIPELINEBATCH		0
+#define DEFAULT_BINARYRESULTS		0
+#define DEFAULT_PREPAREDCACHESIZE	0
+#define DEFAULT_COPYINSERT		0
+#define DEFAULT_COPYSTREAM		0
+#define DEFAULT_CONNPOOLSIZE		0
+#define DEFAULT_POOLIDLETIMEOUT		300
+#define DEFAULT_POOLRESETCOMMAND	"DISCARD ALL"
+#define DEFAULT_POOLHEALTHCHECK		0
+#define DEFAULT_FETCHREADAHEAD		0
+#define DEFAULT_FETCHTARGETBYTES		0
+#define DEFAULT_FETCHTARGETTIME		0
+#define DEFAULT_FETCHMINROWS		10
+#define DEFAULT_FETCHMAXROWS		10000
+#define DEFAULT_SPILLTHRESHOLD		0
+#define DEFAULT_DESCRIBECACHESIZE	0
+#define DEFAULT_COLINFOCACHESIZE	128
+#define DEFAULT_BORROWRESULTVALUES	0
 
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 #define DEFAULT_XAOPT			1
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <time.h>
 #include "pgapifunc.h"
 #ifdef	WIN32
 #include <winsock2.h>
@@ -33,6 +34,23 @@
 static int conns_count = 0;
 static ConnectionClass **conns = NULL;
 
+/*
+ * Idle server connections kept by the driver-internal pool.
+ * They are protected by conns_cs and the most recently released
+ * one comes first. Each connection belongs to the environment whose
+ * connection handle released it and is closed when the environment
+ * is freed.
+ */
+typedef struct PooledConn_
+{
+	struct PooledConn_	*next;
+	const EnvironmentClass	*env;	/* the owner */
+	char		*key;		/* the effective connection string */
+	PGconn		*pqconn;
+	time_t		idle_since;
+} PooledConn;
+static PooledConn *pooled_conns = NULL;
+
 #if defined(WIN_MULTITHREAD_SUPPORT)
 CRITICAL_SECTION	conns_cs;
 CRITICAL_SECTION	common_cs; /* commonly used for short term blocking */
@@ -557,6 +575,8 @@ EN_Destructor(EnvironmentClass *self)
 		conns_count = 0;
 	}
 	LEAVE_CONNS_CS;
+	/* No connection handle of the environment can reuse them any more */
+	EN_pool_drain(self);
 	DELETE_ENV_CS(self);
 	free(self);
 
@@ -655,3 +675,158 @@ EN_log_error(const char *func, char *desc, EnvironmentClass *self)
 	else
 		MYLOG(0, "INVALID ENVIRON HANDLE ERROR: func=%s, desc='%s'\n", func, desc);
 }
+
+
+static void
+free_pooled_conns(PooledConn *list)
+{
+	PooledConn	*pc, *next;
+
+	for (pc = list; pc; pc = next)
+	{
+		next = pc->next;
+		QLOG(0, "PQfinish: %p\n", pc->pqconn);
+		PQfinish(pc->pqconn);
+		free(pc->key);
+		free(pc);
+	}
+}
+
+/*
+ *	Unlink the connections idle for more than idle_timeout seconds and
+ *	prepend them to *expired.
+ *	Should be called in the conns_cs critical section.
+ */
+static void
+unlink_expired_conns(int idle_timeout, PooledConn **expired)
+{
+	PooledConn	*pc, **prev;
+	time_t		now;
+
+	if (idle_timeout <= 0)
+		return;
+	now = time(NULL);
+	for (prev = &pooled_conns; NULL != (pc = *prev);)
+	{
+		if (now - pc->idle_since > idle_timeout)
+		{
+			*prev = pc->next;
+			pc->next = *expired;
+			*expired = pc;
+			continue;
+		}
+		prev = &pc->next;
+	}
+}
+
+/*
+ *	Take an idle server connection of the environment opened with the
+ *	connection string key out of the pool. Connections idle for more than
+ *	idle_timeout seconds are closed on the way.
+ *	The caller is responsible for checking that the connection is usable.
+ */
+void *
+EN_pool_acquire(const EnvironmentClass *env, const char *key, int idle_timeout)
+{
+	PooledConn	*pc, **prev, *expired = NULL, *found = NULL;
+	PGconn		*pqconn = NULL;
+
+	ENTER_CONNS_CS;
+	unlink_expired_conns(idle_timeout, &expired);
+	for (prev = &pooled_conns; NULL != (pc = *prev); prev = &pc->next)
+	{
+		if (pc->env == env && strcmp(pc->key, key) == 0)
+		{
+			*prev = pc->next;
+			found = pc;
+			break;
+		}
+	}
+	LEAVE_CONNS_CS;
+
+	free_pooled_conns(expired);
+	if (found)
+	{
+		pqconn = found->pqconn;
+		free(found->key);
+		free(found);
+	}
+	MYLOG(0, "pqconn=%p\n", pqconn);
+	return pqconn;
+}
+
+/*
+ *	Park a server connection whose session has been reset in the pool.
+ *	Returns FALSE when max_idle connections of the environment with the
+ *	same key are already idle; the caller should close the connection
+ *	then. Connections idle for more than idle_timeout seconds are closed
+ *	on the way.
+ */
+BOOL
+EN_pool_release(const EnvironmentClass *env, const char *key, void *pqconn, int max_idle, int idle_timeout)
+{
+	PooledConn	*pc, *newpc, *expired = NULL;
+	int		count = 0;
+	BOOL		ret = FALSE;
+
+	if (NULL == (newpc = (PooledConn *) malloc(sizeof(PooledConn))))
+		return ret;
+	if (NULL == (newpc->key = strdup(key)))
+	{
+		free(newpc);
+		return ret;
+	}
+	newpc->env = env;
+	newpc->pqconn = pqconn;
+	newpc->idle_since = time(NULL);
+
+	ENTER_CONNS_CS;
+	unlink_expired_conns(idle_timeout, &expired);
+	for (pc = pooled_conns; pc; pc = pc->next)
+	{
+		if (pc->env == env && strcmp(pc->key, key) == 0)
+			count++;
+	}
+	if (count < max_idle)
+	{
+		newpc->next = pooled_conns;
+		pooled_conns = newpc;
+		ret = TRUE;
+	}
+	LEAVE_CONNS_CS;
+
+	free_pooled_conns(expired);
+	MYLOG(0, "pqconn=%p idle=%d ret=%d\n", pqconn, count, ret);
+	if (!ret)
+	{
+		free(newpc->key);
+		free(newpc);
+	}
+	return ret;
+}
+
+/*
+ *	Close all the idle server connections of the environment.
+ *	The connections are closed outside the conns_cs critical section.
+ */
+void
+EN_pool_drain(const EnvironmentClass *env)
+{
+	PooledConn	*pc, **prev, *list = NULL;
+
+	ENTER_CONNS_CS;
+	for (prev = &pooled_conns; NULL != (pc = *prev);)
+	{
+		if (pc->env == env)
+		{
+			*prev = pc->next;
+			pc->next = list;
+			list = pc;
+			continue;
+		}
+		prev = &pc->next;
+	}
+	LEAVE_CONNS_CS;
+
+	free_pooled_conns(list);
+}
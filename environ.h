@@ -43,6 +43,9 @@ char		EN_remove_connection(EnvironmentClass *self, ConnectionClass *conn);
 void		EN_log_error(const char *func, char *desc, EnvironmentClass *self);
 int	getConnCount(void);
 ConnectionClass * const *getConnList(void);
+void		*EN_pool_acquire(const EnvironmentClass *env, const char *key, int idle_timeout);
+BOOL		EN_pool_release(const EnvironmentClass *env, const char *key, void *pqconn, int max_idle, int idle_timeout);
+void		EN_pool_drain(const EnvironmentClass *env);
 
 #define	EN_OV_ODBC2	1L
 #define	EN_CONN_POOLING	(1L<<1)
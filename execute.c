@@ -251,6 +251,10 @@ inquireHowToPrepare(const StatementClass *stmt)
 					return PARSE_REQ_FOR_INFO;
 				else if (SQL_CURSOR_FORWARD_ONLY != stmt->options.cursor_type)
 					ret = PARSE_REQ_FOR_INFO;
+				/* COPY TO STDOUT needs the parameters embedded */
+				else if (ci->copy_stream &&
+					 SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency)
+					ret = PARSE_REQ_FOR_INFO;
 				else
 					ret = PARSE_TO_EXEC_ONCE;
 			}
@@ -425,6 +429,85 @@ const char *GetSvpName(const ConnectionClass *conn, char *wrk, int wrksize)
 	return wrk;
 }
 
+/*
+ *	Can all the rows of the parameter array be processed at once ?
+ *	Only single commands without output parameters, which don't return
+ *	rows and have no data at execution parameters, are executed this way.
+ */
+static BOOL
+all_rows_at_once_is_usable(StatementClass *stmt, SQLLEN start_row, SQLLEN end_row, SQLSMALLINT num_params)
+{
+	APDFields	*apdopts = SC_get_APDF(stmt);
+	SQLULEN		offset = apdopts->param_offset_ptr ? *apdopts->param_offset_ptr : 0;
+	SQLINTEGER	bind_size = apdopts->param_bind_type;
+	Int4		num_p = num_params < apdopts->allocated ? num_params : apdopts->allocated;
+	Int2		num_io, num_out;
+	SQLLEN		row, *pcVal;
+	int		i;
+
+	if (!stmt->use_server_side_prepare)
+		return FALSE;
+	if (stmt->multi_statement < 0)
+		PGAPI_NumParams(stmt, &num_params);
+	if (0 != stmt->multi_statement)
+		return FALSE;
+	if (STMT_TYPE_PROCCALL == stmt->statement_type ||
+	    SC_may_fetch_rows(stmt) ||
+	    SC_is_fetchcursor(stmt))
+		return FALSE;
+	CountParameters(stmt, NULL, &num_io, &num_out);
+	if (num_io > 0 || num_out > 0)
+		return FALSE;
+	for (row = start_row; row <= end_row; row++)
+	{
+		for (i = 0; i < num_p; i++)
+		{
+			if (NULL == (pcVal = apdopts->parameters[i].used))
+				continue;
+			if (bind_size > 0)
+				pcVal = LENADDR_SHIFT(pcVal, offset + bind_size * row);
+			else
+				pcVal = LENADDR_SHIFT(pcVal, offset) + row;
+			if (*pcVal == SQL_DATA_AT_EXEC || *pcVal <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+				return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*
+ *	Can the rows of the parameter array be loaded by COPY FROM STDIN ?
+ */
+static BOOL
+copy_insert_is_usable(StatementClass *stmt, SQLLEN start_row, SQLLEN end_row, SQLSMALLINT num_params)
+{
+	char	*copycmd;
+
+	if (0 == SC_get_conn(stmt)->connInfo.copy_insert ||
+	    !all_rows_at_once_is_usable(stmt, start_row, end_row, num_params))
+		return FALSE;
+	if (copycmd = SC_copy_insert_command(stmt), NULL == copycmd)
+		return FALSE;
+	free(copycmd);
+	/* the rows have to be inserted by INSERT to apply the rules */
+	if (SC_copy_insert_has_rules(stmt))
+		return FALSE;
+	return TRUE;
+}
+
+#ifdef	LIBPQ_HAS_PIPELINING
+/*
+ *	Can the rows of the parameter array be sent in libpq pipeline mode ?
+ */
+static BOOL
+pipeline_is_usable(StatementClass *stmt, SQLLEN start_row, SQLLEN end_row, SQLSMALLINT num_params)
+{
+	if (0 == SC_get_conn(stmt)->connInfo.pipeline_batch)
+		return FALSE;
+	return all_rows_at_once_is_usable(stmt, start_row, end_row, num_params);
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
 /*
  *	The execution after all parameters were resolved.
  */
@@ -482,7 +565,9 @@ RETCODE	Exec_with_parameters_resolved(StatementClass *stmt, EXEC_TYPE exec_type,
 MYLOG(DETAIL_LOG_LEVEL, "prepare_before_exec=%d srv=%d\n", prepare_before_exec, stmt->use_server_side_prepare);
 	/* Create the statement with parameters substituted. */
 	stmt_with_params = stmt->stmt_with_params;
-	if (LAST_EXEC == exec_type)
+	if (ASYNC_EXEC_READY == stmt->async_exec)
+		;	/* the parameters were sent by the first call */
+	else if (LAST_EXEC == exec_type)
 	{
 		if (NULL != stmt_with_params)
 		{
@@ -504,7 +589,13 @@ MYLOG(DETAIL_LOG_LEVEL, "prepare_before_exec=%d srv=%d\n", prepare_before_exec,
 			RETURN(retval) /* error msg is passed from the above */
 		}
 		stmt_with_params = stmt->stmt_with_params;
-		if (!stmt_with_params) // Extended Protocol
+		if (EXEC_ALL_ROWS(exec_type))
+		{
+			/* the driver embedded the parameters, execute one by one */
+			if (NULL != stmt_with_params)
+				stmt->exec_type = exec_type = DIRECT_EXEC;
+		}
+		else if (!stmt_with_params) // Extended Protocol
 			exec_type = DIRECT_EXEC;
 	}
 
@@ -538,9 +629,12 @@ MYLOG(0, "about to begin SC_execute exec_type=%d\n", exec_type);
 		}
 	}
 	count_of_deferred = stmt->count_of_deffered;
-	if (DIRECT_EXEC == exec_type)
+	if (DIRECT_EXEC == exec_type ||
+	    EXEC_ALL_ROWS(exec_type))
 	{
 		retval = SC_execute(stmt);
+		if (SQL_STILL_EXECUTING == retval)
+			RETURN(retval)
 		stmt->count_of_deffered = 0;
 	}
 	else if (DEFFERED_EXEC == exec_type &&
@@ -587,7 +681,9 @@ MYLOG(0, "about to begin SC_execute exec_type=%d\n", exec_type);
 	if (retval == SQL_ERROR)
 	{
 MYLOG(0, "count_of_deferred=%d\n", count_of_deferred);
-		param_status_batch_update(ipdopts, SQL_PARAM_ERROR, stmt->exec_current_row, count_of_deferred);
+		/* the pipelined or COPY execution has set the status of each row */
+		if (!EXEC_ALL_ROWS(exec_type))
+			param_status_batch_update(ipdopts, SQL_PARAM_ERROR, stmt->exec_current_row, count_of_deferred);
 		stmt->exec_current_row = -1;
 		*exec_end = TRUE;
 		RETURN(retval)
@@ -610,7 +706,8 @@ MYLOG(0, "count_of_deferred=%d\n", count_of_deferred);
 		}
 	}
 	ipdopts = SC_get_IPDF(stmt);
-	if (ipdopts->param_status_ptr)
+	if (ipdopts->param_status_ptr &&
+	    !EXEC_ALL_ROWS(exec_type))
 	{
 		switch (retval)
 		{
@@ -859,6 +956,7 @@ CC_is_in_trans(conn), SC_is_rb_stmt(stmt), SC_is_tc_stmt(stmt));
 	switch (ret)
 	{
 		case SQL_NEED_DATA:
+		case SQL_STILL_EXECUTING:
 			break;
 		case SQL_ERROR:
 			start_stmt = TRUE;
@@ -997,6 +1095,19 @@ PGAPI_Execute(HSTMT hstmt, UWORD flag)
 
 	MYLOG(0, "entering...%x %p status=%d\n", flag, stmt, stmt->status);
 
+	if (SC_async_exec_pending(stmt))
+	{
+		/* The application is polling the asynchronous execution */
+		if (!SC_async_exec_ready(stmt))
+			return SQL_STILL_EXECUTING;
+		conn = SC_get_conn(stmt);
+		apdopts = SC_get_APDF(stmt);
+		ipdopts = SC_get_IPDF(stmt);
+		start_row = end_row = stmt->exec_current_row;
+		num_params = stmt->num_params;
+		goto resume_async;
+	}
+
 	stmt->has_notice = 0;
 	conn = SC_get_conn(stmt);
 	apdopts = SC_get_APDF(stmt);
@@ -1086,17 +1197,23 @@ PGAPI_Execute(HSTMT hstmt, UWORD flag)
 		   parameters even in case of non-prepared statements.
 		 */
 		int	nCallParse = doNothing;
-		BOOL	maybeBatch = FALSE;
+		BOOL	maybeBatch = FALSE, usePipeline = FALSE, useCopy = FALSE;
 
 		if (end_row > start_row &&
 		    SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type &&
 		    SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency &&
 		    stmt->batch_size > 1)
 			maybeBatch = TRUE;
-MYLOG(0, "prepare=%d prepared=%d  batch_size=%d start_row=" FORMAT_LEN "end_row=" FORMAT_LEN " => maybeBatch=%d\n", stmt->prepare, stmt->prepared, stmt->batch_size, start_row, end_row, maybeBatch);
+		if (maybeBatch)
+			useCopy = copy_insert_is_usable(stmt, start_row, end_row, num_params);
+#ifdef	LIBPQ_HAS_PIPELINING
+		if (maybeBatch && !useCopy)
+			usePipeline = pipeline_is_usable(stmt, start_row, end_row, num_params);
+#endif /* LIBPQ_HAS_PIPELINING */
+MYLOG(0, "prepare=%d prepared=%d  batch_size=%d start_row=" FORMAT_LEN "end_row=" FORMAT_LEN " => maybeBatch=%d usePipeline=%d useCopy=%d\n", stmt->prepare, stmt->prepared, stmt->batch_size, start_row, end_row, maybeBatch, usePipeline, useCopy);
 		if (NOT_YET_PREPARED == stmt->prepared)
 		{
-			if (maybeBatch)
+			if (maybeBatch && !usePipeline && !useCopy)
 				stmt->use_server_side_prepare = 0;
 			switch (nCallParse = HowToPrepareBeforeExec(stmt, TRUE))
 			{
@@ -1113,7 +1230,11 @@ MYLOG(0, "prepareParameters was %s called, prepare state:%d\n", shouldParse == n
 		{
 			SC_set_Result(stmt, NULL);
 		}
-		if (0 != (PREPARE_BY_THE_DRIVER & stmt->prepare) &&
+		if (useCopy)
+			stmt->exec_type = COPY_EXEC;
+		else if (usePipeline)
+			stmt->exec_type = PIPELINE_EXEC;
+		else if (0 != (PREPARE_BY_THE_DRIVER & stmt->prepare) &&
 		    maybeBatch)
 			stmt->exec_type = DEFFERED_EXEC;
 		else
@@ -1240,7 +1361,20 @@ next_param_row:
 
 	if (0 != (flag & PODBC_WITH_HOLD))
 		SC_set_with_hold(stmt);
+	/*
+	 * Only a single row of parameters may be executed asynchronously,
+	 * everything else completes before returning.
+	 */
+	if (SQL_ASYNC_ENABLE_ON == stmt->options.async_enable &&
+	    DIRECT_EXEC == stmt->exec_type &&
+	    start_row == end_row &&
+	    stmt->external)
+		stmt->async_exec = ASYNC_EXEC_REQUESTED;
+resume_async:
 	retval = Exec_with_parameters_resolved(stmt, stmt->exec_type, &exec_end);
+	if (SQL_STILL_EXECUTING == retval)
+		goto cleanup;
+	stmt->async_exec = ASYNC_EXEC_NONE;
 	if (!exec_end)
 	{
 		goto next_param_row;
@@ -1350,8 +1484,10 @@ PGAPI_Cancel(HSTMT hstmt)		/* Statement to cancel. */
 	 * 1. In the middle of SQLParamData / SQLPutData
 	 *    -> cancel the statement
 	 *
-	 * 2. Running a query asynchronously. (asynchronous mode is not supported
-	 *    by psqlODBC)
+	 * 2. Running a query asynchronously (SQL_ATTR_ASYNC_ENABLE).
+	 *    -> The statement stays in STMT_EXECUTING state until the results
+	 *       are polled, so this is handled the same as 3. The next poll
+	 *       returns the error of the cancelled query.
 	 *
 	 * 3. Busy running a function in another thread.
 	 *    -> Send a query cancel request to the server
@@ -856,7 +856,7 @@ MYLOG(0, "CONVERT_FUNCTIONS=" FORMAT_ULEN "\n", value);
 			break;
 		case SQL_ASYNC_MODE:
 			len = 4;
-			value = SQL_AM_NONE;
+			value = SQL_AM_STATEMENT;
 			break;
 		case SQL_BATCH_ROW_COUNT:
 			len = 4;
@@ -1046,6 +1046,10 @@ MYLOG(0, "CONVERT_FUNCTIONS=" FORMAT_ULEN "\n", value);
 			len = 4;
 			value = SQL_SVE_CASE | SQL_SVE_CAST | SQL_SVE_COALESCE | SQL_SVE_NULLIF;
 			break;
+		case SQL_MAX_ASYNC_CONCURRENT_STATEMENTS:
+			len = 4;
+			value = 1;	/* the connection is busy while executing asynchronously */
+			break;
 #ifdef SQL_DTC_TRANSACTION_COST
 		case SQL_DTC_TRANSACTION_COST:
 #else
@@ -1060,8 +1064,6 @@ MYLOG(0, "CONVERT_FUNCTIONS=" FORMAT_ULEN "\n", value);
 			len = 0;
 		case SQL_DRIVER_HDESC:
 			len = 4;
-		case SQL_MAX_ASYNC_CONCURRENT_STATEMENTS:
-			len = 4;
 		case SQL_STANDARD_CLI_CONFORMANCE:
 			len = 4;
 		case SQL_XOPEN_CLI_YEAR:
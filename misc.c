@@ -312,3 +312,19 @@ quote_table(const pgNAME schema, const pgNAME table, char *buf, int buf_size)
 
 	return buf;
 }
+
+/*
+ *	Milliseconds from an arbitrary point, to measure elapsed times.
+ */
+UInt4
+get_msec(void)
+{
+#ifdef	WIN32
+	return GetTickCount();
+#else
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (UInt4) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+#endif /* WIN32 */
+}
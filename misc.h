@@ -29,6 +29,7 @@ char	   *my_trim(char *string);
 char	   *make_string(const SQLCHAR *s, SQLINTEGER len, char *buf, size_t bufsize);
 /* #define	GET_SCHEMA_NAME(nspname) 	(stricmp(nspname, "public") ? nspname : "") */
 char *quote_table(const pgNAME schema, const pgNAME table, char *buf, int nuf_size);
+UInt4		get_msec(void);
 
 #define	GET_SCHEMA_NAME(nspname) 	(nspname)
 
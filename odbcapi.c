@@ -314,7 +314,13 @@ SQLExecDirect(HSTMT StatementHandle,
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= PODBC_WITH_HOLD;
-	if (SC_opencheck(stmt, func))
+	if (SC_async_exec_pending(stmt))
+	{
+		/* polling the asynchronous execution */
+		ret = PGAPI_Execute(StatementHandle, flag);
+		ret = DiscardStatementSvp(stmt, ret, FALSE);
+	}
+	else if (SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
 	{
@@ -342,7 +348,13 @@ SQLExecute(HSTMT StatementHandle)
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= (PODBC_RECYCLE_STATEMENT | PODBC_WITH_HOLD);
-	if (SC_opencheck(stmt, func))
+	if (SC_async_exec_pending(stmt))
+	{
+		/* polling the asynchronous execution */
+		ret = PGAPI_Execute(StatementHandle, flag);
+		ret = DiscardStatementSvp(stmt, ret, FALSE);
+	}
+	else if (SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
 	{
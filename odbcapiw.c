@@ -332,20 +332,28 @@ SQLExecDirectW(HSTMT StatementHandle,
 	if (SC_connection_lost_check(stmt, __FUNCTION__))
 		return SQL_ERROR;
 
-	stxt = ucs2_to_utf8(StatementText, TextLength, &slen, FALSE);
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= PODBC_WITH_HOLD;
-	StartRollbackState(stmt);
-	if (SC_opencheck(stmt, func))
+	if (SC_async_exec_pending(stmt))
+	{
+		/* polling the asynchronous execution */
+		ret = PGAPI_Execute(StatementHandle, flag);
+		ret = DiscardStatementSvp(stmt, ret, FALSE);
+	}
+	else if (SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
 	else
+	{
+		stxt = ucs2_to_utf8(StatementText, TextLength, &slen, FALSE);
+		StartRollbackState(stmt);
 		ret = PGAPI_ExecDirect(StatementHandle,
 							   (SQLCHAR *) stxt, (SQLINTEGER) slen, flag);
-	ret = DiscardStatementSvp(stmt, ret, FALSE);
+		ret = DiscardStatementSvp(stmt, ret, FALSE);
+		if (stxt)
+			free(stxt);
+	}
 	LEAVE_STMT_CS(stmt);
-	if (stxt)
-		free(stxt);
 	return ret;
 }
 
@@ -42,13 +42,21 @@ set_statement_option(ConnectionClass *conn,
 	switch (fOption)
 	{
 		case SQL_ASYNC_ENABLE:
-			if (vParam == SQL_ASYNC_ENABLE_ON) {
+			MYLOG(0, "SQL_ASYNC_ENABLE, vParam = " FORMAT_LEN "\n", vParam);
+			if (SQL_ASYNC_ENABLE_ON != vParam &&
+			    SQL_ASYNC_ENABLE_OFF != vParam)
+			{
 				if (stmt)
-					SC_set_error(stmt, STMT_OPTION_NOT_FOR_THE_DRIVER,
-								 "Asynchronous execution is not supported", func);
+					SC_set_error(stmt, STMT_INVALID_ARGUMENT_NO, "Illegal parameter value for SQL_ASYNC_ENABLE", func);
+				if (conn)
+					CC_set_error(conn, CONN_INVALID_ARGUMENT_NO, "Illegal parameter value for SQL_ASYNC_ENABLE", func);
 				return SQL_ERROR;
 			}
-			break;  /* SQL_ASYNC_ENABLE_OFF is a no-op, which is correct */
+			if (conn)
+				conn->stmtOptions.async_enable = (SQLUINTEGER) vParam;
+			if (stmt)
+				stmt->options.async_enable = (SQLUINTEGER) vParam;
+			break;
 
 		case SQL_BIND_TYPE:
 			/* now support multi-column and multi-row binding */
@@ -710,8 +718,8 @@ PGAPI_GetStmtOption(HSTMT hstmt,
 
 			break;
 
-		case SQL_ASYNC_ENABLE:	/* NOT SUPPORTED */
-			*((SQLINTEGER *) pvParam) = SQL_ASYNC_ENABLE_OFF;
+		case SQL_ASYNC_ENABLE:
+			*((SQLINTEGER *) pvParam) = stmt->options.async_enable;
 			break;
 
 		case SQL_BIND_TYPE:
@@ -34,6 +34,7 @@
 #include "pgtypes.h"
 #include "pgapifunc.h"
 #include "catfunc.h"
+#include "dlg_specific.h"
 
 #include "multibyte.h"
 #include "misc.h"
@@ -41,7 +42,7 @@
 #define FLD_INCR	32
 #define TAB_INCR	8
 #define COLI_INCR	16
-#define COLI_RECYCLE	128
+#define COLI_MAX	16384	/* ntables is an Int2 */
 
 static const char *getNextToken(int ccsc, char escape_in_literal, const char *s, char *token, int smax, char *delim, char *quote, char *dquote, char *numeric);
 static	void	getColInfo(COL_INFO *col_info, FIELD_INFO *fi, int k);
@@ -713,10 +714,158 @@ MYPRINTF(0, "->%d\n", updatable);
 	return TRUE;
 }
 
+/*
+ *	The COL_INFO cache of the connection is indexed by two open addressing
+ *	hash tables of the positions in conn->col_info, one by the schema and
+ *	table names and another by the table oid. The indexes are rebuilt at
+ *	the next lookup after getColumnsInfo() changed the cache, which only
+ *	happens after a round trip for SQLColumns anyway.
+ */
+static int
+col_info_cache_size(const ConnectionClass *conn)
+{
+	int	cache_size = conn->connInfo.col_info_cache_size;
+
+	if (cache_size <= 0)
+		return DEFAULT_COLINFOCACHESIZE;
+	if (cache_size > COLI_MAX)
+		return COLI_MAX;
+	return cache_size;
+}
+
+static UInt4
+hash_table_name(const char *schema_name, const char *table_name)
+{
+	UInt4	hash = 2166136261U;	/* FNV-1a, case insensitive as NAMEICMP */
+	const UCHAR *p;
+
+	for (p = (const UCHAR *) schema_name; *p; p++)
+		hash = (hash ^ tolower(*p)) * 16777619U;
+	hash = (hash ^ '.') * 16777619U;
+	for (p = (const UCHAR *) table_name; *p; p++)
+		hash = (hash ^ tolower(*p)) * 16777619U;
+	return hash;
+}
+
+static UInt4
+hash_table_oid(OID table_oid)
+{
+	return table_oid * 2654435761U;
+}
+
+static BOOL
+index_col_info(ConnectionClass *conn)
+{
+	int	i, index_size, mask;
+	UInt4	pos;
+	COL_INFO	*coli;
+
+	if (conn->coli_indexed)
+		return TRUE;
+	for (index_size = 2 * COLI_INCR; index_size < 2 * conn->ntables; index_size *= 2)
+		;
+	if (index_size != conn->coli_index_size)
+	{
+		Int2	*name_index, *oid_index;
+
+		if (NULL == (name_index = (Int2 *) realloc(conn->coli_name_index, index_size * sizeof(Int2))))
+			return FALSE;
+		conn->coli_name_index = name_index;
+		if (NULL == (oid_index = (Int2 *) realloc(conn->coli_oid_index, index_size * sizeof(Int2))))
+			return FALSE;
+		conn->coli_oid_index = oid_index;
+		conn->coli_index_size = index_size;
+	}
+	/* the positions are 1 based, 0 means an empty slot */
+	pg_memset(conn->coli_name_index, 0, index_size * sizeof(Int2));
+	pg_memset(conn->coli_oid_index, 0, index_size * sizeof(Int2));
+	mask = index_size - 1;
+	for (i = 0; i < conn->ntables; i++)
+	{
+		if (coli = conn->col_info[i], NULL == coli)
+			continue;
+		if (NAME_IS_VALID(coli->table_name))
+		{
+			for (pos = hash_table_name(SAFE_NAME(coli->schema_name), GET_NAME(coli->table_name)) & mask;
+			     0 != conn->coli_name_index[pos]; pos = (pos + 1) & mask)
+				;
+			conn->coli_name_index[pos] = i + 1;
+		}
+		if (0 != coli->table_oid)
+		{
+			for (pos = hash_table_oid(coli->table_oid) & mask;
+			     0 != conn->coli_oid_index[pos]; pos = (pos + 1) & mask)
+				;
+			conn->coli_oid_index[pos] = i + 1;
+		}
+	}
+	conn->coli_indexed = TRUE;
+	MYLOG(DETAIL_LOG_LEVEL, "indexed %d col_info in %d slots\n", conn->ntables, index_size);
+
+	return TRUE;
+}
+
+static COL_INFO *
+lookup_col_info_by_name(ConnectionClass *conn, const char *schema_name, const char *table_name)
+{
+	int	idx, mask;
+	UInt4	pos;
+	COL_INFO	*coli;
+
+	if (!index_col_info(conn))
+	{
+		/* no memory for the index */
+		for (idx = 0; idx < conn->ntables; idx++)
+		{
+			coli = conn->col_info[idx];
+			if (!stricmp(SAFE_NAME(coli->table_name), table_name) &&
+			    !stricmp(SAFE_NAME(coli->schema_name), schema_name))
+				return coli;
+		}
+		return NULL;
+	}
+	mask = conn->coli_index_size - 1;
+	for (pos = hash_table_name(schema_name, table_name) & mask;
+	     0 != (idx = conn->coli_name_index[pos]); pos = (pos + 1) & mask)
+	{
+		coli = conn->col_info[idx - 1];
+		if (!stricmp(SAFE_NAME(coli->table_name), table_name) &&
+		    !stricmp(SAFE_NAME(coli->schema_name), schema_name))
+			return coli;
+	}
+	return NULL;
+}
+
+static COL_INFO *
+lookup_col_info_by_oid(ConnectionClass *conn, OID table_oid)
+{
+	int	idx, mask;
+	UInt4	pos;
+	COL_INFO	*coli;
+
+	if (!index_col_info(conn))
+	{
+		/* no memory for the index */
+		for (idx = 0; idx < conn->ntables; idx++)
+		{
+			if (coli = conn->col_info[idx], coli->table_oid == table_oid)
+				return coli;
+		}
+		return NULL;
+	}
+	mask = conn->coli_index_size - 1;
+	for (pos = hash_table_oid(table_oid) & mask;
+	     0 != (idx = conn->coli_oid_index[pos]); pos = (pos + 1) & mask)
+	{
+		if (coli = conn->col_info[idx - 1], coli->table_oid == table_oid)
+			return coli;
+	}
+	return NULL;
+}
+
 static BOOL
 getCOLIfromTable(ConnectionClass *conn, pgNAME *schema_name, pgNAME table_name, COL_INFO **coli)
 {
-	int	colidx;
 	BOOL	found = FALSE;
 
 	*coli = NULL;
@@ -733,16 +882,11 @@ getCOLIfromTable(ConnectionClass *conn, pgNAME *schema_name, pgNAME table_name,
 		 */
 		if (curschema)
 		{
-			for (colidx = 0; colidx < conn->ntables; colidx++)
+			if (*coli = lookup_col_info_by_name(conn, curschema, GET_NAME(table_name)), NULL != *coli)
 			{
-				if (!NAMEICMP(conn->col_info[colidx]->table_name, table_name) &&
-					!stricmp(SAFE_NAME(conn->col_info[colidx]->schema_name), curschema))
-				{
-					MYLOG(0, "FOUND col_info table='%s' current schema='%s'\n", PRINT_NAME(table_name), curschema);
-					found = TRUE;
-					STR_TO_NAME(*schema_name, curschema);
-					break;
-				}
+				MYLOG(0, "FOUND col_info table='%s' current schema='%s'\n", PRINT_NAME(table_name), curschema);
+				found = TRUE;
+				STR_TO_NAME(*schema_name, curschema);
 			}
 		}
 		if (!found)
@@ -774,18 +918,12 @@ getCOLIfromTable(ConnectionClass *conn, pgNAME *schema_name, pgNAME table_name,
 	}
 	if (!found && NAME_IS_VALID(*schema_name))
 	{
-		for (colidx = 0; colidx < conn->ntables; colidx++)
+		if (*coli = lookup_col_info_by_name(conn, GET_NAME(*schema_name), GET_NAME(table_name)), NULL != *coli)
 		{
-			if (!NAMEICMP(conn->col_info[colidx]->table_name, table_name) &&
-			    !NAMEICMP(conn->col_info[colidx]->schema_name, *schema_name))
-			{
-				MYLOG(0, "FOUND col_info table='%s' schema='%s'\n", PRINT_NAME(table_name), PRINT_NAME(*schema_name));
-				found = TRUE;
-				break;
-			}
+			MYLOG(0, "FOUND col_info table='%s' schema='%s'\n", PRINT_NAME(table_name), PRINT_NAME(*schema_name));
+			found = TRUE;
 		}
 	}
-	*coli = found ? conn->col_info[colidx] : NULL;
 	return TRUE; /* success */
 }
 
@@ -837,16 +975,10 @@ getColumnsInfo(ConnectionClass *conn, TABLE_INFO *wti, OID greloid, StatementCla
 		if (greloid != 0)
 		{
 			/* We have reloid. Try to find appropriate coli object from connection COL_INFO cache. */
-			for (k = 0; k < conn->ntables; k++)
+			if (coli = lookup_col_info_by_oid(conn, greloid), NULL != coli)
 			{
-				tcoli = conn->col_info[k];
-				if (tcoli->table_oid == greloid)
-				{
-					/* We found appropriate coli object, so we will use it. */
-					coli = tcoli;
-					coli_exist = TRUE;
-					break;
-				}
+				/* We found appropriate coli object, so we will use it. */
+				coli_exist = TRUE;
 			}
 		}
 		if (!coli_exist)
@@ -873,13 +1005,15 @@ getColumnsInfo(ConnectionClass *conn, TABLE_INFO *wti, OID greloid, StatementCla
 					acctime = tcoli->acc_time;
 				}
 			}
-			if (!coli_exist && NULL != ccoli && conn->ntables >= COLI_RECYCLE)
+			if (!coli_exist && NULL != ccoli && conn->ntables >= col_info_cache_size(conn))
 			{
 				/* Not found unsed object. Amount of them is on limit. Taking least recently used coli object. */
 				coli_exist = TRUE;
 				coli = ccoli;
 			}
 		}
+		/* The cache is going to change. */
+		conn->coli_indexed = FALSE;
 		if (coli_exist)
 		{
 			/* We have ready to use coli object. Cleaning it. */
@@ -1047,18 +1181,12 @@ MYLOG(DETAIL_LOG_LEVEL, "fi=%p greloid=%d col_info=%p\n", wti, greloid, wti->col
 	}
 	if (greloid != 0)
 	{
-		int	colidx;
-
-		for (colidx = 0; colidx < conn->ntables; colidx++)
+		if (coli = lookup_col_info_by_oid(conn, greloid), NULL != coli)
 		{
-			if (conn->col_info[colidx]->table_oid == greloid)
-			{
-				MYLOG(0, "FOUND col_info table=%ul\n", greloid);
-				found = TRUE;
-				wti->col_info = conn->col_info[colidx];
-				wti->col_info->refcnt++;
-				break;
-			}
+			MYLOG(0, "FOUND col_info table=%ul\n", greloid);
+			found = TRUE;
+			wti->col_info = coli;
+			wti->col_info->refcnt++;
 		}
 	}
 	else
@@ -26,6 +26,7 @@
 #include "statement.h"
 #include "descriptor.h"
 #include "qresult.h"
+#include "arrow.h"
 #include "pgapifunc.h"
 #include "loadlib.h"
 #include "dlg_specific.h"
@@ -412,7 +413,7 @@ PGAPI_GetConnectAttr(HDBC ConnectionHandle,
 	switch (Attribute)
 	{
 		case SQL_ATTR_ASYNC_ENABLE:
-			*((SQLINTEGER *) Value) = SQL_ASYNC_ENABLE_OFF;
+			*((SQLINTEGER *) Value) = conn->stmtOptions.async_enable;
 			break;
 		case SQL_ATTR_AUTO_IPD:
 			*((SQLINTEGER *) Value) = SQL_FALSE;
@@ -1795,6 +1796,11 @@ PGAPI_GetStmtAttr(HSTMT StatementHandle,
 			/* Whether automatic population of IPD is supported */
 			*((SQLUINTEGER *) Value) = SQL_FALSE;
 			break;
+		case SQL_ATTR_PGOPT_ARROW_BATCH:
+			/* Fetch the next rows as Arrow arrays */
+			ret = SC_fetch_arrow_batch(stmt, (PG_ARROW_BATCH *) Value);
+			len = sizeof(PG_ARROW_BATCH);
+			break;
 		case SQL_ATTR_AUTO_IPD:	/* 10001 */
 			/* Unsupported attributes */
 			SC_set_error(stmt, DESC_INVALID_OPTION_IDENTIFIER, "Unsupported statement option (Get)", func);
@@ -1862,7 +1868,6 @@ PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			if (SQL_FALSE != Value)
 				unsupported = TRUE;
 			break;
-		case SQL_ATTR_ASYNC_ENABLE:
 		case SQL_ATTR_CONNECTION_DEAD:
 		case SQL_ATTR_CONNECTION_TIMEOUT:
 			unsupported = TRUE;
@@ -1958,6 +1963,11 @@ PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			conn->connInfo.ignore_timeout = CAST_PTR(SQLINTEGER, Value);
 			MYLOG(0, "ignore_timeout => %d\n", conn->connInfo.ignore_timeout);
 			break;
+		case SQL_ATTR_PGOPT_REFRESH_COLUMN_INFO:
+			/* forget the column information cached for Parse=1 */
+			CC_clear_col_info(conn, FALSE);
+			MYLOG(0, "column info cache cleared\n");
+			break;
 		default:
 			if (Attribute < 65536)
 				ret = PGAPI_SetConnectOption(ConnectionHandle, (SQLUSMALLINT) Attribute, (SQLLEN) Value);
@@ -2522,6 +2532,62 @@ typedef struct
 	int		idx, processed;
 }	bop_cdata;
 
+/*
+ *	Add, update or delete the whole rowset with one statement per table
+ *	if possible. s->idx is left 0 if the rows should be processed one
+ *	by one.
+ */
+static
+RETCODE	bulk_ope_rows(bop_cdata *s, QResultClass *res)
+{
+	CSTR func = "bulk_ope_rows";
+	RETCODE	ret = SQL_SUCCESS;
+	SQLSETPOSIROW	nrows = s->opts->size_of_rowset, irow;
+	SQLULEN		*global_idx = NULL;
+	KeySet		*keys = NULL;
+	PG_BM		pg_bm;
+	int		processed = 0;
+
+	if (nrows < 2 || !res || !PG_VERSION_GE(SC_get_conn(s->stmt), 8.2))
+		return ret;
+	if (SQL_DELETE_BY_BOOKMARK != s->operation &&
+	    !SC_pos_rows_settable(s->stmt, nrows, s->operation))
+		return ret;
+	if (SQL_ADD == s->operation)
+		ret = SC_pos_add_rows(s->stmt, nrows, &processed);
+	else
+	{
+		global_idx = (SQLULEN *) malloc(sizeof(SQLULEN) * nrows);
+		keys = (KeySet *) malloc(sizeof(KeySet) * nrows);
+		if (!global_idx || !keys)
+		{
+			SC_set_error(s->stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for the bookmarks.", func);
+			ret = SQL_ERROR;
+		}
+		for (irow = 0; SQL_ERROR != ret && irow < nrows; irow++)
+		{
+			pg_bm = SC_Resolve_bookmark(s->opts, (Int4) irow);
+			QR_get_last_bookmark(res, (Int4) irow, &pg_bm.keys);
+			global_idx[irow] = pg_bm.index;
+			keys[irow] = pg_bm.keys;
+		}
+		if (SQL_ERROR == ret)
+			;
+		else if (SQL_UPDATE_BY_BOOKMARK == s->operation)
+			ret = SC_pos_update_rows(s->stmt, nrows, global_idx, keys, &processed);
+		else
+			ret = SC_pos_delete_rows(s->stmt, nrows, global_idx, keys, &processed);
+		if (global_idx)
+			free(global_idx);
+		if (keys)
+			free(keys);
+	}
+	/* don't pretend the rows the failed statements didn't reach were done */
+	s->idx = SQL_ERROR == ret ? processed : (int) nrows;
+	s->processed = processed;
+	return ret;
+}
+
 static
 RETCODE	bulk_ope_callback(RETCODE retcode, void *para)
 {
@@ -2546,6 +2612,8 @@ RETCODE	bulk_ope_callback(RETCODE retcode, void *para)
 	}
 	s->need_data_callback = FALSE;
 	res = SC_get_Curres(s->stmt);
+	if (0 == s->idx && SQL_ERROR != ret)
+		ret = bulk_ope_rows(s, res);
 	for (; SQL_ERROR != ret && s->idx < s->opts->size_of_rowset; s->idx++)
 	{
 		if (SQL_ADD != s->operation)
@@ -317,6 +317,11 @@ enum {
 	,SQL_ATTR_PGOPT_MSJET = 65549
 	,SQL_ATTR_PGOPT_BATCHSIZE = 65550
 	,SQL_ATTR_PGOPT_IGNORETIMEOUT = 65551
+	,SQL_ATTR_PGOPT_REFRESH_COLUMN_INFO = 65552	/* set only */
+};
+/* Driver-specific statement attributes, for SQLGetStmtAttr() */
+enum {
+	SQL_ATTR_PGOPT_ARROW_BATCH = 65600	/* PG_ARROW_BATCH, see arrow.h */
 };
 RETCODE SQL_API PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			SQLINTEGER Attribute, PTR Value,
@@ -45,9 +45,12 @@
 #define PG_TYPE_MONEY			790
 #define PG_TYPE_MACADDR			829
 #define PG_TYPE_INET			869
+#define PG_TYPE_INT4ARRAY		1007
 #define PG_TYPE_TEXTARRAY		1009
+#define PG_TYPE_TIDARRAY		1010
 #define PG_TYPE_BPCHARARRAY		1014
 #define PG_TYPE_VARCHARARRAY		1015
+#define PG_TYPE_OIDARRAY		1028
 #define PG_TYPE_BPCHAR			1042
 #define PG_TYPE_VARCHAR			1043
 #define PG_TYPE_DATE			1082
@@ -520,6 +520,7 @@ typedef struct ParameterImplClass_ ParameterImplClass;
 typedef struct ColumnInfoClass_ ColumnInfoClass;
 typedef struct EnvironmentClass_ EnvironmentClass;
 typedef struct TupleField_ TupleField;
+typedef struct ColumnPlan_ ColumnPlan;
 typedef struct KeySet_ KeySet;
 typedef struct Rollback_ Rollback;
 typedef struct ARDFields_ ARDFields;
@@ -528,6 +529,7 @@ typedef struct IRDFields_ IRDFields;
 typedef struct IPDFields_ IPDFields;
 
 typedef struct col_info COL_INFO;
+typedef struct prepared_info PREPARED_INFO;
 typedef struct lo_arg LO_ARG;
 
 typedef struct QResultHold_struct {
@@ -638,6 +640,7 @@ typedef struct StatementOptions_
 	void			*bookmark_ptr;
 	SQLUINTEGER		metadata_id;
 	SQLULEN			stmt_timeout;
+	SQLUINTEGER		async_enable;
 } StatementOptions;
 
 /*	Used to pass extra query info to send_query */
@@ -721,6 +724,8 @@ typedef struct
 	char		pqopt_in_str;
 	pgNAME		conn_settings;
 	pgNAME		pqopt;
+	pgNAME		pool_reset_command;
+	pgNAME		spill_directory;
 	signed char	allow_keyset;
 	signed char	updatable_cursors;
 	signed char	lf_conversion;
@@ -743,10 +748,27 @@ typedef struct
 	signed char	optional_errors;
 	signed char	ignore_timeout;
 	signed char	fetch_refcursors;
+	signed char	pipeline_batch;
+	signed char	binary_results;
+	signed char	copy_insert;
+	signed char	copy_stream;
+	signed char	pool_health_check;
+	signed char	borrow_result_values;
 	UInt4		extra_opts;
 	Int4		keepalive_idle;
 	Int4		keepalive_interval;
 	Int4		batch_size;
+	Int4		prepared_cache_size;
+	Int4		conn_pool_size;
+	Int4		pool_idle_timeout;
+	Int4		fetch_read_ahead;
+	Int4		fetch_target_bytes;
+	Int4		fetch_target_time;
+	Int4		fetch_min_rows;
+	Int4		fetch_max_rows;
+	Int4		spill_threshold;
+	Int4		describe_cache_size;
+	Int4		col_info_cache_size;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	signed char	xa_opt;
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
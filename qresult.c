@@ -18,6 +18,7 @@
 
 #include "qresult.h"
 #include "statement.h"
+#include "convert.h"
 
 #include <libpq-fe.h>
 
@@ -25,12 +26,431 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#include <stddef.h>
+#include <errno.h>
+#ifndef	WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif /* WIN32 */
 
 #include "secure_sscanf.h"
 
 static BOOL QR_prepare_for_tupledata(QResultClass *self);
 static BOOL QR_read_tuples_from_pgres(QResultClass *, PGresult **pgres);
 
+#define	TUPLE_ARENA_BLOCK_SIZE	(64 * 1024)
+#define	TUPLE_ARENA_ALIGN(s)	(((s) + 7) & ~((size_t) 7))
+
+/*
+ *	Allocate size bytes for a field value from the tuple arena.
+ *	Values larger than a quarter of a block get a block of their own
+ *	so that they don't waste the rest of the current block.
+ */
+static void *
+QR_arena_alloc(QResultClass *self, size_t size)
+{
+	TupleArenaBlock	*block = self->tuple_arena;
+	size_t		bsize;
+	void		*ret;
+
+	size = TUPLE_ARENA_ALIGN(size);
+	if (NULL != block && block->size - block->used >= size)
+	{
+		ret = block->data + block->used;
+		block->used += size;
+		return ret;
+	}
+	bsize = size > TUPLE_ARENA_BLOCK_SIZE / 4 ? size : TUPLE_ARENA_BLOCK_SIZE;
+	if (block = (TupleArenaBlock *) malloc(offsetof(TupleArenaBlock, data) + bsize), NULL == block)
+		return NULL;
+	block->size = bsize;
+	block->used = size;
+	if (bsize > size || NULL == self->tuple_arena)
+	{
+		/* the new block becomes the current one */
+		block->next = self->tuple_arena;
+		self->tuple_arena = block;
+	}
+	else
+	{
+		/* keep on using the current block */
+		block->next = self->tuple_arena->next;
+		self->tuple_arena->next = block;
+	}
+	return block->data;
+}
+
+/*
+ *	The tuple cache may also borrow the values of a PGresult which holds
+ *	many rows instead of copying them. The PGresult is then kept until
+ *	the tuple cache is cleared.
+ *
+ *	Make room for one more PGresult to hold. Returns FALSE if the values
+ *	have to be copied.
+ */
+static BOOL
+QR_reserve_held_pgres(QResultClass *self)
+{
+	PGresult	**held;
+	UInt4		alloc;
+
+	if (self->held_count < self->held_alloc)
+		return TRUE;
+	alloc = self->held_alloc > 0 ? self->held_alloc * 2 : 8;
+	if (held = (PGresult **) realloc(self->held_pgres, sizeof(PGresult *) * alloc), NULL == held)
+		return FALSE;
+	self->held_pgres = held;
+	self->held_alloc = alloc;
+	return TRUE;
+}
+
+#define	QR_holds_pgres(self, pgres) \
+	((self)->held_count > 0 && (pgres) == (self)->held_pgres[(self)->held_count - 1])
+
+static void
+QR_hold_pgres(QResultClass *self, PGresult *pgres)
+{
+	if (QR_holds_pgres(self, pgres))
+		return;
+	self->held_pgres[self->held_count++] = pgres;
+}
+
+/*
+ *	Release the tuple arena and the held PGresults. When keep_one is TRUE,
+ *	a regular block is kept and emptied for the next group of rows.
+ */
+static void
+QR_free_tuple_arena(QResultClass *self, BOOL keep_one)
+{
+	TupleArenaBlock	*block, *next, *kept = NULL;
+	UInt4		i;
+
+	for (i = 0; i < self->held_count; i++)
+		PQclear(self->held_pgres[i]);
+	self->held_count = 0;
+	if (!keep_one && NULL != self->held_pgres)
+	{
+		free(self->held_pgres);
+		self->held_pgres = NULL;
+		self->held_alloc = 0;
+	}
+
+	for (block = self->tuple_arena; NULL != block; block = next)
+	{
+		next = block->next;
+		if (keep_one && NULL == kept &&
+		    TUPLE_ARENA_BLOCK_SIZE == block->size)
+		{
+			kept = block;
+			continue;
+		}
+		free(block);
+	}
+	if (NULL != kept)
+	{
+		kept->next = NULL;
+		kept->used = 0;
+	}
+	self->tuple_arena = kept;
+}
+
+/*
+ *	Spilling the rows of a result to a temporary file.
+ *
+ *	The values of a row are written one after another, each as its length
+ *	(TUPLE_SPILL_NULL for a NULL value) followed by the bytes and a
+ *	terminating '\0'. Once the file is mapped, the values paged in point
+ *	into the mapping like those borrowed from a PGresult.
+ */
+#define	TUPLE_SPILL_NULL	((UInt4) -1)
+
+static BOOL
+QR_spill_flush(TupleSpill *spill)
+{
+	const char	*buf = spill->wbuf;
+	size_t		left = spill->wbuf_used;
+
+	while (left > 0)
+	{
+#ifdef	WIN32
+		DWORD	written;
+
+		if (!WriteFile(spill->file, buf, (DWORD) left, &written, NULL))
+			return FALSE;
+#else
+		ssize_t	written;
+
+		if (written = write(spill->fd, buf, left), written < 0)
+		{
+			if (EINTR == errno)
+				continue;
+			return FALSE;
+		}
+#endif /* WIN32 */
+		buf += written;
+		left -= written;
+	}
+	spill->wbuf_used = 0;
+	return TRUE;
+}
+
+static BOOL
+QR_spill_write(TupleSpill *spill, const void *data, size_t len)
+{
+	const char	*src = (const char *) data;
+	size_t		wlen;
+
+	spill->file_size += len;
+	while (len > 0)
+	{
+		if (spill->wbuf_used == sizeof(spill->wbuf) &&
+		    !QR_spill_flush(spill))
+			return FALSE;
+		wlen = sizeof(spill->wbuf) - spill->wbuf_used;
+		if (wlen > len)
+			wlen = len;
+		memcpy(spill->wbuf + spill->wbuf_used, src, wlen);
+		spill->wbuf_used += wlen;
+		src += wlen;
+		len -= wlen;
+	}
+	return TRUE;
+}
+
+static void
+QR_free_spill(QResultClass *self)
+{
+	TupleSpill	*spill = self->spill;
+
+	if (NULL == spill)
+		return;
+#ifdef	WIN32
+	if (NULL != spill->map)
+		UnmapViewOfFile(spill->map);
+	if (NULL != spill->mapping)
+		CloseHandle(spill->mapping);
+	if (INVALID_HANDLE_VALUE != spill->file)
+		CloseHandle(spill->file);
+#else
+	if (NULL != spill->map)
+		munmap(spill->map, spill->file_size);
+	if (spill->fd >= 0)
+		close(spill->fd);
+#endif /* WIN32 */
+	free(spill->blocks);
+	free(spill);
+	self->spill = NULL;
+}
+
+/*
+ *	Create the temporary file. It is deleted as soon as it is closed.
+ */
+static BOOL
+QR_create_spill(QResultClass *self, const ConnInfo *ci)
+{
+	TupleSpill	*spill;
+	const char	*dir = NULL;
+
+	if (spill = (TupleSpill *) malloc(sizeof(TupleSpill)), NULL == spill)
+		return FALSE;
+	memset(spill, 0, offsetof(TupleSpill, wbuf));
+	if (NAME_IS_VALID(ci->spill_directory))
+		dir = GET_NAME(ci->spill_directory);
+#ifdef	WIN32
+	{
+		char	tmpdir[MAX_PATH + 1], path[MAX_PATH + 1];
+
+		spill->mapping = NULL;
+		spill->file = INVALID_HANDLE_VALUE;
+		if (NULL == dir)
+		{
+			if (0 == GetTempPath(sizeof(tmpdir), tmpdir))
+				STRCPY_FIXED(tmpdir, ".");
+			dir = tmpdir;
+		}
+		if (0 != GetTempFileName(dir, "pgs", 0, path))
+			spill->file = CreateFile(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+		if (INVALID_HANDLE_VALUE == spill->file)
+		{
+			MYLOG(0, "couldn't create a spill file in %s\n", dir);
+			free(spill);
+			return FALSE;
+		}
+	}
+#else
+	{
+		char	path[MAXPGPATH];
+
+		if (NULL == dir && NULL == (dir = getenv("TMPDIR")))
+			dir = "/tmp";
+		SPRINTF_FIXED(path, "%s/psqlodbc_spill_XXXXXX", dir);
+		if (spill->fd = mkstemp(path), spill->fd < 0)
+		{
+			MYLOG(0, "couldn't create a spill file %s errno=%d\n", path, errno);
+			free(spill);
+			return FALSE;
+		}
+		unlink(path);
+	}
+#endif /* WIN32 */
+	spill->win_bytes = self->bytes_read;
+	self->spill = spill;
+	MYLOG(0, "spilling the rows of %p to a temporary file\n", self);
+	return TRUE;
+}
+
+/*
+ *	Write the rows in backend_tuples to the file as a new block and
+ *	release their memory.
+ */
+static BOOL
+QR_spill_rows(QResultClass *self)
+{
+	TupleSpill	*spill = self->spill;
+	TupleSpillBlock	*block;
+	TupleField	*tuple = self->backend_tuples;
+	SQLULEN		num_rows = self->num_cached_rows - spill->win_start, i;
+	int		num_fields = self->num_fields;
+	UInt4		len;
+
+	if (0 == num_rows)
+		return TRUE;
+	if (spill->num_blocks >= spill->alloc_blocks)
+	{
+		UInt4	alloc = spill->alloc_blocks > 0 ? spill->alloc_blocks * 2 : 16;
+
+		if (block = (TupleSpillBlock *) realloc(spill->blocks, sizeof(TupleSpillBlock) * alloc), NULL == block)
+			return FALSE;
+		spill->blocks = block;
+		spill->alloc_blocks = alloc;
+	}
+	block = spill->blocks + spill->num_blocks;
+	block->first_row = spill->win_start;
+	block->num_rows = num_rows;
+	block->offset = spill->file_size;
+	for (i = 0; i < num_rows * num_fields; i++, tuple++)
+	{
+		if (NULL == tuple->value)
+		{
+			len = TUPLE_SPILL_NULL;
+			if (!QR_spill_write(spill, &len, sizeof(len)))
+				return FALSE;
+			continue;
+		}
+		len = tuple->len;
+		if (!QR_spill_write(spill, &len, sizeof(len)) ||
+		    !QR_spill_write(spill, tuple->value, len + 1))
+			return FALSE;
+	}
+	if (!QR_spill_flush(spill))
+		return FALSE;
+	spill->num_blocks++;
+
+	ClearCachedRows(self->backend_tuples, num_fields, num_rows);
+	QR_free_tuple_arena(self, TRUE);
+	spill->win_start = self->num_cached_rows;
+	spill->win_bytes = self->bytes_read;
+	MYLOG(DETAIL_LOG_LEVEL, "spilled " FORMAT_ULEN " rows, file size=" FORMAT_SIZE_T "\n", num_rows, spill->file_size);
+	return TRUE;
+}
+
+/*
+ *	Write the last rows and map the file, called when all the rows have
+ *	been read. The mapping is copy-on-write because the conversions may
+ *	modify the values in place e.g. set_client_decimal_point().
+ */
+static BOOL
+QR_finish_spill(QResultClass *self)
+{
+	TupleSpill	*spill = self->spill;
+
+	if (!QR_spill_rows(self))
+		return FALSE;
+	QR_free_tuple_arena(self, FALSE);
+	spill->win_rows = 0;
+	if (0 == spill->file_size)
+		return TRUE;
+#ifdef	WIN32
+	if (spill->mapping = CreateFileMapping(spill->file, NULL, PAGE_WRITECOPY, 0, 0, NULL), NULL == spill->mapping)
+		return FALSE;
+	if (spill->map = (char *) MapViewOfFile(spill->mapping, FILE_MAP_COPY, 0, 0, 0), NULL == spill->map)
+		return FALSE;
+#else
+	spill->map = (char *) mmap(NULL, spill->file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, spill->fd, 0);
+	if (MAP_FAILED == spill->map)
+	{
+		spill->map = NULL;
+		return FALSE;
+	}
+#endif /* WIN32 */
+	return TRUE;
+}
+
+/*
+ *	Returns the fields of the tupleno-th row of a spilled result, paging
+ *	in the block of the row if necessary. The pointer is valid until a
+ *	row of another block is requested, the values as long as the result.
+ */
+TupleField *
+QR_get_spilled_tuple(const QResultClass *self, SQLULEN tupleno)
+{
+	TupleSpill	*spill = self->spill;
+	TupleSpillBlock	*block;
+	TupleField	*tuple;
+	const char	*p;
+	UInt4		lo, hi, mid, len;
+	SQLULEN		i;
+
+	/* still reading the rows or already paged in */
+	if (NULL == spill->map ||
+	    (tupleno >= spill->win_start && tupleno < spill->win_start + spill->win_rows))
+		return self->backend_tuples + (tupleno - spill->win_start) * self->num_fields;
+
+	/* the last block starting at or before tupleno */
+	lo = 0;
+	hi = spill->num_blocks;
+	while (hi - lo > 1)
+	{
+		mid = (lo + hi) / 2;
+		if (spill->blocks[mid].first_row <= tupleno)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	block = spill->blocks + lo;
+	if (0 == spill->num_blocks ||
+	    tupleno < block->first_row ||
+	    tupleno >= block->first_row + block->num_rows)
+	{
+		MYLOG(0, "row " FORMAT_ULEN " isn't in the spill file\n", tupleno);
+		return self->backend_tuples;
+	}
+
+	MYLOG(DETAIL_LOG_LEVEL, "paging in " FORMAT_ULEN " rows from " FORMAT_ULEN "\n", block->num_rows, block->first_row);
+	p = spill->map + block->offset;
+	tuple = self->backend_tuples;
+	for (i = 0; i < block->num_rows * self->num_fields; i++, tuple++)
+	{
+		memcpy(&len, p, sizeof(len));
+		p += sizeof(len);
+		if (TUPLE_SPILL_NULL == len)
+		{
+			tuple->len = 0;
+			tuple->borrowed = FALSE;
+			tuple->value = NULL;
+			continue;
+		}
+		tuple->len = len;
+		tuple->borrowed = TRUE;
+		tuple->value = (void *) p;
+		p += len + 1;
+	}
+	spill->win_start = block->first_row;
+	spill->win_rows = block->num_rows;
+
+	return self->backend_tuples + (tupleno - spill->win_start) * self->num_fields;
+}
+
 /*
  *	Used for building a Manual Result only
  *	All info functions call this function to create the manual result set.
@@ -201,6 +621,17 @@ QR_Constructor(void)
 		}
 		QR_set_fields(rv, fields);
 		rv->backend_tuples = NULL;
+		rv->tuple_arena = NULL;
+		rv->held_pgres = NULL;
+		rv->held_count = 0;
+		rv->held_alloc = 0;
+		rv->read_ahead_size = 0;
+		rv->read_ahead_pgres = NULL;
+		rv->bytes_read = 0;
+		rv->rows_read = 0;
+		rv->adaptive_fetch_size = 0;
+		rv->fetch_msec = 0;
+		rv->spill = NULL;
 		rv->sqlstate[0] = '\0';
 		rv->message = NULL;
 		rv->messageref = NULL;
@@ -215,6 +646,7 @@ QR_Constructor(void)
 		rv->num_cached_keys = 0;
 		rv->fetch_number = 0;
 		rv->flags = 0; /* must be cleared before calling QR_set_rowstart_in_cache() */
+		rv->copy_stream = COPY_STREAM_NONE;
 		QR_set_rowstart_in_cache(rv, -1);
 		rv->key_base = -1;
 		rv->recent_processed_row_count = -1;
@@ -274,6 +706,9 @@ QR_close_result(QResultClass *self, BOOL destroy)
 		 */
 		if ((conn = QR_get_conn(self)) && conn->pqconn)
 		{
+			/* the COPY stream must be stopped even out of transactions */
+			if (conn->copy_stream_res == self)
+				QR_end_copy_stream(self);
 			if (CC_is_in_trans(conn) || QR_is_withhold(self))
 			{
 				if (!QR_close(self))	/* close the cursor if there is one */
@@ -339,6 +774,7 @@ QR_reset_for_re_execute(QResultClass *self)
 	QR_close_result(self, FALSE);
 	/* reset flags etc */
 	self->flags = 0;
+	self->copy_stream = COPY_STREAM_NONE;
 	QR_set_rowstart_in_cache(self, -1);
 	self->recent_processed_row_count = -1;
 	/* clear error info etc */
@@ -490,6 +926,13 @@ QR_free_memory(QResultClass *self)
 
 	MYLOG(0, "entering fcount=" FORMAT_LEN "\n", num_backend_rows);
 
+	if (QR_is_spilled(self))
+	{
+		TupleSpill	*spill = self->spill;
+
+		/* only a block of the rows is in backend_tuples */
+		num_backend_rows = NULL != spill->map ? spill->win_rows : num_backend_rows - spill->win_start;
+	}
 	if (self->backend_tuples)
 	{
 		ClearCachedRows(self->backend_tuples, num_fields, num_backend_rows);
@@ -499,6 +942,16 @@ QR_free_memory(QResultClass *self)
 		self->dataFilled = FALSE;
 		self->tupleField = NULL;
 	}
+	QR_free_tuple_arena(self, FALSE);
+	QR_free_spill(self);
+	if (NULL != self->conn && self->conn->read_ahead_res == self)
+		CC_complete_read_ahead(self->conn);
+	if (self->read_ahead_pgres)
+	{
+		PQclear(self->read_ahead_pgres);
+		self->read_ahead_pgres = NULL;
+	}
+	self->read_ahead_size = 0;
 	if (self->keyset)
 	{
 		ConnectionClass	*conn = QR_get_conn(self);
@@ -647,6 +1100,10 @@ QR_from_PGresult(QResultClass *self, StatementClass *stmt, ConnectionClass *conn
 		QLOG(0, "\tfieldname='%s', adtid=%d, adtsize=%d, atttypmod=%d (rel,att)=(%d,%d)\n", new_field_name, new_adtid, new_adtsize, new_atttypmod, new_relid, new_attid);
 
 		CI_set_field_info(QR_get_fields(self), lf, new_field_name, new_adtid, new_adtsize, new_atttypmod, new_relid, new_attid);
+		/* binary values of character types are the same as the text ones */
+		if (0 != PQfformat(*pgres, lf) &&
+		    BINRES_DECODE == binary_result_handling(new_adtid))
+			CI_get_format(QR_get_fields(self), lf) = 1;
 
 		QR_set_rstatus(self, PORES_FIELDS_OK);
 		self->num_fields = CI_get_num_fields(QR_get_fields(self));
@@ -681,7 +1138,11 @@ MYLOG(DETAIL_LOG_LEVEL, "[%d].PGType %u->%u\n", i, PIC_get_pgtype(ipdopts->param
 	/* Then, get the data itself */
 	num_cached_rows = self->num_cached_rows;
 	if (!QR_read_tuples_from_pgres(self, pgres))
+	{
+		if (QR_holds_pgres(self, *pgres))
+			*pgres = NULL;
 		return FALSE;
+	}
 
 MYLOG(DETAIL_LOG_LEVEL, "!!%p->cursTup=" FORMAT_LEN " total_read=" FORMAT_ULEN "\n", self, self->cursTuple, self->num_total_read);
 	if (!QR_once_reached_eof(self) && self->cursTuple >= (Int4) self->num_total_read)
@@ -712,6 +1173,9 @@ MYLOG(DETAIL_LOG_LEVEL, "!!%p->cursTup=" FORMAT_LEN " total_read=" FORMAT_ULEN "
 	QR_set_cursor(self, cursor);
 	if (NULL == cursor)
 		QR_set_reached_eof(self);
+	/* the tuple cache owns the PGresult now */
+	if (QR_holds_pgres(self, *pgres))
+		*pgres = NULL;
 	return TRUE;
 }
 
@@ -739,7 +1203,12 @@ QR_close(QResultClass *self)
 	conn = QR_get_conn(self);
 	if (self && QR_get_cursor(self))
 	{
-		if (CC_is_in_error_trans(conn))
+		if (QR_is_copy_stream(self))
+		{
+			/* no server-side cursor, just stop reading the COPY data */
+			QR_end_copy_stream(self);
+		}
+		else if (CC_is_in_error_trans(conn))
 		{
 			if (QR_is_withhold(self))
 				CC_mark_a_object_to_discard(conn, 'p', QR_get_cursor(self));
@@ -817,6 +1286,10 @@ QR_prepare_for_tupledata(QResultClass *self)
 	BOOL	haskeyset = QR_haskeyset(self);
 	SQLULEN num_total_rows = QR_get_num_total_tuples(self);
 
+	/* backend_tuples holds the rows not spilled yet */
+	if (QR_is_spilled(self))
+		num_total_rows -= self->spill->win_start;
+
 MYLOG(DETAIL_LOG_LEVEL, "entering %p->num_fields=%d\n", self, self->num_fields);
 	if (!QR_get_cursor(self))
 	{
@@ -906,6 +1379,160 @@ static SQLLEN enlargeKeyCache(QResultClass *self, SQLLEN add_size, const char *m
 	return alloc;
 }
 
+/*
+ *	Read-ahead of the next FETCH for declare/fetch cursors.
+ *
+ *	Once the application has read FetchReadAhead percent of the tuple
+ *	cache, the FETCH of the next group of rows is sent without waiting
+ *	for its result. When the cache runs out, QR_next_tuple() takes the
+ *	rows from that result instead of sending another FETCH. Anything
+ *	else sent on the connection meanwhile finishes the FETCH first (see
+ *	CC_complete_read_ahead()).
+ */
+static void
+QR_send_read_ahead(QResultClass *self, StatementClass *stmt, Int4 fetch_size)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	char		fetch[128];
+
+	if (NULL != conn->read_ahead_res ||
+	    NULL != conn->copy_stream_res ||
+	    NULL != conn->async_stmt ||
+	    0 != conn->internal_op)
+		return;
+	if (!CC_is_in_trans(conn) || CC_is_in_error_trans(conn))
+		return;
+	/* CC_send_query() would issue a SAVEPOINT before this FETCH */
+	if (SC_is_rb_stmt(SC_get_ancestor(stmt)) &&
+	    0 == (conn->opt_previous & SVPOPT_RDONLY))
+		return;
+	SPRINTF_FIXED(fetch,
+			 "fetch %d in \"%s\"",
+			 fetch_size, QR_get_cursor(self));
+	QLOG(0, "PQsendQuery: %p '%s'\n", conn->pqconn, fetch);
+	if (!PQsendQuery(conn->pqconn, fetch))
+	{
+		MYLOG(0, "couldn't send the read-ahead fetch: %s\n", PQerrorMessage(conn->pqconn));
+		return;
+	}
+	self->read_ahead_size = fetch_size;
+	conn->read_ahead_res = self;
+}
+
+/*
+ *	Read the rows of the FETCH sent ahead into the tuple cache.
+ */
+static BOOL
+QR_receive_read_ahead(QResultClass *self, StatementClass *stmt)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	PGresult	*pgres;
+	BOOL		ret = FALSE;
+
+	if (conn->read_ahead_res == self)
+		CC_complete_read_ahead(conn);
+	pgres = self->read_ahead_pgres;
+	self->read_ahead_pgres = NULL;
+	self->cmd_fetch_size = self->read_ahead_size;
+	self->read_ahead_size = 0;
+	/* the FETCH wasn't waited for, see QR_adaptive_fetch_size() */
+	self->fetch_msec = 0;
+	if (NULL == pgres)
+	{
+		QR_set_rstatus(self, PORES_FATAL_ERROR);
+		QR_set_message(self, "The connection was lost while reading ahead.");
+		return FALSE;
+	}
+	switch (PQresultStatus(pgres))
+	{
+		case PGRES_TUPLES_OK:
+			ret = QR_from_PGresult(self, stmt, NULL, QR_get_cursor(self), &pgres);
+			break;
+		default:
+			handle_pgres_error(conn, pgres, "read_ahead", self, TRUE);
+			break;
+	}
+	if (pgres)
+		PQclear(pgres);
+	return ret;
+}
+
+/*
+ *	Throw away the rows of the FETCH sent ahead, they are skipped by the
+ *	cursor movement. Returns the number of the rows.
+ */
+static SQLLEN
+QR_discard_read_ahead(QResultClass *self)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	SQLLEN		passed = 0;
+
+	if (conn->read_ahead_res == self)
+		CC_complete_read_ahead(conn);
+	if (PGRES_TUPLES_OK == PQresultStatus(self->read_ahead_pgres))
+	{
+		passed = PQntuples(self->read_ahead_pgres);
+		self->cursTuple += passed;
+		if (self->cursTuple >= (SQLLEN) self->num_total_read)
+			self->num_total_read = self->cursTuple + 1;
+		if (passed < self->read_ahead_size)
+		{
+			QR_set_reached_eof(self);
+			self->cursTuple = self->num_total_read;
+		}
+	}
+	if (self->read_ahead_pgres)
+	{
+		PQclear(self->read_ahead_pgres);
+		self->read_ahead_pgres = NULL;
+	}
+	self->read_ahead_size = 0;
+	return passed;
+}
+
+/*
+ *	The number of rows to FETCH next when FetchTargetBytes is set.
+ *
+ *	The first block has FetchMinRows rows and the following ones double
+ *	in size, as long as a block stays within FetchTargetBytes judging
+ *	from the average width of the rows read so far. When the last FETCH
+ *	took longer than FetchTargetTime, the block shrinks in proportion.
+ *	Only the FETCHes waited for are timed: the rows read ahead arrive while
+ *	the application processes the previous block, so FetchTargetTime is
+ *	ignored as long as the blocks are read ahead.
+ */
+static Int4
+QR_adaptive_fetch_size(const QResultClass *self, const ConnInfo *ci)
+{
+	SQLLEN	prev_size, fetch_size, limit;
+
+	prev_size = self->adaptive_fetch_size;
+	if (prev_size <= 0)
+		prev_size = self->cmd_fetch_size;
+	fetch_size = prev_size * 2;
+	if (self->rows_read > 0)
+	{
+		limit = ci->fetch_target_bytes / (self->bytes_read / self->rows_read + 1);
+		if (fetch_size > limit)
+			fetch_size = limit;
+	}
+	if (0 < ci->fetch_target_time &&
+	    self->fetch_msec > (UInt4) ci->fetch_target_time)
+	{
+		limit = prev_size * ci->fetch_target_time / self->fetch_msec;
+		if (fetch_size > limit)
+			fetch_size = limit;
+	}
+	if (0 < ci->fetch_max_rows && fetch_size > ci->fetch_max_rows)
+		fetch_size = ci->fetch_max_rows;
+	if (fetch_size < ci->fetch_min_rows)
+		fetch_size = ci->fetch_min_rows;
+	if (fetch_size <= 0)
+		fetch_size = 1;
+
+	return (Int4) fetch_size;
+}
+
 SQLLEN	QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt)
 {
 	char		movecmd[64];
@@ -915,6 +1542,8 @@ SQLLEN	QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt)
 
 	if (!QR_get_cursor(self))
 		return 0;
+	if (0 < self->read_ahead_size)
+		QR_discard_read_ahead(self);
 	if (QR_once_reached_eof(self) &&
 	    self->cursTuple >= self->num_total_read)
 		return 0;
@@ -958,6 +1587,7 @@ QR_next_tuple(QResultClass *self, StatementClass *stmt)
 	Int4		num_fields = self->num_fields, fetch_size, req_size;
 	SQLLEN		offset = 0, end_tuple;
 	char		boundary_adjusted = FALSE;
+	UInt4		fetch_start;
 	TupleField *the_tuples = self->backend_tuples;
 	QResultClass	*res;
 
@@ -977,7 +1607,15 @@ MYLOG(DETAIL_LOG_LEVEL, "in total_read=" FORMAT_ULEN " cursT=" FORMAT_LEN " curr
 	req_size = QR_get_reqsize(self);
 	/* Determine the optimum cache size.  */
 	ci = &(conn->connInfo);
-	fetch_size = ci->drivers.fetch_max;
+	if (CC_adaptive_fetch(conn))
+	{
+		fetch_size = QR_adaptive_fetch_size(self, ci);
+		/* whole rowsets, so that the rowset boundaries match the blocks */
+		if (req_size > 1)
+			fetch_size = (fetch_size + req_size - 1) / req_size * req_size;
+	}
+	else
+		fetch_size = ci->drivers.fetch_max;
 	if ((Int4)req_size > fetch_size)
 		fetch_size = req_size;
 	if (QR_once_reached_eof(self) && self->cursTuple >= (Int4) QR_get_num_total_read(self))
@@ -991,6 +1629,28 @@ MYLOG(DETAIL_LOG_LEVEL, "in total_read=" FORMAT_ULEN " cursT=" FORMAT_LEN " curr
 		QResultClass	*mres = NULL;
 		SQLULEN		movement, moved;
 
+		if (QR_is_copy_stream(self))
+		{
+			SC_set_error(stmt, STMT_EXEC_ERROR, "rows read through COPY can't be scrolled", func);
+			RETURN(-1)
+		}
+		if (0 < self->read_ahead_size)
+		{
+			/* the server's cursor is already past the rows read ahead */
+			SQLLEN	passed = QR_discard_read_ahead(self);
+
+			if (QR_is_moving_backward(self))
+				self->move_offset += passed;
+			else if (QR_is_moving_forward(self))
+			{
+				if (self->move_offset <= passed)
+				{
+					SC_set_error(stmt, STMT_EXEC_ERROR, "rows read ahead can't be scrolled", func);
+					RETURN(-1)
+				}
+				self->move_offset -= passed;
+			}
+		}
 		movement = self->move_offset;
 		if (QR_is_moving_backward(self))
 		{
@@ -1083,6 +1743,17 @@ MYLOG(DETAIL_LOG_LEVEL, "moved=" FORMAT_ULEN " ? " FORMAT_ULEN "\n", moved, move
 MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 		/* move to next row */
 		QR_inc_next_in_cache(self);
+		/* send the next FETCH once the watermark is passed */
+		if (0 < ci->fetch_read_ahead &&
+		    0 == self->read_ahead_size &&
+		    NULL != QR_get_cursor(self) &&
+		    !QR_is_copy_stream(self) &&
+		    !QR_haskeyset(self) &&
+		    SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type &&
+		    !QR_once_reached_eof(self) &&
+		    req_size > 0 && 0 == fetch_size % req_size &&
+		    (fetch_number + 1) * 100 >= num_backend_rows * ci->fetch_read_ahead)
+			QR_send_read_ahead(self, stmt, fetch_size);
 		RETURN(TRUE)
 	}
 	else if (QR_once_reached_eof(self))
@@ -1115,6 +1786,9 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 		QR_set_reached_eof(self);
 		RETURN(-1)		/* end of tuples */
 	}
+	/* the rows read ahead are the next group */
+	if (0 < self->read_ahead_size)
+		fetch_size = self->read_ahead_size;
 
 	if (QR_get_rowstart_in_cache(self) >= num_backend_rows ||
 		QR_is_moving(self))
@@ -1123,9 +1797,11 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 
 		/* not a correction */
 		self->cache_size = fetch_size;
+		self->adaptive_fetch_size = fetch_size;
 		/* clear obsolete tuples */
 MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_rows);
 		ClearCachedRows(tuple, num_fields, num_backend_rows);
+		QR_free_tuple_arena(self, TRUE);
 		self->dataFilled = FALSE;
 		QR_stop_movement(self);
 		self->move_offset = 0;
@@ -1145,6 +1821,9 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 			MYLOG(0, "corrupted fetch_size end_tuple=" FORMAT_LEN " <= cached_rows=" FORMAT_LEN "\n", end_tuple, num_backend_rows);
 			RETURN(-1)
 		}
+		/* all the rows read ahead are appended */
+		if (0 < self->read_ahead_size)
+			fetch_size = self->read_ahead_size;
 		/* and enlarge the cache size */
 		self->cache_size += fetch_size;
 		offset = self->fetch_number;
@@ -1155,12 +1834,6 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 	if (enlargeKeyCache(self, self->cache_size - num_backend_rows, "Out of memory while reading tuples") < 0)
 		RETURN(FALSE)
 
-	/* Send a FETCH command to get more rows */
-	SPRINTF_FIXED(fetch,
-			 "fetch %d in \"%s\"",
-			 fetch_size, QR_get_cursor(self));
-
-	MYLOG(0, "sending actual fetch (%d) query '%s'\n", fetch_size, fetch);
 	if (!boundary_adjusted)
 	{
 		QR_set_num_cached_rows(self, 0);
@@ -1168,17 +1841,52 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 	}
 	num_rows_in = self->num_cached_rows;
 
-	/* don't read ahead for the next tuple (self) ! */
-	qi.row_size = self->cache_size;
-	qi.fetch_size = fetch_size;
-	qi.result_in = self;
-	qi.cursor = NULL;
-	res = CC_send_query(conn, fetch, &qi, READ_ONLY_QUERY, stmt);
-	if (!QR_command_maybe_successful(res))
+	if (QR_is_copy_stream(self))
 	{
-		if (!QR_get_message(self))
-			QR_set_message(self, "Error fetching next group.");
-		RETURN(FALSE)
+		/* read the next group from the COPY data instead of FETCH */
+		MYLOG(0, "reading (%d) rows from the COPY stream\n", fetch_size);
+		if (conn->copy_stream_res != self ||
+		    QR_read_copy_rows(self, fetch_size) < 0)
+		{
+			if (!QR_get_message(self))
+				QR_set_message(self, "The COPY stream was interrupted.");
+			QR_set_rstatus(self, PORES_FATAL_ERROR);
+			RETURN(FALSE)
+		}
+	}
+	else if (0 < self->read_ahead_size)
+	{
+		MYLOG(0, "reading (%d) rows read ahead\n", fetch_size);
+		if (!QR_receive_read_ahead(self, stmt))
+		{
+			if (!QR_get_message(self))
+				QR_set_message(self, "Error fetching next group.");
+			RETURN(FALSE)
+		}
+	}
+	else
+	{
+		/* Send a FETCH command to get more rows */
+		SPRINTF_FIXED(fetch,
+				 "fetch %d in \"%s\"",
+				 fetch_size, QR_get_cursor(self));
+
+		MYLOG(0, "sending actual fetch (%d) query '%s'\n", fetch_size, fetch);
+
+		/* don't read ahead for the next tuple (self) ! */
+		qi.row_size = self->cache_size;
+		qi.fetch_size = fetch_size;
+		qi.result_in = self;
+		qi.cursor = NULL;
+		fetch_start = get_msec();
+		res = CC_send_query(conn, fetch, &qi, READ_ONLY_QUERY, stmt);
+		self->fetch_msec = get_msec() - fetch_start;
+		if (!QR_command_maybe_successful(res))
+		{
+			if (!QR_get_message(self))
+				QR_set_message(self, "Error fetching next group.");
+			RETURN(FALSE)
+		}
 	}
 	cur_fetch = 0;
 
@@ -1322,13 +2030,20 @@ MYLOG(DETAIL_LOG_LEVEL, "returning %d offset=" FORMAT_LEN "\n", ret, offset);
  * Read tuples from a libpq PGresult object into QResultClass.
  *
  * The result status of the passed-in PGresult should be either
- * PGRES_TUPLES_OK, or PGRES_SINGLE_TUPLE. If it's PGRES_SINGLE_TUPLE,
- * this function will call PQgetResult() to read all the available tuples.
+ * PGRES_TUPLES_OK, PGRES_SINGLE_TUPLE or PGRES_TUPLES_CHUNK. If it's
+ * PGRES_SINGLE_TUPLE or PGRES_TUPLES_CHUNK, this function will call
+ * PQgetResult() to read all the available tuples.
+ *
+ * With BorrowResultValues, the values of a PGresult holding many rows
+ * are not copied. The tuple cache points into the PGresult and holds it
+ * instead. If the passed-in PGresult is held, the caller must not
+ * PQclear() it.
  */
 static BOOL
 QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
 {
 	Int2		field_lf;
+	BOOL		borrow;
 	int			len;
 	char	   *value;
 	char	   *buffer;
@@ -1341,10 +2056,17 @@ QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
 	int			nrows;
 	int			resStatus;
 	int		numTotalRows = 0;
+	ConnectionClass	*conn = QR_get_conn(self);
+	size_t		spill_threshold = 0;
 
 	/* set the current row to read the fields into */
 	effective_cols = QR_NumPublicResultCols(self);
 
+	/* spill the rows which don't need to be updated in place */
+	if (NULL != conn && 0 < conn->connInfo.spill_threshold &&
+	    !QR_get_cursor(self) && !QR_haskeyset(self) && num_fields > 0)
+		spill_threshold = (size_t) conn->connInfo.spill_threshold * 1024;
+
 	flds = QR_get_fields(self);
 
 nextrow:
@@ -1355,6 +2077,9 @@ nextrow:
 			QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(*pgres));
 			break;
 		case PGRES_SINGLE_TUPLE:
+#ifdef	LIBPQ_HAS_CHUNK_MODE
+		case PGRES_TUPLES_CHUNK:
+#endif /* LIBPQ_HAS_CHUNK_MODE */
 			break;
 
 		case PGRES_NONFATAL_ERROR:
@@ -1368,6 +2093,14 @@ nextrow:
 
 	nrows = PQntuples(*pgres);
 	numTotalRows += nrows;
+	/*
+	 * A held PGresult is kept whole, the rows already read included, until
+	 * the tuple cache is cleared. A PGresult per row costs more than
+	 * copying the values.
+	 */
+	borrow = (NULL != conn && conn->connInfo.borrow_result_values &&
+			  PGRES_SINGLE_TUPLE != resStatus && nrows > 0 &&
+			  QR_reserve_held_pgres(self));
 
 	for (rowno = 0; rowno < nrows; rowno++)
 	{
@@ -1378,6 +2111,8 @@ nextrow:
 			return FALSE;
 
 		this_tuplefield = self->backend_tuples + (self->num_cached_rows * num_fields);
+		if (QR_is_spilled(self))
+			this_tuplefield -= self->spill->win_start * num_fields;
 		if (QR_haskeyset(self))
 		{
 			/* this_keyset = self->keyset + self->cursTuple + 1; */
@@ -1395,6 +2130,7 @@ nextrow:
 			if (isnull)
 			{
 				this_tuplefield[field_lf].len = 0;
+				this_tuplefield[field_lf].borrowed = FALSE;
 				this_tuplefield[field_lf].value = 0;
 				QPRINTF(TUPLE_LOG_LEVEL, " (null)");
 				continue;
@@ -1405,12 +2141,20 @@ nextrow:
 				value = PQgetvalue(*pgres, rowno, field_lf);
 				if (field_lf >= effective_cols)
 					buffer = tidoidbuf;
-				else
+				else if (borrow)
+					buffer = value;
+				else if (buffer = (char *) QR_arena_alloc(self, len + 1), NULL == buffer)
+				{
+					QR_set_rstatus(self, PORES_NO_MEMORY_ERROR);
+					QR_free_memory(self);
+					QR_set_messageref(self, "Out of memory in allocating item buffer.");
+					return FALSE;
+				}
+				if (buffer != value)
 				{
-					QR_MALLOC_return_with_error(buffer, char, len + 1, self, "Out of memory in allocating item buffer.", FALSE);
+					memcpy(buffer, value, len);
+					buffer[len] = '\0';
 				}
-				memcpy(buffer, value, len);
-				buffer[len] = '\0';
 
 				QPRINTF(TUPLE_LOG_LEVEL, " '%s'(%d)", buffer, len);
 
@@ -1423,6 +2167,8 @@ nextrow:
 						QR_set_rstatus(self, PORES_INTERNAL_ERROR);
 						SPRINTF_FIXED(emsg, "Internal Error -- this_keyset == NULL ci_num_fields=%d effective_cols=%d", ci_num_fields, effective_cols);
 						QR_set_message(self, emsg);
+						if (borrow)
+							QR_hold_pgres(self, *pgres);
 						return FALSE;
 					}
 					int status = 0;
@@ -1436,7 +2182,9 @@ nextrow:
 				else
 				{
 					this_tuplefield[field_lf].len = len;
+					this_tuplefield[field_lf].borrowed = TRUE;
 					this_tuplefield[field_lf].value = buffer;
+					self->bytes_read += len + 1;
 
 					/*
 					 * This can be used to set the longest length of the column
@@ -1447,12 +2195,15 @@ nextrow:
 					 * row!
 					 */
 
-					if (flds && flds->coli_array && CI_get_display_size(flds, field_lf) < len)
+					if (flds && flds->coli_array && CI_get_display_size(flds, field_lf) < len &&
+					    0 == CI_get_format(flds, field_lf))
 						CI_get_display_size(flds, field_lf) = len;
 				}
 			}
 		}
 		QPRINTF(TUPLE_LOG_LEVEL, "\n");
+		self->bytes_read += num_fields * sizeof(TupleField);
+		self->rows_read++;
 		self->cursTuple++;
 		if (self->num_fields > 0)
 		{
@@ -1463,12 +2214,40 @@ nextrow:
 
 		if (self->cursTuple >= self->num_total_read)
 			self->num_total_read = self->cursTuple + 1;
+
+		if (spill_threshold > 0 &&
+		    self->bytes_read - (QR_is_spilled(self) ? self->spill->win_bytes : 0) > spill_threshold)
+		{
+			if ((!QR_is_spilled(self) && !QR_create_spill(self, &conn->connInfo)) ||
+			    !QR_spill_rows(self))
+			{
+				QR_set_rstatus(self, PORES_FATAL_ERROR);
+				QR_set_message(self, "Could not write the rows to the spill file.");
+				if (borrow)
+					QR_hold_pgres(self, *pgres);
+				return FALSE;
+			}
+		}
 	}
 
-	if (resStatus == PGRES_SINGLE_TUPLE)
+	if (QR_is_spilled(self) && PGRES_TUPLES_OK == resStatus)
 	{
-		/* Process next row */
-		PQclear(*pgres);
+		/* all the rows are read, nothing points into the PGresult */
+		if (!QR_finish_spill(self))
+		{
+			QR_set_rstatus(self, PORES_FATAL_ERROR);
+			QR_set_message(self, "Could not write the rows to the spill file.");
+			return FALSE;
+		}
+		borrow = FALSE;
+	}
+	if (borrow)
+		QR_hold_pgres(self, *pgres);
+	if (resStatus != PGRES_TUPLES_OK)
+	{
+		/* Process next row or chunk of rows */
+		if (!borrow)
+			PQclear(*pgres);
 
 		*pgres = PQgetResult(self->conn->pqconn);
 		goto nextrow;
@@ -1483,6 +2262,332 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 	return TRUE;
 }
 
+/*
+ *	Reading rows from COPY TO STDOUT.
+ *
+ *	A COPY stream result behaves like the result of a forward-only cursor.
+ *	QR_next_tuple() doesn't send FETCH, it reads the next group of rows
+ *	from the COPY data into the same tuple cache. The memory used doesn't
+ *	depend on the number of rows. While the COPY command is in progress,
+ *	the connection remembers the result in copy_stream_res.
+ */
+static const char	copy_binary_signature[] = "PGCOPY\n\377\r\n";
+#define	COPY_BINARY_SIGNATURE_LEN	11	/* including the terminating '\0' */
+
+/*
+ * Get the cache slot for the next row.
+ */
+static TupleField *
+QR_copy_row_slot(QResultClass *self)
+{
+	TupleField	*tuple;
+
+	if (self->num_cached_rows >= self->count_backend_allocated &&
+	    enlargeKeyCache(self, 1, "Out of memory while reading COPY data") < 0)
+		return NULL;
+	tuple = self->backend_tuples + self->num_cached_rows * self->num_fields;
+	pg_memset(tuple, 0, sizeof(TupleField) * self->num_fields);
+	return tuple;
+}
+
+static void
+QR_copy_row_added(QResultClass *self)
+{
+	self->cursTuple++;
+	QR_inc_num_cache(self);
+	if (self->cursTuple >= (SQLLEN) self->num_total_read)
+		self->num_total_read = self->cursTuple + 1;
+}
+
+static void
+QR_copy_set_value(QResultClass *self, TupleField *field, int field_lf, char *buffer, int len)
+{
+	ColumnInfoClass	*flds = QR_get_fields(self);
+
+	field->len = len;
+	field->borrowed = FALSE;
+	field->value = buffer;
+	if (CI_get_display_size(flds, field_lf) < len &&
+	    0 == CI_get_format(flds, field_lf))
+		CI_get_display_size(flds, field_lf) = len;
+}
+
+/*
+ * Store a row of COPY text format data. Returns the number of the rows
+ * stored or -1 on error.
+ */
+static int
+QR_add_copy_text_row(QResultClass *self, const char *data, int len)
+{
+	int		num_fields = self->num_fields, field_lf;
+	const char	*ptr = data, *end = data + len, *fend;
+	char		*buffer, *dst;
+	TupleField	*this_tuplefield;
+
+	if (this_tuplefield = QR_copy_row_slot(self), NULL == this_tuplefield)
+		return -1;
+	if (ptr < end && '\n' == end[-1])
+		end--;
+	for (field_lf = 0; field_lf < num_fields; field_lf++)
+	{
+		if (field_lf > 0)
+		{
+			if (ptr >= end || '\t' != *ptr)
+				goto malformed;
+			ptr++;
+		}
+		if (fend = memchr(ptr, '\t', end - ptr), NULL == fend)
+			fend = end;
+		/* \N is NULL */
+		if (2 == fend - ptr && '\\' == ptr[0] && 'N' == ptr[1])
+		{
+			ptr = fend;
+			continue;
+		}
+		if (buffer = malloc(fend - ptr + 1), NULL == buffer)
+		{
+			ClearCachedRows(this_tuplefield, num_fields, 1);
+			QR_set_rstatus(self, PORES_NO_MEMORY_ERROR);
+			QR_set_message(self, "Out of memory in allocating item buffer.");
+			return -1;
+		}
+		/*
+		 * COPY TO escapes only backslashes, the delimiter and the control
+		 * characters.
+		 */
+		for (dst = buffer; ptr < fend; ptr++)
+		{
+			if ('\\' != *ptr || ptr + 1 >= fend)
+			{
+				*dst++ = *ptr;
+				continue;
+			}
+			switch (*++ptr)
+			{
+				case 'b':
+					*dst++ = '\b';
+					break;
+				case 'f':
+					*dst++ = '\f';
+					break;
+				case 'n':
+					*dst++ = '\n';
+					break;
+				case 'r':
+					*dst++ = '\r';
+					break;
+				case 't':
+					*dst++ = '\t';
+					break;
+				case 'v':
+					*dst++ = '\v';
+					break;
+				default:
+					*dst++ = *ptr;
+					break;
+			}
+		}
+		*dst = '\0';
+		QR_copy_set_value(self, this_tuplefield + field_lf, field_lf, buffer, (int) (dst - buffer));
+	}
+	if (ptr != end)
+		goto malformed;
+	QR_copy_row_added(self);
+	return 1;
+
+malformed:
+	ClearCachedRows(this_tuplefield, num_fields, 1);
+	QR_set_rstatus(self, PORES_BAD_RESPONSE);
+	QR_set_message(self, "Unexpected number of columns in COPY data");
+	return -1;
+}
+
+/*
+ * Store the rows of a message of COPY binary format data. The first one
+ * begins with the file header, the last one is the file trailer.
+ * Returns the number of the rows stored or -1 on error.
+ */
+static int
+QR_add_copy_binary_rows(QResultClass *self, const char *data, int len)
+{
+	int		num_fields = self->num_fields, field_lf, nrows = 0;
+	const char	*ptr = data, *end = data + len;
+	char		*buffer;
+	Int4		flen;
+	Int2		nfields;
+	TupleField	*this_tuplefield = NULL;
+
+	if (0 == (self->pstatus & FQR_COPY_HEADER_READ))
+	{
+		/* signature, flags and header extension area length */
+		if (len < COPY_BINARY_SIGNATURE_LEN + 8 ||
+		    0 != memcmp(ptr, copy_binary_signature, COPY_BINARY_SIGNATURE_LEN))
+			goto malformed;
+		ptr += COPY_BINARY_SIGNATURE_LEN + 4;
+		flen = (Int4) binary_get_uint32(ptr);
+		ptr += 4;
+		if (flen < 0 || end - ptr < flen)
+			goto malformed;
+		ptr += flen;
+		self->pstatus |= FQR_COPY_HEADER_READ;
+	}
+	while (ptr < end)
+	{
+		if (end - ptr < 2)
+			goto malformed;
+		nfields = (Int2) binary_get_uint16(ptr);
+		ptr += 2;
+		if (-1 == nfields)	/* file trailer */
+			break;
+		if (nfields != num_fields)
+			goto malformed;
+		if (this_tuplefield = QR_copy_row_slot(self), NULL == this_tuplefield)
+			return -1;
+		for (field_lf = 0; field_lf < num_fields; field_lf++)
+		{
+			if (end - ptr < 4)
+				goto malformed;
+			flen = (Int4) binary_get_uint32(ptr);
+			ptr += 4;
+			if (flen < 0)	/* NULL */
+				continue;
+			if (end - ptr < flen)
+				goto malformed;
+			if (buffer = malloc(flen + 1), NULL == buffer)
+			{
+				ClearCachedRows(this_tuplefield, num_fields, 1);
+				QR_set_rstatus(self, PORES_NO_MEMORY_ERROR);
+				QR_set_message(self, "Out of memory in allocating item buffer.");
+				return -1;
+			}
+			memcpy(buffer, ptr, flen);
+			buffer[flen] = '\0';
+			ptr += flen;
+			QR_copy_set_value(self, this_tuplefield + field_lf, field_lf, buffer, flen);
+		}
+		QR_copy_row_added(self);
+		this_tuplefield = NULL;
+		nrows++;
+	}
+	return nrows;
+
+malformed:
+	if (this_tuplefield)
+		ClearCachedRows(this_tuplefield, num_fields, 1);
+	QR_set_rstatus(self, PORES_BAD_RESPONSE);
+	QR_set_message(self, "Malformed COPY binary data");
+	return -1;
+}
+
+/*
+ * Read the rows of the COPY stream into the tuple cache.
+ *
+ * At most max_rows rows are read (all the rest if max_rows < 0). Returns
+ * the number of the rows read or -1 on error. When the COPY data ends,
+ * the COPY command is completed and the connection can be used for the
+ * other commands again.
+ */
+SQLLEN
+QR_read_copy_rows(QResultClass *self, SQLLEN max_rows)
+{
+	CSTR	func = "QR_read_copy_rows";
+	ConnectionClass	*conn = QR_get_conn(self);
+	PGresult	*pgres;
+	char		*buf;
+	int		len, nrows;
+	SQLLEN		num_read = 0;
+	BOOL		failed = FALSE;
+
+	if (NULL == conn || conn->copy_stream_res != self)
+		return 0;
+	if (NULL == conn->pqconn)
+	{
+		conn->copy_stream_res = NULL;
+		QR_set_rstatus(self, PORES_FATAL_ERROR);
+		QR_set_message(self, "The connection has been lost");
+		return -1;
+	}
+	while (max_rows < 0 || num_read < max_rows)
+	{
+		if (len = PQgetCopyData(conn->pqconn, &buf, 0), len < 0)
+			break;
+		if (COPY_STREAM_BINARY == self->copy_stream)
+			nrows = QR_add_copy_binary_rows(self, buf, len);
+		else
+			nrows = QR_add_copy_text_row(self, buf, len);
+		PQfreemem(buf);
+		if (nrows < 0)
+		{
+			conn->copy_stream_res = NULL;
+			CC_abort_copy(conn);
+			return -1;
+		}
+		num_read += nrows;
+	}
+	MYLOG(0, "read " FORMAT_LEN " rows from the COPY stream\n", num_read);
+	if (max_rows >= 0 && num_read >= max_rows)
+		return num_read;
+
+	/* the end of the COPY data, get the command status */
+	conn->copy_stream_res = NULL;
+	while (pgres = PQgetResult(conn->pqconn), NULL != pgres)
+	{
+		switch (PQresultStatus(pgres))
+		{
+			case PGRES_COMMAND_OK:
+				QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+				break;
+			case PGRES_NONFATAL_ERROR:
+				handle_pgres_error(conn, pgres, func, self, FALSE);
+				break;
+			default:
+				handle_pgres_error(conn, pgres, func, self, TRUE);
+				failed = TRUE;
+				break;
+		}
+		PQclear(pgres);
+	}
+	if (failed)
+		return -1;
+	QR_set_reached_eof(self);
+	if (self->cursTuple < (SQLLEN) self->num_total_read)
+		self->cursTuple = self->num_total_read;
+
+	return num_read;
+}
+
+/*
+ * Stop reading the COPY stream before its end.
+ */
+void
+QR_end_copy_stream(QResultClass *self)
+{
+	ConnectionClass	*conn = QR_get_conn(self);
+	PGresult	*pgres;
+	char		*buf;
+
+	if (NULL == conn || conn->copy_stream_res != self)
+		return;
+	conn->copy_stream_res = NULL;
+	if (NULL == conn->pqconn)
+		return;
+	MYLOG(0, "stopping the COPY stream of %p\n", self);
+	if (CC_is_in_trans(conn))
+	{
+		/*
+		 * Cancelling the COPY would abort the transaction of the
+		 * application. Read and throw away the rest instead.
+		 */
+		while (PQgetCopyData(conn->pqconn, &buf, 0) >= 0)
+			PQfreemem(buf);
+		while (pgres = PQgetResult(conn->pqconn), NULL != pgres)
+			PQclear(pgres);
+	}
+	else
+		CC_abort_copy(conn);
+	QR_set_reached_eof(self);
+}
+
 int
 QR_search_by_fieldname(const QResultClass *self, const char *name)
 {
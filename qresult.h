@@ -48,8 +48,66 @@ enum
 	FQR_REACHED_EOF = (1L << 1)	/* reached eof */
 	,FQR_HAS_VALID_BASE = (1L << 2)
 	,FQR_NEEDS_SURVIVAL_CHECK = (1L << 3) /* check if the cursor is open */
+	,FQR_COPY_HEADER_READ = (1L << 4) /* read the binary COPY header */
 };
 
+/* copy_stream values */
+enum
+{
+	COPY_STREAM_NONE = 0
+	,COPY_STREAM_TEXT	/* rows are read from COPY TO STDOUT in text format */
+	,COPY_STREAM_BINARY	/* rows are read from COPY TO STDOUT in binary format */
+};
+
+/*
+ *	The field values read from the backend are carved out of large blocks
+ *	instead of being malloc'ed one by one. The blocks are released all at
+ *	once when the tuple cache is cleared.
+ */
+typedef struct TupleArenaBlock_
+{
+	struct TupleArenaBlock_ *next;
+	size_t		size;		/* usable size of data */
+	size_t		used;
+	char		data[1];
+} TupleArenaBlock;
+
+/*
+ *	The rows of a result read without a cursor are written to a temporary
+ *	file once they take more than SpillThreshold in memory. Each group of
+ *	rows written at once is a block of the file. After all the rows are
+ *	read, the file is mapped into memory and backend_tuples only holds the
+ *	block paged in last, see QR_get_tuple().
+ */
+typedef struct
+{
+	SQLULEN		first_row;
+	SQLULEN		num_rows;
+	size_t		offset;		/* position in the file */
+} TupleSpillBlock;
+
+#define	TUPLE_SPILL_BUFSIZE	(64 * 1024)
+
+typedef struct
+{
+#ifdef	WIN32
+	HANDLE		file;
+	HANDLE		mapping;
+#else
+	int		fd;
+#endif /* WIN32 */
+	char		*map;		/* the file mapped after all rows are written */
+	size_t		file_size;
+	TupleSpillBlock	*blocks;
+	UInt4		num_blocks;
+	UInt4		alloc_blocks;
+	SQLULEN		win_start;	/* row number of backend_tuples[0] */
+	SQLULEN		win_rows;	/* rows paged in backend_tuples */
+	size_t		win_bytes;	/* bytes_read when the rows in memory started */
+	size_t		wbuf_used;
+	char		wbuf[TUPLE_SPILL_BUFSIZE];
+} TupleSpill;
+
 struct QResultClass_
 {
 	ColumnInfoClass *fields;	/* the Column information */
@@ -84,10 +142,22 @@ struct QResultClass_
 
 	TupleField *backend_tuples;	/* data from the backend (the tuple cache) */
 	TupleField *tupleField;		/* current backend tuple being retrieved */
+	TupleArenaBlock *tuple_arena;	/* storage of the backend_tuples values */
+	PGresult	**held_pgres;	/* PGresults the backend_tuples values point into */
+	UInt4		held_count;
+	UInt4		held_alloc;
+	Int4		read_ahead_size;	/* rows requested by the FETCH sent ahead */
+	PGresult	*read_ahead_pgres;	/* the result of the FETCH sent ahead */
+	size_t		bytes_read;	/* memory taken by the rows read so far */
+	SQLULEN		rows_read;
+	Int4		adaptive_fetch_size;	/* rows of the last adaptively sized FETCH */
+	UInt4		fetch_msec;	/* time taken by the last FETCH, 0 if read ahead */
+	TupleSpill	*spill;		/* the rows written to a temporary file */
 
 	char	pstatus;		/* processing status */
 	char	aborted;		/* was aborted ? */
 	char	flags;			/* this result contains keyset etc ? */
+	char	copy_stream;		/* COPY_STREAM_xxxx */
 	po_ind_t	move_direction;	/* must move before fetching this
 						result set */
 	SQLULEN		count_keyset_allocated; /* m(re)allocated count */
@@ -130,7 +200,10 @@ enum {
 
 /*	These functions are for retrieving data from the qresult */
 #define QR_get_value_backend(self, fieldno)	(self->tupleField[fieldno].value)
-#define QR_get_value_backend_row(self, tupleno, fieldno) ((self->backend_tuples + (tupleno * self->num_fields))[fieldno].value)
+#define QR_get_value_length(self, fieldno)	(self->tupleField[fieldno].len)
+#define QR_get_tuple(self, tupleno)	(QR_is_spilled(self) ? QR_get_spilled_tuple(self, tupleno) : self->backend_tuples + ((tupleno) * self->num_fields))
+#define QR_get_value_backend_row(self, tupleno, fieldno) (QR_get_tuple(self, tupleno)[fieldno].value)
+#define QR_get_value_length_row(self, tupleno, fieldno) (QR_get_tuple(self, tupleno)[fieldno].len)
 #define QR_get_value_backend_text(self, tupleno, fieldno) QR_get_value_backend_row(self, tupleno, fieldno)
 #define QR_get_value_backend_int(self, tupleno, fieldno, isNull) pg_atoi(QR_get_value_backend_row(self, tupleno, fieldno))
 
@@ -204,6 +277,8 @@ do { \
 #define QR_once_reached_eof(self)	((self->pstatus & FQR_REACHED_EOF) != 0)
 #define	QR_has_valid_base(self)		(0 != (self->pstatus & FQR_HAS_VALID_BASE))
 #define	QR_needs_survival_check(self)		(0 != (self->pstatus & FQR_NEEDS_SURVIVAL_CHECK))
+#define	QR_is_copy_stream(self)		(COPY_STREAM_NONE != (self)->copy_stream)
+#define	QR_is_spilled(self)		(NULL != (self)->spill)
 
 #define QR_aborted(self)		(!self || self->aborted)
 #define QR_get_reqsize(self)		(self->rowset_size_include_ommitted)
@@ -250,6 +325,9 @@ SQLLEN		getNthValid(const QResultClass *self, SQLLEN sta, UWORD orientation, SQL
 SQLLEN		QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt);
 BOOL		QR_get_last_bookmark(const QResultClass *self, Int4 index, KeySet *keyset);
 int			QR_search_by_fieldname(const QResultClass *self, const char *name);
+SQLLEN		QR_read_copy_rows(QResultClass *self, SQLLEN max_rows);
+void		QR_end_copy_stream(QResultClass *self);
+TupleField	*QR_get_spilled_tuple(const QResultClass *self, SQLULEN tupleno);
 
 #define QR_MALLOC_return_with_error(t, tp, s, a, m, r) \
 do { \
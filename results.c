@@ -958,6 +958,7 @@ PGAPI_GetData(HSTMT hstmt,
 	OID		field_type;
 	int		atttypmod;
 	void	   *value = NULL;
+	SQLLEN		valuelen = 0;
 	RETCODE		result = SQL_SUCCESS;
 	char		get_bookmark = FALSE;
 	SQLSMALLINT	target_type;
@@ -1073,6 +1074,7 @@ MYLOG(DETAIL_LOG_LEVEL, "GetData Column 0 is type %d not of type SQL_C_BOOKMARK\
 		{
 			SQLLEN	curt = GIdx2CacheIdx(stmt->currTuple, stmt, res);
 			value = QR_get_value_backend_row(res, curt, icol);
+			valuelen = QR_get_value_length_row(res, curt, icol);
 MYLOG(DETAIL_LOG_LEVEL, "currT=" FORMAT_LEN " base=" FORMAT_LEN " rowset=" FORMAT_LEN "\n", stmt->currTuple, QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt));
 			MYLOG(0, "     value = '%s'\n", NULL_IF_NULL(value));
 		}
@@ -1092,6 +1094,7 @@ MYLOG(DETAIL_LOG_LEVEL, "currT=" FORMAT_LEN " base=" FORMAT_LEN " rowset=" FORMA
 			/** value = QR_get_value_backend(res, icol); maybe thiw doesn't work */
 			SQLLEN	curt = GIdx2CacheIdx(stmt->currTuple, stmt, res);
 			value = QR_get_value_backend_row(res, curt, icol);
+			valuelen = QR_get_value_length_row(res, curt, icol);
 		}
 		MYLOG(0, "  socket: value = '%s'\n", NULL_IF_NULL(value));
 	}
@@ -1129,7 +1132,12 @@ MYLOG(DETAIL_LOG_LEVEL, "currT=" FORMAT_LEN " base=" FORMAT_LEN " rowset=" FORMA
 
 	SC_set_current_col(stmt, icol);
 
-	result = copy_and_convert_field(stmt, field_type, atttypmod, value,
+	if (CI_get_format(QR_get_fields(res), icol))
+		result = copy_and_convert_binary_field(stmt, field_type, atttypmod,
+			value, valuelen,
+			target_type, precision, rgbValue, cbValueMax, pcbValue, pcbValue);
+	else
+		result = copy_and_convert_field(stmt, field_type, atttypmod, value,
 			target_type, precision, rgbValue, cbValueMax, pcbValue, pcbValue);
 
 	switch (result)
@@ -1897,6 +1905,24 @@ MYLOG(DETAIL_LOG_LEVEL, "num_tuples=" FORMAT_LEN "\n", num_tuples);
 
 	truncated = error = FALSE;
 
+	/* Convert the rowset column by column if possible */
+	if (rowsetSize > 1)
+	{
+		BOOL	trunc;
+
+		if ((i = SC_fetch_by_column(stmt, rowsetSize, &trunc)) > 0)
+		{
+			if (rgfRowStatus)
+			{
+				for (fc_io = 0; fc_io < i; fc_io++)
+					rgfRowStatus[fc_io] = SQL_ROW_SUCCESS;
+			}
+			fc_io = i;
+			truncated = trunc;
+			goto fetched;
+		}
+	}
+
 	currp = -1;
 	stmt->bind_row = 0;		/* set the binding location */
 	result = SC_fetch(stmt);
@@ -1981,6 +2007,7 @@ MYLOG(DETAIL_LOG_LEVEL, "just skipping deleted row " FORMAT_LEN "\n", currp);
 	if (SQL_ERROR == result)
 		goto cleanup;
 
+fetched:
 	/* Save the fetch count for SQLSetPos */
 	stmt->last_fetch_count = i;
 	stmt->save_rowset_size = rowsetSize;
@@ -2187,8 +2214,7 @@ SQLLEN ClearCachedRows(TupleField *tuple, int num_fields, SQLLEN num_rows)
 		if (tuple->value)
 		{
 MYLOG(DETAIL_LOG_LEVEL, "freeing tuple[" FORMAT_LEN "][" FORMAT_LEN "].value=%p\n", i / num_fields, i % num_fields, tuple->value);
-			free(tuple->value);
-			tuple->value = NULL;
+			TUPLE_FREE_VALUE(tuple);
 		}
 		tuple->len = -1;
 	}
@@ -2201,11 +2227,7 @@ SQLLEN ReplaceCachedRows(TupleField *otuple, const TupleField *ituple, int num_f
 MYLOG(DETAIL_LOG_LEVEL, "entering %p num_fields=%d num_rows=" FORMAT_LEN "\n", otuple, num_fields, num_rows);
 	for (i = 0; i < num_fields * num_rows; i++, ituple++, otuple++)
 	{
-		if (otuple->value)
-		{
-			free(otuple->value);
-			otuple->value = NULL;
-		}
+		TUPLE_FREE_VALUE(otuple);
 		if (ituple->value)
 {
 			otuple->value = strdup(ituple->value);
@@ -2219,6 +2241,35 @@ MYLOG(DETAIL_LOG_LEVEL, "[" FORMAT_LEN "," FORMAT_LEN "] %s copied\n", i / num_f
 	return i;
 }
 
+/*
+ *	Move the value of ituple to (the empty) otuple.
+ *	A value borrowed from ituple's result (its tuple arena or PGresult)
+ *	can't be taken over because it is released together with the result.
+ *	Copy it.
+ */
+static void
+MoveTupleValue(TupleField *otuple, TupleField *ituple)
+{
+	otuple->value = ituple->value;
+	otuple->borrowed = FALSE;
+	otuple->len = ituple->len;
+	if (ituple->value && ituple->borrowed)
+	{
+		size_t	vlen = ituple->len > 0 ? ituple->len : 0;
+
+		if (NULL != (otuple->value = malloc(vlen + 1)))
+		{
+			memcpy(otuple->value, ituple->value, vlen);
+			((char *) otuple->value)[vlen] = '\0';
+		}
+		else
+			otuple->len = -1;
+	}
+	ituple->value = NULL;
+	ituple->borrowed = FALSE;
+	ituple->len = -1;
+}
+
 static
 int MoveCachedRows(TupleField *otuple, TupleField *ituple, Int2 num_fields, SQLLEN num_rows)
 {
@@ -2227,19 +2278,12 @@ int MoveCachedRows(TupleField *otuple, TupleField *ituple, Int2 num_fields, SQLL
 MYLOG(DETAIL_LOG_LEVEL, "entering %p num_fields=%d num_rows=" FORMAT_LEN "\n", otuple, num_fields, num_rows);
 	for (i = 0; i < num_fields * num_rows; i++, ituple++, otuple++)
 	{
+		TUPLE_FREE_VALUE(otuple);
+		MoveTupleValue(otuple, ituple);
 		if (otuple->value)
 		{
-			free(otuple->value);
-			otuple->value = NULL;
-		}
-		if (ituple->value)
-		{
-			otuple->value = ituple->value;
-			ituple->value = NULL;
 MYLOG(DETAIL_LOG_LEVEL, "[%d,%d] %s copied\n", i / num_fields, i % num_fields, (const char *) otuple->value);
 		}
-		otuple->len = ituple->len;
-		ituple->len = -1;
 	}
 	return i;
 }
@@ -3383,304 +3427,267 @@ SC_pos_reload(StatementClass *stmt, SQLULEN global_ridx, UInt2 *count, Int4 logK
 }
 
 static	const int	pre_fetch_count = 32;
-static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, int rows_per_fetch, SQLLEN limitrow)
+/*
+ *	The keys of the rows to load are sent in binary as the tid[] (and
+ *	oid[] for the inheritance tables) parameters of the load statement.
+ */
+typedef struct
 {
-	CSTR	func = "LoadFromKeyset";
-	ConnectionClass	*conn = SC_get_conn(stmt);
-	SQLLEN	i;
-	int	j, rowc, rcnt = 0;
 	OID	oid;
 	UInt4	blocknum;
-	SQLLEN	kres_ridx;
 	UInt2	offset;
-	PQExpBufferData	qval = {0};
-	int	keys_per_fetch = 10;
+	SQLLEN	pos;	/* the row index of the caller */
+} ReloadKey;
 
-#define	return	DONT_CALL_RETURN_FROM_HERE???
-	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res), rowc = 0;; i++, kres_ridx++)
+static int
+reload_key_cmp(const void *a, const void *b)
+{
+	const ReloadKey	*ka = (const ReloadKey *) a, *kb = (const ReloadKey *) b;
+
+	if (ka->oid != kb->oid)
+		return ka->oid < kb->oid ? -1 : 1;
+	if (ka->blocknum != kb->blocknum)
+		return ka->blocknum < kb->blocknum ? -1 : 1;
+	if (ka->offset != kb->offset)
+		return ka->offset < kb->offset ? -1 : 1;
+	return 0;
+}
+
+static void
+set_reload_key(ReloadKey *key, const KeySet *keyset, SQLLEN pos)
+{
+	key->oid = keyset->oid;
+	key->blocknum = keyset->blocknum;
+	key->offset = keyset->offset;
+	key->pos = pos;
+}
+
+static char *
+put_uint4(char *p, UInt4 val)
+{
+	*p++ = (char) (val >> 24);
+	*p++ = (char) (val >> 16);
+	*p++ = (char) (val >> 8);
+	*p++ = (char) val;
+	return p;
+}
+
+/*
+ *	Make a one-dimensional array without NULLs in binary format from
+ *	the tids or the oids of the keys.
+ */
+static char *
+make_key_array(const ReloadKey *keys, SQLLEN nkeys, OID elemtype, int *length)
+{
+	size_t	elemlen = (PG_TYPE_TID == elemtype ? 6 : 4);
+	char	*array, *p;
+	SQLLEN	i;
+
+	if (NULL == (array = malloc(5 * 4 + (4 + elemlen) * nkeys)))
+		return NULL;
+	p = put_uint4(array, 1);	/* ndim */
+	p = put_uint4(p, 0);		/* has no NULLs */
+	p = put_uint4(p, elemtype);
+	p = put_uint4(p, (UInt4) nkeys);	/* dimension */
+	p = put_uint4(p, 1);		/* lower bound */
+	for (i = 0; i < nkeys; i++)
 	{
-		if (i >= limitrow)
+		p = put_uint4(p, (UInt4) elemlen);
+		if (PG_TYPE_TID == elemtype)
 		{
-			if (!rowc)
-				break;
-			if (res->reload_count > 0)
-			{
-				for (j = rowc; j < keys_per_fetch; j++)
-				{
-					appendPQExpBufferStr(&qval, j ? ",NULL" : "NULL");
-				}
-			}
-			rowc = -1; /* end of loop */
+			p = put_uint4(p, keys[i].blocknum);
+			*p++ = (char) (keys[i].offset >> 8);
+			*p++ = (char) keys[i].offset;
 		}
-		if (rowc < 0 || rowc >= keys_per_fetch)
-		{
-			QResultClass	*qres;
+		else
+			p = put_uint4(p, keys[i].oid);
+	}
+	*length = (int) (p - array);
+	return array;
+}
 
-			appendPQExpBufferStr(&qval, ")");
-			if (PQExpBufferDataBroken(qval))
-			{
-				rcnt = -1;
-				SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
-				goto cleanup;
-			}
-			qres = CC_send_query(conn, qval.data, NULL, CREATE_KEYSET | READ_ONLY_QUERY, stmt);
-			if (QR_command_maybe_successful(qres))
-			{
-				SQLLEN		j, k, l;
-				Int2		m;
-				TupleField	*tuple, *tuplew;
-				UInt4		bln;
-				UInt2		off;
+/*
+ *	Execute plan_name with the tid[] and the oid[] (if add_oids) made
+ *	from the keys. If query is not NULL, it's prepared as plan_name
+ *	first.
+ */
+static QResultClass *
+exec_with_keys(StatementClass *stmt, const char *plan_name, const char *query, const ReloadKey *keys, SQLLEN nkeys, OID key_type, UDWORD flag)
+{
+	CSTR	func = "exec_with_keys";
+	QResultClass	*qres = NULL;
+	const Oid	paramTypes[2] = {PG_TYPE_TIDARRAY, PG_TYPE_INT4 == key_type ? PG_TYPE_INT4ARRAY : PG_TYPE_OIDARRAY};
+	const char	*paramValues[2] = {NULL, NULL};
+	int		paramLengths[2] = {0, 0};
+	const int	paramFormats[2] = {1, 1};
+
+	paramValues[0] = make_key_array(keys, nkeys, PG_TYPE_TID, paramLengths);
+	if (0 != key_type)
+		paramValues[1] = make_key_array(keys, nkeys, key_type, paramLengths + 1);
+	if (NULL == paramValues[0] || (0 != key_type && NULL == paramValues[1]))
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for the key arrays", func);
+	else
+		qres = CC_exec_prepared(SC_get_conn(stmt), plan_name, query, 0 != key_type ? 2 : 1, paramTypes, paramValues, paramLengths, paramFormats, flag, stmt);
+	if (paramValues[0])
+		free((char *) paramValues[0]);
+	if (paramValues[1])
+		free((char *) paramValues[1]);
+	return qres;
+}
 
-				for (j = 0; j < QR_get_num_total_read(qres); j++)
-				{
-					oid = getOid(qres, j);
-					getTid(qres, j, &blocknum, &offset);
-					for (k = SC_get_rowset_start(stmt); k < limitrow; k++)
-					{
-						getTid(res, k, &bln, &off);
-						if (oid == getOid(res, k) &&
-						    bln == blocknum &&
-						    off == offset)
-						{
-							l = GIdx2CacheIdx(k, stmt, res);
-							tuple = res->backend_tuples + res->num_fields * l;
-							tuplew = qres->backend_tuples + qres->num_fields * j;
-							for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
-							{
-								if (tuple->len > 0 && tuple->value)
-									free(tuple->value);
-								tuple->value = tuplew->value;
-								tuple->len = tuplew->len;
-								tuplew->value = NULL;
-								tuplew->len = -1;
-							}
-							res->keyset[k].status &= ~CURS_NEEDS_REREAD;
-							break;
-						}
-					}
-				}
-			}
-			else
-			{
-				SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", func);
-				rcnt = -1;
-				QR_Destructor(qres);
-				break;
-			}
-			QR_Destructor(qres);
-			if (rowc < 0)
-				break;
-			rowc = 0;
-		}
-		if (!rowc)
-		{
-			if (PQExpBufferDataBroken(qval))
-			{
-				initPQExpBuffer(&qval);
+/*
+ *	Load the rows identified by the keys with the load statement.
+ *	With prepared NULL, the statement is parsed as the unnamed one.
+ *	Otherwise it is prepared as plan_name unless *prepared is TRUE, and
+ *	*prepared is set once the PREPARE has succeeded even if the execution
+ *	fails.
+ */
+static QResultClass *
+load_by_keys(StatementClass *stmt, const char *plan_name, BOOL *prepared, const ReloadKey *keys, SQLLEN nkeys)
+{
+	CSTR	func = "load_by_keys";
+	BOOL	inh = TI_has_subclass(stmt->ti[0]);
+	PQExpBufferData	qval = {0};
+	QResultClass	*qres = NULL;
 
-				if (res->reload_count > 0)
-					keys_per_fetch = res->reload_count;
-				else
-				{
-					char	planname[32];
-					int	j;
-					QResultClass	*qres;
+	if (NULL != prepared && *prepared)
+		return exec_with_keys(stmt, plan_name, NULL, keys, nkeys, inh ? PG_TYPE_OID : 0, CREATE_KEYSET | READ_ONLY_QUERY);
 
-					if (rows_per_fetch >= pre_fetch_count * 2)
-						keys_per_fetch = pre_fetch_count;
-					else
-						keys_per_fetch = rows_per_fetch;
-					if (!keys_per_fetch)
-						keys_per_fetch = 2;
-					SPRINTF_FIXED(planname, "_KEYSET_%p", res);
-					printfPQExpBuffer(&qval, "PREPARE \"%s\"", planname);
-					for (j = 0; j < keys_per_fetch; j++)
-					{
-						appendPQExpBufferStr(&qval, j ? ",tid" : "(tid");
-					}
-					appendPQExpBuffer(&qval, ") as %s where ctid in ", stmt->load_statement);
-					for (j = 0; j < keys_per_fetch; j++)
-					{
-						if (j == 0)
-							appendPQExpBufferStr(&qval, "($1");
-						else
-							appendPQExpBuffer(&qval, ",$%d", j + 1);
-					}
-					appendPQExpBufferStr(&qval, ")");
-					if (PQExpBufferDataBroken(qval))
-					{
-						rcnt = -1;
-						SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
-						goto cleanup;
-					}
-					qres = CC_send_query(conn, qval.data, NULL, READ_ONLY_QUERY, stmt);
-					if (QR_command_maybe_successful(qres))
-					{
-						res->reload_count = keys_per_fetch;
-					}
-					else
-					{
-						SC_set_error(stmt, STMT_EXEC_ERROR, "Prepare for Data Load Error", func);
-						rcnt = -1;
-						SC_set_Result(stmt, qres);
-						break;
-					}
-					QR_Destructor(qres);
-				}
-			}
-			if (res->reload_count > 0)
-			{
-				printfPQExpBuffer(&qval, "EXECUTE \"_KEYSET_%p\"(", res);
-			}
-			else
-			{
-				printfPQExpBuffer(&qval, "%s where ctid in (", stmt->load_statement);
-			}
-		}
-		if (rcnt >= 0 &&
-		    0 != (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
-		{
-			getTid(res, kres_ridx, &blocknum, &offset);
-			if (rowc)
-				appendPQExpBuffer(&qval, ",'(%u,%u)'", blocknum, offset);
-			else
-				appendPQExpBuffer(&qval, "'(%u,%u)'", blocknum, offset);
-			rowc++;
-			rcnt++;
-		}
+	initPQExpBuffer(&qval);
+	if (NULL != prepared)
+		printfPQExpBuffer(&qval, "PREPARE \"%s\"(tid[]%s) as ", plan_name, inh ? ", oid[]" : "");
+	appendPQExpBuffer(&qval, "%s where ctid = any($1::tid[])", stmt->load_statement);
+	if (inh)
+		appendPQExpBufferStr(&qval, " and tableoid = any($2::oid[])");
+	if (PQExpBufferDataBroken(qval))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in load_by_keys()", func);
+		return NULL;
 	}
-cleanup:
-#undef	return
-	if (!PQExpBufferDataBroken(qval))
+	if (NULL == prepared)
+	{
+		qres = exec_with_keys(stmt, plan_name, qval.data, keys, nkeys, inh ? PG_TYPE_OID : 0, CREATE_KEYSET | READ_ONLY_QUERY);
 		termPQExpBuffer(&qval);
-	return rcnt;
+		return qres;
+	}
+
+	/* PREPARE on its own, so that a failure is told from the execution's */
+	qres = CC_send_query(SC_get_conn(stmt), qval.data, NULL, READ_ONLY_QUERY, stmt);
+	termPQExpBuffer(&qval);
+	if (!QR_command_maybe_successful(qres))
+	{
+		SC_set_error(stmt, STMT_EXEC_ERROR, "Prepare for Data Load Error", func);
+		return qres;
+	}
+	QR_Destructor(qres);
+	*prepared = TRUE;
+	return exec_with_keys(stmt, plan_name, NULL, keys, nkeys, inh ? PG_TYPE_OID : 0, CREATE_KEYSET | READ_ONLY_QUERY);
 }
 
-static SQLLEN LoadFromKeyset_inh(StatementClass *stmt, QResultClass * res, int rows_per_fetch, SQLLEN limitrow)
+/*
+ *	Sort the keys of the loaded rows so that find_loaded_row() can
+ *	search them.
+ */
+static ReloadKey *
+sort_loaded_rows(const QResultClass *qres)
 {
-	ConnectionClass	*conn = SC_get_conn(stmt);
-	SQLLEN	i;
-	int	j, rowc, rcnt = 0;
-	OID	oid, new_oid;
-	UInt4	blocknum;
-	SQLLEN	kres_ridx;
-	UInt2	offset;
-	PQExpBufferData	qval = {0};
-	int	keys_per_fetch = 10;
-	const char *load_stmt = stmt->load_statement;
-	const ssize_t	from_pos = stmt->load_from_pos;
+	SQLLEN	nrows = QR_get_num_total_read(qres), j;
+	ReloadKey	*keys;
+
+	if (NULL == (keys = (ReloadKey *) malloc(sizeof(ReloadKey) * (nrows > 0 ? nrows : 1))))
+		return NULL;
+	for (j = 0; j < nrows; j++)
+		set_reload_key(keys + j, qres->keyset + j, j);
+	qsort(keys, nrows, sizeof(ReloadKey), reload_key_cmp);
+	return keys;
+}
+
+/*
+ *	The index of the loaded row with the keys or -1 if not found.
+ */
+static SQLLEN
+find_loaded_row(const QResultClass *qres, const ReloadKey *sorted, const KeySet *keyset)
+{
+	ReloadKey	key;
+	const ReloadKey	*found;
+
+	set_reload_key(&key, keyset, -1);
+	if (NULL == (found = bsearch(&key, sorted, QR_get_num_total_read(qres), sizeof(ReloadKey), reload_key_cmp)))
+		return -1;
+	return found->pos;
+}
 
-MYLOG(0, "entering in rows_per_fetch=%d limitrow=" FORMAT_LEN "\n", rows_per_fetch, limitrow);
-	new_oid = 0;
+static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, SQLLEN limitrow)
+{
+	CSTR	func = "LoadFromKeyset";
+	SQLLEN	i, kres_ridx, rcnt = 0, j;
+	Int2	m;
+	ReloadKey	*keys = NULL, *found;
+	char	planname[32];
+	BOOL	prepared;
+	QResultClass	*qres = NULL;
+	TupleField	*tuple, *tuplew;
+
+MYLOG(0, "entering limitrow=" FORMAT_LEN "\n", limitrow);
 #define	return	DONT_CALL_RETURN_FROM_HERE???
-	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res), rowc = 0, oid = 0;; i++, kres_ridx++)
+	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res); i < limitrow; i++, kres_ridx++)
 	{
-		if (i >= limitrow)
-		{
-			if (!rowc)
-				break;
-			rowc = -1; /* end of loop */
-		}
-		else if (0 == (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
-			continue;
-		else
-			new_oid = getOid(res, kres_ridx);
-		if (rowc < 0 ||
-		    rowc >= keys_per_fetch ||
-		    (oid != 0 &&
-		     new_oid != oid))
-		{
-			QResultClass	*qres;
+		if (0 != (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
+			rcnt++;
+	}
+	if (0 == rcnt)
+		goto cleanup;
+	if (NULL == (keys = (ReloadKey *) malloc(sizeof(ReloadKey) * rcnt)))
+	{
+		rcnt = -1;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+		goto cleanup;
+	}
+	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res), j = 0; i < limitrow; i++, kres_ridx++)
+	{
+		if (0 != (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
+			set_reload_key(keys + j++, res->keyset + kres_ridx, i);
+	}
 
-			appendPQExpBufferStr(&qval, ")");
-			if (PQExpBufferDataBroken(qval))
-			{
-				rcnt = -1;
-				SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset_inh()", __FUNCTION__);
-				goto cleanup;
-			}
-			qres = CC_send_query(conn, qval.data, NULL, CREATE_KEYSET | READ_ONLY_QUERY, stmt);
-			if (QR_command_maybe_successful(qres))
-			{
-				SQLLEN		k, l;
-				Int2		m;
-				TupleField	*tuple, *tuplew;
-				UInt4		bln;
-				UInt2		off;
-				OID		tbloid;
-
-				for (j = 0; j < QR_get_num_total_read(qres); j++)
-				{
-					tbloid = getOid(qres, j);
-					getTid(qres, j, &blocknum, &offset);
-					for (k = SC_get_rowset_start(stmt); k < limitrow; k++)
-					{
-						getTid(res, k, &bln, &off);
-						if (tbloid == getOid(res, k) &&
-						    bln == blocknum &&
-						    off == offset)
-						{
-							l = GIdx2CacheIdx(k, stmt, res);
-							tuple = res->backend_tuples + res->num_fields * l;
-							tuplew = qres->backend_tuples + qres->num_fields * j;
-							for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
-							{
-								if (tuple->len > 0 && tuple->value)
-									free(tuple->value);
-								tuple->value = tuplew->value;
-								tuple->len = tuplew->len;
-								tuplew->value = NULL;
-								tuplew->len = -1;
-							}
-							res->keyset[k].status &= ~CURS_NEEDS_REREAD;
-							break;
-						}
-					}
-				}
-			}
-			else
-			{
-				SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", __FUNCTION__);
-				rcnt = -1;
-				SC_set_Result(stmt, qres);
-				break;
-			}
-			QR_Destructor(qres);
-			if (rowc < 0)
-				break;
-			rowc = 0;
-		}
-		if (!rowc)
-		{
-			char table_fqn[256];
+	/* The statement is prepared once per result and deallocated by QR_free_memory() */
+	SPRINTF_FIXED(planname, "_KEYSET_%p", res);
+	prepared = (res->reload_count > 0);
+	qres = load_by_keys(stmt, planname, &prepared, keys, rcnt);
+	/* let QR_free_memory() deallocate it even if the execution fails */
+	if (prepared)
+		res->reload_count = 1;
+	if (!QR_command_maybe_successful(qres))
+	{
+		if (0 == SC_get_errornumber(stmt))
+			SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", func);
+		rcnt = -1;
+		SC_set_Result(stmt, qres);
+		qres = NULL;
+		goto cleanup;
+	}
 
-			if (PQExpBufferDataBroken(qval))
-			{
-				if (rows_per_fetch >= pre_fetch_count * 2)
-					keys_per_fetch = pre_fetch_count;
-				else
-					keys_per_fetch = rows_per_fetch;
-				if (!keys_per_fetch)
-					keys_per_fetch = 2;
-				initPQExpBuffer(&qval);
-			}
-			printfPQExpBuffer(&qval, "%.*sfrom %s where ctid in (", (int) from_pos, load_stmt, ti_quote(stmt, new_oid, table_fqn, sizeof(table_fqn)));
+	qsort(keys, rcnt, sizeof(ReloadKey), reload_key_cmp);
+	for (j = 0; j < QR_get_num_total_read(qres); j++)
+	{
+		ReloadKey	key;
+
+		set_reload_key(&key, qres->keyset + j, j);
+		if (NULL == (found = bsearch(&key, keys, rcnt, sizeof(ReloadKey), reload_key_cmp)))
+			continue;
+		tuple = res->backend_tuples + res->num_fields * GIdx2CacheIdx(found->pos, stmt, res);
+		tuplew = qres->backend_tuples + qres->num_fields * j;
+		for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
+		{
+			TUPLE_FREE_VALUE(tuple);
+			MoveTupleValue(tuple, tuplew);
 		}
-		if (new_oid != oid)
-			oid = new_oid;
-		getTid(res, kres_ridx, &blocknum, &offset);
-		if (rowc)
-			appendPQExpBuffer(&qval, ",'(%u,%u)'", blocknum, offset);
-		else
-			appendPQExpBuffer(&qval, "'(%u,%u)'", blocknum, offset);
-		rowc++;
-		rcnt++;
+		res->keyset[GIdx2KResIdx(found->pos, stmt, res)].status &= ~CURS_NEEDS_REREAD;
 	}
 cleanup:
 #undef	return
-	if (!PQExpBufferDataBroken(qval))
-		termPQExpBuffer(&qval);
+	QR_Destructor(qres);
+	if (keys)
+		free(keys);
 	return rcnt;
 }
 
@@ -3756,18 +3763,11 @@ SC_pos_reload_needed(StatementClass *stmt, SQLULEN req_size, UDWORD flag)
 				res->keyset[kres_ridx].status |= CURS_NEEDS_REREAD;
 		}
 	}
-	if (TI_has_subclass(stmt->ti[0]))
-	{
-		if (rowc = LoadFromKeyset_inh(stmt, res, rows_per_fetch, limitrow), rowc < 0)
-		{
-			goto cleanup;
-		}
-	}
-	else if (rowc = LoadFromKeyset(stmt, res, rows_per_fetch, limitrow), rowc < 0)
+	if (rowc = LoadFromKeyset(stmt, res, limitrow), rowc < 0)
 	{
 		goto cleanup;
 	}
-	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res); i < limitrow; i++)
+	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res); i < limitrow; i++, kres_ridx++)
 	{
 		if (0 != (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
 		{
@@ -3791,12 +3791,85 @@ cleanup:
 	return ret;
 }
 
+/*
+ *	Append a newly added row loaded into qres to the keyset and the
+ *	cache of the current result.
+ */
+static RETCODE
+pos_newload_tuple(StatementClass *stmt, QResultClass *res, const QResultClass *qres, TupleField *tuple_new)
+{
+	int			i;
+	int	effective_fields = res->num_fields;
+	ssize_t	tuple_size;
+	SQLLEN	num_total_rows, num_cached_rows, kres_ridx;
+	BOOL	appendKey = FALSE, appendData = FALSE;
+	TupleField *tuple_old;
+
+	num_total_rows = QR_get_num_total_tuples(res);
+
+	AddAdded(stmt, res, num_total_rows, tuple_new);
+	num_cached_rows = QR_get_num_cached_tuples(res);
+	kres_ridx = GIdx2KResIdx(num_total_rows, stmt, res);
+	if (QR_haskeyset(res))
+	{	if (!QR_get_cursor(res))
+		{
+			appendKey = TRUE;
+			if (num_total_rows == CacheIdx2GIdx(num_cached_rows, stmt, res))
+				appendData = TRUE;
+			else
+			{
+MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " <> backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
+num_total_rows, num_cached_rows,
+QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
+			}
+		}
+		else if (kres_ridx >= 0 && kres_ridx < res->cache_size)
+		{
+			appendKey = TRUE;
+			appendData = TRUE;
+		}
+	}
+	if (appendKey)
+	{
+		if (res->num_cached_keys >= res->count_keyset_allocated)
+		{
+			if (!res->count_keyset_allocated)
+				tuple_size = TUPLE_MALLOC_INC;
+			else
+				tuple_size = res->count_keyset_allocated * 2;
+			QR_REALLOC_return_with_error(res->keyset, KeySet, sizeof(KeySet) * tuple_size, res, "pos_newload failed", SQL_ERROR);
+			res->count_keyset_allocated = tuple_size;
+		}
+		KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, TRUE);
+		res->num_cached_keys++;
+	}
+	if (appendData)
+	{
+MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " == backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
+num_total_rows, num_cached_rows,
+QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
+		if (num_cached_rows >= res->count_backend_allocated)
+		{
+			if (!res->count_backend_allocated)
+				tuple_size = TUPLE_MALLOC_INC;
+			else
+				tuple_size = res->count_backend_allocated * 2;
+			QR_REALLOC_return_with_error(res->backend_tuples, TupleField, res->num_fields * sizeof(TupleField) * tuple_size, res, "SC_pos_newload failed", SQL_ERROR);
+			res->count_backend_allocated = tuple_size;
+		}
+		tuple_old = res->backend_tuples + res->num_fields * num_cached_rows;
+		for (i = 0; i < effective_fields; i++)
+			MoveTupleValue(tuple_old + i, tuple_new + i);
+		res->num_cached_rows++;
+	}
+	return SQL_SUCCESS;
+}
+
 static RETCODE	SQL_API
 SC_pos_newload(StatementClass *stmt, const UInt4 *oidint, BOOL tidRef,
 			   const char *tidval)
 {
 	CSTR	func = "SC_pos_newload";
-	int			i;
 	QResultClass *res, *qres;
 	RETCODE		ret = SQL_ERROR;
 
@@ -3825,81 +3898,10 @@ SC_pos_newload(StatementClass *stmt, const UInt4 *oidint, BOOL tidRef,
 
 		QR_set_position(qres, 0);
 		if (count == 1)
-		{
-			int	effective_fields = res->num_fields;
-			ssize_t	tuple_size;
-			SQLLEN	num_total_rows, num_cached_rows, kres_ridx;
-			BOOL	appendKey = FALSE, appendData = FALSE;
-			TupleField *tuple_old, *tuple_new;
-
-			tuple_new = qres->tupleField;
-			num_total_rows = QR_get_num_total_tuples(res);
-
-			AddAdded(stmt, res, num_total_rows, tuple_new);
-			num_cached_rows = QR_get_num_cached_tuples(res);
-			kres_ridx = GIdx2KResIdx(num_total_rows, stmt, res);
-			if (QR_haskeyset(res))
-			{	if (!QR_get_cursor(res))
-				{
-					appendKey = TRUE;
-					if (num_total_rows == CacheIdx2GIdx(num_cached_rows, stmt, res))
-						appendData = TRUE;
-					else
-					{
-MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " <> backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
-num_total_rows, num_cached_rows,
-QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
-					}
-				}
-				else if (kres_ridx >= 0 && kres_ridx < res->cache_size)
-				{
-					appendKey = TRUE;
-					appendData = TRUE;
-				}
-			}
-			if (appendKey)
-			{
-				if (res->num_cached_keys >= res->count_keyset_allocated)
-				{
-					if (!res->count_keyset_allocated)
-						tuple_size = TUPLE_MALLOC_INC;
-					else
-						tuple_size = res->count_keyset_allocated * 2;
-					QR_REALLOC_return_with_error(res->keyset, KeySet, sizeof(KeySet) * tuple_size, res, "pos_newload failed", SQL_ERROR);
-					res->count_keyset_allocated = tuple_size;
-				}
-				KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, TRUE);
-				res->num_cached_keys++;
-			}
-			if (appendData)
-			{
-MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " == backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
-num_total_rows, num_cached_rows,
-QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
-				if (num_cached_rows >= res->count_backend_allocated)
-				{
-					if (!res->count_backend_allocated)
-						tuple_size = TUPLE_MALLOC_INC;
-					else
-						tuple_size = res->count_backend_allocated * 2;
-					QR_REALLOC_return_with_error(res->backend_tuples, TupleField, res->num_fields * sizeof(TupleField) * tuple_size, res, "SC_pos_newload failed", SQL_ERROR);
-					res->count_backend_allocated = tuple_size;
-				}
-				tuple_old = res->backend_tuples + res->num_fields * num_cached_rows;
-				for (i = 0; i < effective_fields; i++)
-				{
-					tuple_old[i].len = tuple_new[i].len;
-					tuple_new[i].len = -1;
-					tuple_old[i].value = tuple_new[i].value;
-					tuple_new[i].value = NULL;
-				}
-				res->num_cached_rows++;
-			}
-			ret = SQL_SUCCESS;
-		}
-		else if (0 == count)
-			ret = SQL_NO_DATA_FOUND;
-		else
+			ret = pos_newload_tuple(stmt, res, qres, qres->tupleField);
+		else if (0 == count)
+			ret = SQL_NO_DATA_FOUND;
+		else
 		{
 			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the driver could't identify inserted rows", func);
 			ret = SQL_ERROR;
@@ -4729,6 +4731,887 @@ cleanup:
 	return ret;
 }
 
+/*
+ *	Set-based bulk operations.
+ *
+ *	SQLBulkOperations() adds, updates or deletes the rows of the rowset
+ *	with one statement per table instead of one per row. The keys the
+ *	statements return are used to reload the rows with one query.
+ */
+#define	MAX_BULK_PARAMS	65535	/* the limit of the extended query protocol */
+/*
+ *	SC_pos_add_rows() sends a WITH query of one INSERT per row, which the
+ *	server parses and plans as that many subqueries plus a UNION ALL of
+ *	them, unlike the single VALUES list of a multi-row INSERT. The time
+ *	this takes grows with the rowset, so larger rowsets are added row by
+ *	row.
+ */
+#define	MAX_BULK_ADD_ROWS	128
+
+/* The buffer and the length/indicator of the bound column in the row */
+static void
+bound_column(const ARDFields *opts, const BindInfoClass *binding, SQLSETPOSIROW irow, char **buffer, SQLLEN **used)
+{
+	SQLULEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	Int4	bind_size = opts->bind_size, ctypelen;
+
+	*buffer = NULL;
+	if (binding->buffer)
+	{
+		*buffer = binding->buffer + offset;
+		if (bind_size > 0)
+			*buffer += bind_size * irow;
+		else if (ctypelen = ctype_length(binding->returntype), ctypelen > 0)
+			*buffer += ctypelen * irow;
+		else
+			*buffer += binding->buflen * irow;
+	}
+	*used = NULL;
+	if (binding->used)
+	{
+		*used = LENADDR_SHIFT(binding->used, offset);
+		if (bind_size > 0)
+			*used = LENADDR_SHIFT(*used, bind_size * irow);
+		else
+			*used = LENADDR_SHIFT(*used, irow * sizeof(SQLLEN));
+	}
+}
+
+/*
+ *	Get the columns to set for the rows of the rowset. Returns the number
+ *	of the columns or -1 if the same columns are not set for all the rows
+ *	or a data-at-execution column exists.
+ */
+static int
+bulk_columns(StatementClass *stmt, SQLSETPOSIROW nrows, int *cols)
+{
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	FIELD_INFO	**fi = irdflds->fi;
+	int		i, ncols = 0;
+	SQLSETPOSIROW	irow;
+	char		*buffer;
+	SQLLEN		*used;
+	BOOL		set = FALSE, rset;
+
+	for (i = 0; i < (int) irdflds->nfields && i < opts->allocated; i++)
+	{
+		if (NULL == opts->bindings[i].used)
+			continue;
+		for (irow = 0; irow < nrows; irow++)
+		{
+			bound_column(opts, opts->bindings + i, irow, &buffer, &used);
+			if (SQL_DATA_AT_EXEC == *used || *used <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+				return -1;
+			rset = (SQL_IGNORE != *used && fi[i]->updatable);
+			if (0 == irow)
+				set = rset;
+			else if (rset != set)
+				return -1;
+		}
+		if (set)
+			cols[ncols++] = i;
+	}
+	return ncols;
+}
+
+/*
+ *	Can SQLBulkOperations() add or update the rows of the rowset with
+ *	one statement ?
+ */
+BOOL
+SC_pos_rows_settable(StatementClass *stmt, SQLSETPOSIROW nrows, SQLSMALLINT operation)
+{
+	QResultClass	*res = SC_get_Curres(stmt);
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	int		*cols, ncols, i;
+	BOOL		ret = FALSE;
+
+	if (nrows < 2 || !res || !PG_VERSION_GE(conn, 8.2))
+		return FALSE;
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt) || !irdflds->fi || !stmt->load_statement)
+		return FALSE;
+	if (NULL == (cols = malloc(sizeof(int) * (irdflds->nfields + 1))))
+		return FALSE;
+	ncols = bulk_columns(stmt, nrows, cols);
+	if (ncols > 0 && nrows * (ncols + 3) <= MAX_BULK_PARAMS)
+	{
+		ret = TRUE;
+		/* the values of UPDATE .. FROM (VALUES ..) need explicit types */
+		for (i = 0; SQL_UPDATE_BY_BOOKMARK == operation && i < ncols; i++)
+		{
+			if (0 == strcmp(pgtype_to_name(stmt, getEffectiveOid(conn, irdflds->fi[cols[i]]), cols[i], FALSE), "unknown"))
+				ret = FALSE;
+		}
+		/*
+		 * SC_pos_add_rows() inserts the rows in a WITH query, which
+		 * rejects tables with DO ALSO, DO INSTEAD NOTHING or
+		 * conditional rules
+		 */
+		if (SQL_ADD == operation &&
+		    (nrows > MAX_BULK_ADD_ROWS || !PG_VERSION_GE(conn, 9.1) ||
+		     SC_table_has_rules(stmt, stmt->ti[0])))
+			ret = FALSE;
+	}
+	free(cols);
+	return ret;
+}
+
+static void
+bind_bulk_param(StatementClass *qstmt, int *pno, OID pgtype, SQLSMALLINT ctype, SQLSMALLINT sqltype, SQLULEN column_size, SQLSMALLINT decimal_digits, void *buffer, SQLLEN buflen, SQLLEN *used)
+{
+	PIC_set_pgtype(SC_get_IPDF(qstmt)->parameters[*pno], pgtype);
+	PGAPI_BindParameter(qstmt, (SQLUSMALLINT) ++(*pno), SQL_PARAM_INPUT,
+		ctype, sqltype, column_size, decimal_digits,
+		buffer, buflen, used);
+}
+
+/* Bind the column of the row as the next parameter like SC_pos_add() */
+static void
+bind_bulk_column(StatementClass *stmt, StatementClass *qstmt, int *pno, int col, SQLSETPOSIROW irow)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	BindInfoClass	*binding = opts->bindings + col;
+	FIELD_INFO	*fi = SC_get_IRDF(stmt)->fi[col];
+	int		unknown_sizes = conn->connInfo.drivers.unknown_sizes;
+	OID		fieldtype = getEffectiveOid(conn, fi);
+	char		*buffer;
+	SQLLEN		*used;
+
+	bound_column(opts, binding, irow, &buffer, &used);
+	bind_bulk_param(qstmt, pno, fieldtype, binding->returntype,
+		pgtype_to_concise_type(stmt, fieldtype, col, unknown_sizes),
+		fi->column_size > 0 ? fi->column_size : pgtype_column_size(stmt, fieldtype, col, unknown_sizes),
+		(SQLSMALLINT) fi->decimal_digits,
+		buffer, binding->buflen, used);
+}
+
+/* Prepare an internal statement for the bulk operation of the parent */
+static StatementClass *
+bulk_stmt(StatementClass *stmt, int nparams)
+{
+	CSTR	func = "bulk_stmt";
+	HSTMT	hstmt;
+	StatementClass	*qstmt;
+	APDFields	*apdopts;
+
+	if (PGAPI_AllocStmt(SC_get_conn(stmt), &hstmt, 0) != SQL_SUCCESS)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "internal AllocStmt error", func);
+		return NULL;
+	}
+	qstmt = (StatementClass *) hstmt;
+	/* the parameters are bound to the row addresses */
+	apdopts = SC_get_APDF(qstmt);
+	apdopts->param_bind_type = 0;
+	apdopts->param_offset_ptr = NULL;
+	SC_set_delegate(stmt, qstmt);
+	extend_iparameter_bindings(SC_get_IPDF(qstmt), nparams);
+	qstmt->exec_start_row = qstmt->exec_end_row = 0;
+	return qstmt;
+}
+
+/* The key type of the table to compare the keysets with */
+static OID
+bulk_key_type(const TABLE_INFO *ti)
+{
+	if (TI_has_subclass(ti) || NAME_IS_NULL(ti->bestitem))
+		return 0;
+	if (TI_has_oids(ti))
+		return PG_TYPE_OID;
+	return PG_TYPE_INT4;
+}
+
+/*
+ *	Get the keysets of the rows to update or delete by bookmark in the
+ *	order of the tables and the tids.
+ */
+static ReloadKey *
+bulk_target_keys(StatementClass *stmt, SQLSETPOSIROW nrows, const SQLULEN *global_ridx, const KeySet *keysets, const char *func)
+{
+	QResultClass	*res = SC_get_Curres(stmt);
+	const char	*bestitem = GET_NAME(stmt->ti[0]->bestitem);
+	ReloadKey	*keys;
+	const KeySet	*keyset;
+	SQLSETPOSIROW	irow;
+	SQLLEN		kres_ridx;
+
+	if (NULL == (keys = (ReloadKey *) malloc(sizeof(ReloadKey) * nrows)))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for the keys", func);
+		return NULL;
+	}
+	for (irow = 0; irow < nrows; irow++)
+	{
+		kres_ridx = GIdx2KResIdx(global_ridx[irow], stmt, res);
+		if (kres_ridx >= 0 && kres_ridx < res->num_cached_keys)
+			keyset = res->keyset + kres_ridx;
+		else if (0 == keysets[irow].offset)
+		{
+			SC_set_error(stmt, STMT_ROW_OUT_OF_RANGE, "the target keys are out of the rowset", func);
+			free(keys);
+			return NULL;
+		}
+		else
+			keyset = keysets + irow;
+		if (0 == keyset->oid && bestitem && 0 == strcmp(bestitem, OID_NAME))
+		{
+			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the row was already deleted ?", func);
+			free(keys);
+			return NULL;
+		}
+		set_reload_key(keys + irow, keyset, irow);
+	}
+	qsort(keys, nrows, sizeof(ReloadKey), reload_key_cmp);
+	return keys;
+}
+
+/* The number of the keys of the same table as keys[0] */
+static SQLLEN
+bulk_table_keys(const StatementClass *stmt, const ReloadKey *keys, SQLLEN nkeys)
+{
+	SQLLEN	i;
+
+	if (!TI_has_subclass(stmt->ti[0]))
+		return nkeys;
+	for (i = 1; i < nkeys && keys[i].oid == keys[0].oid; i++)
+		;
+	return i;
+}
+
+static void
+set_row_status(StatementClass *stmt, SQLSETPOSIROW irow, UWORD status)
+{
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+
+	if (irdflds->rowStatusArray)
+		irdflds->rowStatusArray[irow] = status;
+}
+
+#define	BULK_NOT_EXECUTED	0
+#define	BULK_NOT_AFFECTED	1
+#define	BULK_AFFECTED		2
+
+RETCODE
+SC_pos_delete_rows(StatementClass *stmt, SQLSETPOSIROW nrows, const SQLULEN *global_ridx, const KeySet *keysets, int *processed)
+{
+	CSTR	func = "SC_pos_delete_rows";
+	QResultClass	*res, *qres = NULL;
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	TABLE_INFO	*ti;
+	const char	*bestitem;
+	OID		key_type;
+	ReloadKey	*keys = NULL, *found;
+	char		*state = NULL;
+	PQExpBufferData	dltstr = {0};
+	RETCODE		ret = SQL_ERROR;
+	SQLLEN		i, j, nkeys, kres_ridx;
+	SQLSETPOSIROW	irow;
+	UDWORD		qflag = 0;
+	KeySet		keys_deleted, *keyset;
+	char		table_fqn[256];
+
+	MYLOG(0, "entering nrows=" FORMAT_POSIROW "\n", nrows);
+	*processed = 0;
+	if (!(res = SC_get_Curres(stmt)))
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_delete_rows.", func);
+		return SQL_ERROR;
+	}
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+	{
+		stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
+		SC_set_error(stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
+		return SQL_ERROR;
+	}
+	ti = stmt->ti[0];
+	bestitem = GET_NAME(ti->bestitem);
+	key_type = bulk_key_type(ti);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	if (NULL == (keys = bulk_target_keys(stmt, nrows, global_ridx, keysets, func)))
+		goto cleanup;
+	if (NULL == (state = calloc(nrows, 1)))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_delete_rows()", func);
+		goto cleanup;
+	}
+	if (stmt->external && !CC_is_in_trans(conn) &&
+	    !CC_does_autocommit(conn))
+		qflag |= GO_INTO_TRANSACTION;
+	initPQExpBuffer(&dltstr);
+	ret = SQL_SUCCESS;
+	for (i = 0; i < (SQLLEN) nrows; i += nkeys)
+	{
+		nkeys = bulk_table_keys(stmt, keys + i, nrows - i);
+		printfPQExpBuffer(&dltstr,
+			 "delete from %s where ctid = any($1::tid[])",
+			 ti_quote(stmt, keys[i].oid, table_fqn, sizeof(table_fqn)));
+		if (0 != key_type)
+			appendPQExpBuffer(&dltstr, " and \"%s\" = any($2::%s[])", bestitem, PG_TYPE_OID == key_type ? "oid" : "int4");
+		appendPQExpBufferStr(&dltstr, " returning ctid");
+		if (bestitem)
+			appendPQExpBuffer(&dltstr, ", \"%s\"", bestitem);
+		if (PQExpBufferDataBroken(dltstr))
+		{
+			ret = SQL_ERROR;
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_delete_rows()", func);
+			goto cleanup;
+		}
+		MYLOG(0, "dltstr=%s\n", dltstr.data);
+		qres = exec_with_keys(stmt, "", dltstr.data, keys + i, nkeys, key_type, qflag);
+		if (!QR_command_maybe_successful(qres))
+		{
+			ret = SQL_ERROR;
+			if (qres)
+				SC_replace_error_with_res(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "bulk delete return error", qres, TRUE);
+			else if (0 == SC_get_errornumber(stmt))
+				SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "bulk delete return error", func);
+			break;
+		}
+		qflag &= ~GO_INTO_TRANSACTION;
+		for (j = 0; j < nkeys; j++)
+			state[keys[i + j].pos] = BULK_NOT_AFFECTED;
+		for (j = 0; j < QR_get_num_cached_tuples(qres); j++)
+		{
+			ReloadKey	key;
+
+			KeySetSet(qres->backend_tuples + QR_NumResultCols(qres) * j, QR_NumResultCols(qres), QR_NumResultCols(qres), &keys_deleted, TRUE);
+			set_reload_key(&key, &keys_deleted, -1);
+			if (NULL != (found = bsearch(&key, keys + i, nkeys, sizeof(ReloadKey), reload_key_cmp)))
+				state[found->pos] = BULK_AFFECTED;
+		}
+		QR_Destructor(qres);
+		qres = NULL;
+	}
+
+	/* the same bookkeeping as SC_pos_delete() per row */
+	for (irow = 0; irow < nrows; irow++)
+	{
+		kres_ridx = GIdx2KResIdx(global_ridx[irow], stmt, res);
+		if (kres_ridx >= 0 && kres_ridx < res->num_cached_keys)
+			keyset = res->keyset + kres_ridx;
+		else
+		{
+			kres_ridx = -1;
+			keyset = (KeySet *) keysets + irow;
+		}
+		switch (state[irow])
+		{
+			case BULK_AFFECTED:
+				AddRollback(stmt, res, global_ridx[irow], keyset, SQL_DELETE);
+				if (kres_ridx >= 0 && stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
+					keyset->status |= SQL_ROW_DELETED;
+				AddDeleted(res, global_ridx[irow], keyset);
+				if (kres_ridx >= 0)
+				{
+					keyset->status &= (~KEYSET_INFO_PUBLIC);
+					if (CC_is_in_trans(conn))
+						keyset->status |= (SQL_ROW_DELETED | CURS_SELF_DELETING);
+					else
+						keyset->status |= (SQL_ROW_DELETED | CURS_SELF_DELETED);
+				}
+				set_row_status(stmt, irow, SQL_ROW_DELETED);
+				break;
+			case BULK_NOT_AFFECTED:
+				SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the content was changed before deletes", func);
+				if (SQL_SUCCESS == ret)
+					ret = SQL_SUCCESS_WITH_INFO;
+				if (kres_ridx >= 0 && stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
+					SC_pos_reload(stmt, global_ridx[irow], (UInt2 *) 0, 0);
+				set_row_status(stmt, irow, SQL_ROW_DELETED);
+				break;
+			default:
+				set_row_status(stmt, irow, SQL_ROW_ERROR);
+				continue;
+		}
+		(*processed)++;
+	}
+
+cleanup:
+#undef	return
+	if (!PQExpBufferDataBroken(dltstr))
+		termPQExpBuffer(&dltstr);
+	QR_Destructor(qres);
+	if (keys)
+		free(keys);
+	if (state)
+		free(state);
+	return ret;
+}
+
+RETCODE
+SC_pos_update_rows(StatementClass *stmt, SQLSETPOSIROW nrows, const SQLULEN *global_ridx, const KeySet *keysets, int *processed)
+{
+	CSTR	func = "SC_pos_update_rows";
+	typedef struct
+	{
+		SQLINTEGER	row;
+		UInt4	key;
+		char	tid[32];
+		SQLLEN	tidlen;
+	} RowParam;
+	QResultClass	*res, *tres, *qres = NULL;
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	TABLE_INFO	*ti;
+	const char	*bestitem;
+	OID		key_type;
+	ReloadKey	*keys = NULL, *updated = NULL, *sorted = NULL;
+	RowParam	*rparams = NULL;
+	char		*state = NULL;
+	int		*cols = NULL, ncols, pno, k, updcnt, status;
+	StatementClass	*qstmt = NULL;
+	PQExpBufferData	updstr = {0};
+	RETCODE		ret = SQL_ERROR, qret;
+	SQLLEN		i, j, nkeys, nupdated = 0, kres_ridx, lidx, res_ridx;
+	SQLSETPOSIROW	irow;
+	KeySet		*keyset, old_keyset, new_keyset;
+	const char	*cmdstr;
+	char		table_fqn[256];
+
+	MYLOG(0, "entering nrows=" FORMAT_POSIROW "\n", nrows);
+	*processed = 0;
+	if (!(res = SC_get_Curres(stmt)))
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_update_rows.", func);
+		return SQL_ERROR;
+	}
+	ti = stmt->ti[0];
+	bestitem = GET_NAME(ti->bestitem);
+	key_type = bulk_key_type(ti);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	if (NULL == (keys = bulk_target_keys(stmt, nrows, global_ridx, keysets, func)))
+		goto cleanup;
+	state = calloc(nrows, 1);
+	cols = malloc(sizeof(int) * (irdflds->nfields + 1));
+	rparams = (RowParam *) malloc(sizeof(RowParam) * nrows);
+	updated = (ReloadKey *) malloc(sizeof(ReloadKey) * nrows);
+	if (!state || !cols || !rparams || !updated)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_update_rows()", func);
+		goto cleanup;
+	}
+	ncols = bulk_columns(stmt, nrows, cols);
+	initPQExpBuffer(&updstr);
+	ret = SQL_SUCCESS;
+	for (i = 0; i < (SQLLEN) nrows; i += nkeys)
+	{
+		nkeys = bulk_table_keys(stmt, keys + i, nrows - i);
+		/*
+		 *	update t as _t set "c" = _v._1, ... from (values (?::type, ...,
+		 *	?::tid, ?::int4), ...) as _v(_1, ..., _ctid, _row) where
+		 *	_t.ctid = _v._ctid returning _v._row, _t.ctid
+		 */
+		printfPQExpBuffer(&updstr, "update %s as _t set",
+			 ti_quote(stmt, keys[i].oid, table_fqn, sizeof(table_fqn)));
+		for (k = 0; k < ncols; k++)
+			appendPQExpBuffer(&updstr, "%s \"%s\" = _v._%d", k ? "," : "", GET_NAME(irdflds->fi[cols[k]]->column_name), k + 1);
+		appendPQExpBufferStr(&updstr, " from (values ");
+		if (NULL == (qstmt = bulk_stmt(stmt, (int) nkeys * (ncols + 3))))
+		{
+			ret = SQL_ERROR;
+			break;
+		}
+		for (j = pno = 0; j < nkeys; j++)
+		{
+			RowParam	*rp = rparams + keys[i + j].pos;
+
+			irow = (SQLSETPOSIROW) keys[i + j].pos;
+			appendPQExpBufferStr(&updstr, j ? ", (" : "(");
+			for (k = 0; k < ncols; k++)
+			{
+				appendPQExpBuffer(&updstr, "?::%s, ", pgtype_to_name(stmt, getEffectiveOid(conn, irdflds->fi[cols[k]]), cols[k], FALSE));
+				bind_bulk_column(stmt, qstmt, &pno, cols[k], irow);
+			}
+			rp->row = (SQLINTEGER) irow;
+			rp->key = keys[i + j].oid;
+			SPRINTF_FIXED(rp->tid, "(%u,%hu)", keys[i + j].blocknum, keys[i + j].offset);
+			rp->tidlen = SQL_NTS;
+			appendPQExpBufferStr(&updstr, "?::tid, ");
+			bind_bulk_param(qstmt, &pno, PG_TYPE_TID, SQL_C_CHAR, SQL_VARCHAR, sizeof(rp->tid), 0, rp->tid, sizeof(rp->tid), &rp->tidlen);
+			if (0 != key_type)
+			{
+				appendPQExpBuffer(&updstr, "?::%s, ", PG_TYPE_OID == key_type ? "oid" : "int4");
+				bind_bulk_param(qstmt, &pno, key_type, PG_TYPE_OID == key_type ? SQL_C_ULONG : SQL_C_SLONG, SQL_INTEGER, 10, 0, &rp->key, 0, NULL);
+			}
+			appendPQExpBufferStr(&updstr, "?::int4)");
+			bind_bulk_param(qstmt, &pno, PG_TYPE_INT4, SQL_C_SLONG, SQL_INTEGER, 10, 0, &rp->row, 0, NULL);
+		}
+		appendPQExpBufferStr(&updstr, ") as _v(");
+		for (k = 0; k < ncols; k++)
+			appendPQExpBuffer(&updstr, "_%d, ", k + 1);
+		appendPQExpBufferStr(&updstr, 0 != key_type ? "_ctid, _key, _row)" : "_ctid, _row)");
+		appendPQExpBufferStr(&updstr, " where _t.ctid = _v._ctid");
+		if (0 != key_type)
+			appendPQExpBuffer(&updstr, " and _t.\"%s\" = _v._key", bestitem);
+		appendPQExpBufferStr(&updstr, " returning _v._row, _t.ctid");
+		if (bestitem)
+			appendPQExpBuffer(&updstr, ", _t.\"%s\"", bestitem);
+		if (PQExpBufferDataBroken(updstr))
+		{
+			ret = SQL_ERROR;
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_update_rows()", func);
+			break;
+		}
+		MYLOG(0, "updstr=%s\n", updstr.data);
+		qret = PGAPI_ExecDirect(qstmt, (SQLCHAR *) updstr.data, SQL_NTS, 0);
+		tres = SC_get_Curres(qstmt);
+		cmdstr = tres ? QR_get_command(tres) : NULL;
+		status = 0;
+		if (SQL_ERROR == qret || !cmdstr ||
+		    secure_sscanf(cmdstr, &status, "UPDATE %d", ARG_INT(&updcnt)) != 1 ||
+		    updcnt != QR_get_num_cached_tuples(tres))
+		{
+			ret = SQL_ERROR;
+			SC_error_copy(stmt, qstmt, TRUE);
+			if (0 == SC_get_errornumber(stmt))
+				SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "bulk update return error", func);
+			break;
+		}
+		for (j = 0; j < nkeys; j++)
+			state[keys[i + j].pos] = BULK_NOT_AFFECTED;
+		for (j = 0; j < updcnt; j++)
+		{
+			TupleField	*tuple = tres->backend_tuples + QR_NumResultCols(tres) * j;
+			SQLLEN	row = atol(tuple[0].value);
+
+			if (row < 0 || row >= (SQLLEN) nrows)
+				continue;
+			KeySetSet(tuple + 1, QR_NumResultCols(tres) - 1, QR_NumResultCols(tres) - 1, &new_keyset, TRUE);
+			set_reload_key(updated + nupdated++, &new_keyset, row);
+			state[row] = BULK_AFFECTED;
+		}
+		PGAPI_FreeStmt(qstmt, SQL_DROP);
+		qstmt = NULL;
+	}
+
+	/* reload the updated rows */
+	if (nupdated > 0)
+	{
+		qres = load_by_keys(stmt, "", NULL, updated, nupdated);
+		if (!QR_command_maybe_successful(qres) ||
+		    NULL == (sorted = sort_loaded_rows(qres)))
+		{
+			QR_Destructor(qres);
+			qres = NULL;
+		}
+	}
+	/* the same bookkeeping as SC_pos_update() per row */
+	for (irow = 0; irow < nrows; irow++)
+	{
+		RETCODE	rret = SQL_SUCCESS;
+
+		kres_ridx = GIdx2KResIdx(global_ridx[irow], stmt, res);
+		if (kres_ridx >= 0 && kres_ridx < res->num_cached_keys)
+			keyset = res->keyset + kres_ridx;
+		else
+		{
+			kres_ridx = -1;
+			keyset = (KeySet *) keysets + irow;
+		}
+		old_keyset = *keyset;
+		if (BULK_NOT_EXECUTED == state[irow])
+		{
+			set_row_status(stmt, irow, SQL_ROW_ERROR);
+			continue;
+		}
+		else if (BULK_NOT_AFFECTED == state[irow])
+		{
+			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the content was changed before updates", func);
+			rret = SQL_SUCCESS_WITH_INFO;
+			if (stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
+				SC_pos_reload(stmt, global_ridx[irow], (UInt2 *) 0, 0);
+		}
+		else
+		{
+			for (j = 0; j < nupdated && updated[j].pos != (SQLLEN) irow; j++)
+				;
+			new_keyset.oid = updated[j].oid;
+			new_keyset.blocknum = updated[j].blocknum;
+			new_keyset.offset = updated[j].offset;
+			new_keyset.status = 0;
+			lidx = qres ? find_loaded_row(qres, sorted, &new_keyset) : -1;
+			if (lidx >= 0)
+			{
+				TupleField	*tuple_new = qres->backend_tuples + qres->num_fields * lidx;
+
+				AddUpdated(stmt, global_ridx[irow], &new_keyset, tuple_new);
+				res_ridx = GIdx2CacheIdx(global_ridx[irow], stmt, res);
+				if (kres_ridx >= 0 && res_ridx >= 0 && res_ridx < QR_get_num_cached_tuples(res))
+				{
+					KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, FALSE);
+					MoveCachedRows(res->backend_tuples + res->num_fields * res_ridx, tuple_new, getNumResultCols(res), 1);
+				}
+			}
+			else
+				rret = SC_pos_reload_with_key(stmt, global_ridx[irow], (UInt2 *) 0, SQL_UPDATE, &new_keyset);
+			if (SQL_SUCCEEDED(rret))
+				AddRollback(stmt, res, global_ridx[irow], &old_keyset, SQL_UPDATE);
+		}
+		if (SQL_SUCCESS == rret && kres_ridx >= 0)
+		{
+			if (CC_is_in_trans(conn))
+				res->keyset[kres_ridx].status |= (SQL_ROW_UPDATED  | CURS_SELF_UPDATING);
+			else
+				res->keyset[kres_ridx].status |= (SQL_ROW_UPDATED  | CURS_SELF_UPDATED);
+		}
+		switch (rret)
+		{
+			case SQL_SUCCESS:
+				set_row_status(stmt, irow, SQL_ROW_UPDATED);
+				break;
+			case SQL_ERROR:
+				set_row_status(stmt, irow, SQL_ROW_ERROR);
+				ret = SQL_ERROR;
+				break;
+			default:
+				set_row_status(stmt, irow, SQL_ROW_SUCCESS_WITH_INFO);
+				if (SQL_SUCCESS == ret)
+					ret = SQL_SUCCESS_WITH_INFO;
+				break;
+		}
+		(*processed)++;
+	}
+
+cleanup:
+#undef	return
+	if (!PQExpBufferDataBroken(updstr))
+		termPQExpBuffer(&updstr);
+	if (qstmt)
+		PGAPI_FreeStmt(qstmt, SQL_DROP);
+	QR_Destructor(qres);
+	if (keys)
+		free(keys);
+	if (updated)
+		free(updated);
+	if (sorted)
+		free(sorted);
+	if (rparams)
+		free(rparams);
+	if (cols)
+		free(cols);
+	if (state)
+		free(state);
+	return ret;
+}
+
+RETCODE
+SC_pos_add_rows(StatementClass *stmt, SQLSETPOSIROW nrows, int *processed)
+{
+	CSTR	func = "SC_pos_add_rows";
+	QResultClass	*res, *ires, *tres, *qres = NULL;
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	TABLE_INFO	*ti;
+	const char	*bestitem;
+	ReloadKey	*keys = NULL, *sorted = NULL;
+	SQLINTEGER	*ordinals = NULL;
+	char		*state = NULL;
+	int		*cols = NULL, ncols, pno, k;
+	StatementClass	*qstmt = NULL;
+	PQExpBufferData	addstr = {0};
+	RETCODE		ret = SQL_ERROR, qret;
+	SQLLEN		i, naddcnt, nadded = 0, row, addpos, lidx, kres_ridx;
+	SQLSETPOSIROW	irow, brow_save;
+	KeySet		keyset;
+	char		tidv[32];
+	int		func_cs_count = 0;
+	char		table_fqn[256];
+
+	MYLOG(0, "entering nrows=" FORMAT_POSIROW "\n", nrows);
+	*processed = 0;
+	if (!(res = SC_get_Curres(stmt)))
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_add_rows.", func);
+		return SQL_ERROR;
+	}
+	ti = stmt->ti[0];
+	bestitem = GET_NAME(ti->bestitem);
+	initPQExpBuffer(&addstr);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	keys = (ReloadKey *) malloc(sizeof(ReloadKey) * nrows);
+	ordinals = (SQLINTEGER *) malloc(sizeof(SQLINTEGER) * nrows);
+	state = calloc(nrows, 1);
+	cols = malloc(sizeof(int) * (irdflds->nfields + 1));
+	if (!keys || !ordinals || !state || !cols)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_add_rows()", func);
+		goto cleanup;
+	}
+	ncols = bulk_columns(stmt, nrows, cols);
+	if (ncols <= 0 || NULL == (qstmt = bulk_stmt(stmt, (int) nrows * (ncols + 1))))
+		goto cleanup;
+	/*
+	 *	A multi-row INSERT .. RETURNING neither returns the rows in the
+	 *	order of the VALUES list nor tells which rows BEFORE INSERT
+	 *	triggers skipped. Insert each row in its own data-modifying WITH
+	 *	query instead so that RETURNING can carry the row ordinal.
+	 *
+	 *	with _i0 as (insert into t ("c", ...) values (?, ...) returning
+	 *	?::int4, ctid), _i1 as (...), ... select * from _i0 union all
+	 *	select * from _i1 ...
+	 */
+	ti_quote(stmt, 0, table_fqn, sizeof(table_fqn));
+	for (irow = pno = 0; irow < nrows; irow++)
+	{
+		appendPQExpBuffer(&addstr, "%s_i" FORMAT_POSIROW " as (insert into %s (", irow ? ", " : "with ", irow, table_fqn);
+		for (k = 0; k < ncols; k++)
+			appendPQExpBuffer(&addstr, "%s\"%s\"", k ? ", " : "", GET_NAME(irdflds->fi[cols[k]]->column_name));
+		appendPQExpBufferStr(&addstr, ") values (");
+		for (k = 0; k < ncols; k++)
+		{
+			appendPQExpBufferStr(&addstr, k ? ", ?" : "?");
+			bind_bulk_column(stmt, qstmt, &pno, cols[k], irow);
+		}
+		ordinals[irow] = (SQLINTEGER) irow;
+		appendPQExpBufferStr(&addstr, ") returning ?::int4, ctid");
+		bind_bulk_param(qstmt, &pno, PG_TYPE_INT4, SQL_C_SLONG, SQL_INTEGER, 10, 0, ordinals + irow, 0, NULL);
+		if (bestitem)
+			appendPQExpBuffer(&addstr, ", \"%s\"", bestitem);
+		appendPQExpBufferStr(&addstr, ")");
+	}
+	for (irow = 0; irow < nrows; irow++)
+		appendPQExpBuffer(&addstr, "%sselect * from _i" FORMAT_POSIROW, irow ? " union all " : " ", irow);
+	if (PQExpBufferDataBroken(addstr))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_add_rows()", func);
+		goto cleanup;
+	}
+	MYLOG(0, "addstr=%s\n", addstr.data);
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	ret = PGAPI_ExecDirect(qstmt, (SQLCHAR *) addstr.data, SQL_NTS, 0);
+	ires = SC_get_Curres(qstmt);
+	tres = ires ? (QR_nextr(ires) ? QR_nextr(ires) : ires) : NULL;
+	if (SQL_ERROR == ret || !QR_command_maybe_successful(tres))
+	{
+		ret = SQL_ERROR;
+		SC_error_copy(stmt, qstmt, TRUE);
+		if (0 == SC_get_errornumber(stmt))
+			SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "bulk insert return error", func);
+		for (irow = 0; irow < nrows; irow++)
+			set_row_status(stmt, irow, SQL_ROW_ERROR);
+		goto cleanup;
+	}
+	naddcnt = QR_get_num_cached_tuples(tres);
+	for (i = 0; i < naddcnt; i++)
+	{
+		TupleField	*tuple = tres->backend_tuples + QR_NumResultCols(tres) * i;
+
+		row = atol(tuple[0].value);
+		if (row < 0 || row >= (SQLLEN) nrows || BULK_AFFECTED == state[row])
+			continue;
+		KeySetSet(tuple + 1, QR_NumResultCols(tres) - 1, QR_NumResultCols(tres) - 1, &keyset, TRUE);
+		set_reload_key(keys + nadded++, &keyset, row);
+		state[row] = BULK_AFFECTED;
+	}
+	if (nadded > 0)
+	{
+		/* the WITH query isn't recognized as an INSERT */
+		NAME_TO_NAME(conn->schemaIns, ti->schema_name);
+		NAME_TO_NAME(conn->tableIns, ti->table_name);
+		qres = load_by_keys(stmt, "", NULL, keys, nadded);
+		if (!QR_command_maybe_successful(qres) ||
+		    NULL == (sorted = sort_loaded_rows(qres)))
+		{
+			QR_Destructor(qres);
+			qres = NULL;
+		}
+	}
+
+	/* the same bookkeeping as pos_add_callback() per row */
+	brow_save = stmt->bind_row;
+	for (irow = 0; irow < nrows; irow++)
+	{
+		if (BULK_AFFECTED != state[irow])
+		{
+			/* e.g. a BEFORE INSERT trigger returned NULL */
+			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the row was not inserted", func);
+			set_row_status(stmt, irow, SQL_ROW_ERROR);
+			if (SQL_SUCCESS == ret)
+				ret = SQL_SUCCESS_WITH_INFO;
+			continue;
+		}
+		for (i = 0; i < nadded && keys[i].pos != (SQLLEN) irow; i++)
+			;
+		keyset.oid = keys[i].oid;
+		keyset.blocknum = keys[i].blocknum;
+		keyset.offset = keys[i].offset;
+		keyset.status = 0;
+		if (QR_get_cursor(res))
+			addpos = -(SQLLEN)(res->ad_count + 1);
+		else
+			addpos = QR_get_num_total_tuples(res);
+		lidx = qres ? find_loaded_row(qres, sorted, &keyset) : -1;
+		if (lidx >= 0)
+			qret = pos_newload_tuple(stmt, res, qres, qres->backend_tuples + qres->num_fields * lidx);
+		else
+		{
+			SPRINTF_FIXED(tidv, "(%u,%hu)", keyset.blocknum, keyset.offset);
+			qret = SC_pos_newload(stmt, 0 != keyset.oid ? &keyset.oid : NULL, TRUE, tidv);
+		}
+		if (SQL_ERROR == qret)
+		{
+			ret = SQL_ERROR;
+			set_row_status(stmt, irow, SQL_ROW_ERROR);
+			continue;
+		}
+		if (opts->bookmark && opts->bookmark->buffer)
+		{
+			stmt->bind_row = irow;
+			SC_set_current_col(stmt, -1);
+			SC_Create_bookmark(stmt, opts->bookmark, irow, addpos, &keyset);
+		}
+		if (SQL_SUCCESS == qret && res->keyset)
+		{
+			kres_ridx = GIdx2KResIdx(QR_get_num_total_tuples(res) - 1, stmt, res);
+			if (kres_ridx >= 0 && kres_ridx < res->num_cached_keys)
+			{
+				if (CC_is_in_trans(conn))
+					res->keyset[kres_ridx].status = (SQL_ROW_ADDED | CURS_SELF_ADDING);
+				else
+					res->keyset[kres_ridx].status = (SQL_ROW_ADDED | CURS_SELF_ADDED);
+			}
+		}
+		if (SQL_SUCCESS == qret)
+			set_row_status(stmt, irow, SQL_ROW_ADDED);
+		else
+		{
+			set_row_status(stmt, irow, SQL_ROW_SUCCESS_WITH_INFO);
+			if (SQL_SUCCESS == ret)
+				ret = SQL_SUCCESS_WITH_INFO;
+		}
+		(*processed)++;
+	}
+	stmt->bind_row = brow_save;
+
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+	if (qstmt)
+		PGAPI_FreeStmt(qstmt, SQL_DROP);
+	if (!PQExpBufferDataBroken(addstr))
+		termPQExpBuffer(&addstr);
+	QR_Destructor(qres);
+	if (keys)
+		free(keys);
+	if (sorted)
+		free(sorted);
+	if (ordinals)
+		free(ordinals);
+	if (state)
+		free(state);
+	if (cols)
+		free(cols);
+	return ret;
+}
+
 /*
  *	Stuff for updatable cursors end.
  */
@@ -173,6 +173,11 @@ static const struct
 };
 
 static QResultClass *libpq_bind_and_exec(StatementClass *stmt);
+#ifdef	LIBPQ_HAS_PIPELINING
+static QResultClass *libpq_pipeline_exec(StatementClass *stmt);
+#endif /* LIBPQ_HAS_PIPELINING */
+static QResultClass *libpq_copy_insert_exec(StatementClass *stmt);
+static QResultClass *libpq_copy_stream_exec(StatementClass *stmt);
 static void SC_set_errorinfo(StatementClass *self, QResultClass *res, int errkind);
 static void SC_set_error_if_not_set(StatementClass *self, int errornumber, const char *errmsg, const char *func);
 
@@ -407,6 +412,7 @@ SC_Constructor(ConnectionClass *conn)
 		rv->plan_name = NULL;
 		rv->transition_status = STMT_TRANSITION_UNALLOCATED;
 		rv->multi_statement = -1; /* unknown */
+		rv->copy_insert_rules = -1; /* unknown */
 		rv->num_params = -1; /* unknown */
 		rv->processed_statements = NULL;
 
@@ -473,6 +479,8 @@ SC_Constructor(ConnectionClass *conn)
 		rv->num_callbacks = 0;
 		rv->callbacks = NULL;
 		GetDataInfoInitialize(SC_get_GDTI(rv));
+		rv->col_plans = NULL;
+		rv->num_col_plans = 0;
 		PutDataInfoInitialize(SC_get_PDTI(rv));
 		rv->use_server_side_prepare = conn->connInfo.use_server_side_prepare;
 		rv->lock_CC_for_rb = FALSE;
@@ -482,6 +490,9 @@ SC_Constructor(ConnectionClass *conn)
 			rv->batch_size = 1;
 		rv->exec_type = DIRECT_EXEC;
 		rv->count_of_deffered = 0;
+		rv->async_exec = ASYNC_EXEC_NONE;
+		rv->async_in_trans = FALSE;
+		rv->async_res = NULL;
 		rv->has_notice = 0;
 		INIT_STMT_CS(rv);
 	}
@@ -536,6 +547,8 @@ SC_Destructor(StatementClass *self)
 	cancelNeedDataState(self);
 	if (self->callbacks)
 		free(self->callbacks);
+	if (self->col_plans)
+		free(self->col_plans);
 	if (!PQExpBufferDataBroken(self->stmt_deferred))
 		termPQExpBuffer(&self->stmt_deferred);
 
@@ -712,7 +725,9 @@ SC_set_prepared(StatementClass *stmt, int prepared)
 		if (conn)
 		{
 			ENTER_CONN_CS(conn);
-			if (CONN_CONNECTED == conn->status)
+			if (CC_release_prepared(conn, stmt->plan_name))
+				;	/* the plan is kept in the cache */
+			else if (CONN_CONNECTED == conn->status)
 			{
 				if (CC_is_in_error_trans(conn))
 				{
@@ -777,6 +792,7 @@ SC_initialize_stmts(StatementClass *self, BOOL initializeOriginal)
 		SC_set_prepared(self, NOT_YET_PREPARED);
 		self->statement_type = STMT_TYPE_UNKNOWN; /* unknown */
 		self->multi_statement = -1; /* unknown */
+		self->copy_insert_rules = -1; /* unknown */
 		self->num_params = -1; /* unknown */
 		self->proc_return = -1; /* unknown */
 		self->join_info = 0;
@@ -1699,6 +1715,7 @@ SC_fetch(StatementClass *self)
 	OID			type;
 	int		atttypmod;
 	char	   *value;
+	SQLLEN		valuelen;
 	ColumnInfoClass *coli;
 	BindInfoClass	*bookmark;
 	BOOL		useCursor;
@@ -1829,18 +1846,25 @@ MYLOG(DETAIL_LOG_LEVEL, "stmt=%p ommitted++\n", self);
 			MYLOG(0, "type = %d, atttypmod = %d\n", type, atttypmod);
 
 			if (useCursor)
+			{
 				value = QR_get_value_backend(res, lf);
+				valuelen = QR_get_value_length(res, lf);
+			}
 			else
 			{
 				SQLLEN	curt = GIdx2CacheIdx(self->currTuple, self, res);
 MYLOG(DETAIL_LOG_LEVEL, "%p->base=" FORMAT_LEN " curr=" FORMAT_LEN " st=" FORMAT_LEN " valid=%d\n", res, QR_get_rowstart_in_cache(res), self->currTuple, SC_get_rowset_start(self), QR_has_valid_base(res));
 MYLOG(DETAIL_LOG_LEVEL, "curt=" FORMAT_LEN "\n", curt);
 				value = QR_get_value_backend_row(res, curt, lf);
+				valuelen = QR_get_value_length_row(res, curt, lf);
 			}
 
-			MYLOG(0, "value = '%s'\n", (value == NULL) ? "<NULL>" : value);
+			if (CI_get_format(coli, lf))
+				MYLOG(0, "value = <binary>(" FORMAT_LEN ")\n", valuelen);
+			else
+				MYLOG(0, "value = '%s'\n", (value == NULL) ? "<NULL>" : value);
 
-			retval = copy_and_convert_field_bindinfo(self, type, atttypmod, value, lf);
+			retval = copy_and_convert_field_bindinfo(self, type, atttypmod, value, valuelen, CI_get_format(coli, lf), lf);
 
 			MYLOG(0, "copy_and_convert: retval = %d\n", retval);
 
@@ -1893,6 +1917,85 @@ MYLOG(DETAIL_LOG_LEVEL, "curt=" FORMAT_LEN "\n", curt);
 }
 
 
+/*
+ *	Fetch up to nrows rows for the column-wise binding.
+ *
+ *	Each bound column is converted across the rows in one go, instead of
+ *	each row looping over the bound columns as SC_fetch() does. This is
+ *	only for the results read into the cache completely: no cursor, COPY
+ *	stream nor keyset, no bookmark and retrieve_data on.
+ *	Returns the number of the rows fetched, or -1 if the rows should be
+ *	fetched one by one with SC_fetch(), which also reports their errors.
+ */
+SQLLEN
+SC_fetch_by_column(StatementClass *self, SQLLEN nrows, BOOL *truncated)
+{
+	CSTR func = "SC_fetch_by_column";
+	QResultClass *res = SC_get_Curres(self);
+	ARDFields	*opts = SC_get_ARDF(self);
+	GetDataInfo	*gdata;
+	ColumnInfoClass *coli;
+	const TupleField *tuple;
+	SQLLEN		avail, curt;
+	Int2		num_cols, lf;
+
+	*truncated = FALSE;
+	/* only the results whose rows have all been read */
+	if (!res || QR_haskeyset(res) || QR_is_spilled(res) ||
+	    QR_is_copy_stream(res) || !QR_once_reached_eof(res) ||
+	    (SC_is_fetchcursor(self) && NULL != QR_get_cursor(res)))
+		return -1;
+	if (opts->bind_size > 0 ||
+	    (opts->bookmark && opts->bookmark->buffer) ||
+	    SQL_RD_OFF == self->options.retrieve_data ||
+	    NULL == opts->bindings)
+		return -1;
+	avail = QR_get_num_total_tuples(res) - 1 - self->currTuple;
+	if (self->options.maxRows > 0 &&
+	    self->options.maxRows - 1 - self->currTuple < avail)
+		avail = self->options.maxRows - 1 - self->currTuple;
+	if (nrows > avail)
+		nrows = avail;
+	curt = GIdx2CacheIdx(self->currTuple + 1, self, res);
+	if (nrows < 2 || curt < 0 || curt + nrows > QR_get_num_cached_tuples(res))
+		return -1;
+	MYLOG(0, "fetching " FORMAT_LEN " rows from " FORMAT_LEN "\n", nrows, curt);
+
+	num_cols = QR_NumPublicResultCols(res);
+	if (opts->allocated < num_cols)
+		extend_column_bindings(opts, num_cols);
+	gdata = SC_get_GDTI(self);
+	if (gdata->allocated != opts->allocated)
+		extend_getdata_info(gdata, opts->allocated, TRUE);
+	coli = QR_get_fields(res);
+	tuple = QR_get_tuple(res, curt);
+	for (lf = 0; lf < num_cols; lf++)
+	{
+		/* reset for SQLGetData */
+		GETDATA_RESET(gdata->gdata[lf]);
+
+		if (NULL == opts->bindings[lf].buffer)
+			continue;
+		switch (copy_and_convert_column(self, CI_get_oid(coli, lf), CI_get_atttypmod(coli, lf), CI_get_format(coli, lf), lf, tuple + lf, res->num_fields, nrows))
+		{
+			case COPY_OK:
+				break;
+			case COPY_RESULT_TRUNCATED:
+				*truncated = TRUE;
+				break;
+			default:
+				return -1;
+		}
+	}
+	if (*truncated)
+		SC_set_error(self, STMT_TRUNCATED, "Fetched item was truncated.", func);
+
+	self->currTuple += nrows;
+	self->last_fetch_count = self->last_fetch_count_include_ommitted = nrows;
+
+	return nrows;
+}
+
 #include "dlg_specific.h"
 RETCODE
 SC_execute(StatementClass *self)
@@ -1936,6 +2039,17 @@ SC_execute(StatementClass *self)
 	 */
 #define	return	DONT_CALL_RETURN_FROM_HERE???
 	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	if (ASYNC_EXEC_READY == self->async_exec)
+	{
+		/*
+		 * The results of the asynchronous execution have arrived.
+		 * The first call has done everything up to sending the query.
+		 */
+		oldstatus = CONN_CONNECTED;
+		is_in_trans = self->async_in_trans;
+		issue_begin = useCursor = FALSE;
+		goto resume_async;
+	}
 	oldstatus = conn->status;
 	if (CONN_EXECUTING == conn->status)
 	{
@@ -2017,6 +2131,7 @@ SC_execute(StatementClass *self)
 		SC_set_error(self, STMT_OPERATION_CANCELLED, "Cancel Request Accepted", func);
 		goto cleanup;
 	}
+resume_async:
 	conn->status = CONN_EXECUTING;
 
 	/* If it's a SELECT statement, use a cursor. */
@@ -2040,9 +2155,23 @@ SC_execute(StatementClass *self)
 		if (issue_begin)
 			CC_begin(conn);
 
+#ifdef	LIBPQ_HAS_PIPELINING
+		if (PIPELINE_EXEC == self->exec_type)
+			first = libpq_pipeline_exec(self);
+		else
+#endif /* LIBPQ_HAS_PIPELINING */
+		if (COPY_EXEC == self->exec_type)
+			first = libpq_copy_insert_exec(self);
+		else
 		first = libpq_bind_and_exec(self);
 		if (!first)
 		{
+			/* the query was sent asynchronously */
+			if (ASYNC_EXEC_SENT == self->async_exec)
+			{
+				self->async_in_trans = is_in_trans;
+				goto cleanup;
+			}
 			if (SC_get_errornumber(self) <= 0)
 			{
 				SC_set_error(self, STMT_NO_RESPONSE, "Could not receive the response, communication down ??", func);
@@ -2050,6 +2179,15 @@ SC_execute(StatementClass *self)
 			goto cleanup;
 		}
 		rhold.first = rhold.last = first;
+		/* the pipelined execution may return a list of results */
+		while (QR_nextr(rhold.last))
+			rhold.last = QR_nextr(rhold.last);
+	}
+	else if (SC_is_copystream(self) &&
+		 NULL != (rhold.first = libpq_copy_stream_exec(self)))
+	{
+		MYLOG(0, "       reading the rows of stmt=%p through COPY\n", self);
+		rhold.last = rhold.first;
 	}
 	else if (isSelectType)
 	{
@@ -2066,7 +2204,7 @@ SC_execute(StatementClass *self)
 		{
 			qi.result_in = NULL;
 			qi.cursor = SC_cursor_name(self);
-			qi.fetch_size = qi.row_size = ci->drivers.fetch_max;
+			qi.fetch_size = qi.row_size = CC_first_fetch_size(conn);
 			SPRINTF_FIXED(fetch,
 					 "fetch " FORMAT_LEN " in \"%s\"",
 					 qi.fetch_size, SC_cursor_name(self));
@@ -2365,7 +2503,7 @@ MYLOG(DETAIL_LOG_LEVEL, "!!SC_fetch return =%d\n", ret);
 					SC_set_fetchcursor(self);
 					qi.result_in = NULL;
 					qi.cursor = SC_cursor_name(self);
-					qi.fetch_size = qi.row_size = ci->drivers.fetch_max;
+					qi.fetch_size = qi.row_size = CC_first_fetch_size(conn);
 					SPRINTF_FIXED(fetch, "fetch " FORMAT_LEN " in \"%s\"", qi.fetch_size, SC_cursor_name(self));
 					res = CC_send_query(conn, fetch, &qi, qflag | READ_ONLY_QUERY, SC_get_ancestor(self));
 					if (NULL != res)
@@ -2403,6 +2541,17 @@ MYLOG(DETAIL_LOG_LEVEL, "!!SC_fetch return =%d\n", ret);
 	}
 cleanup:
 #undef	return
+	if (ASYNC_EXEC_SENT == self->async_exec)
+	{
+		/*
+		 * The statement and the connection stay busy until the
+		 * application polls the results.
+		 */
+		CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+		if (NULL != errmsg_sav)
+			free(errmsg_sav);
+		return SQL_STILL_EXECUTING;
+	}
 	SC_SetExecuting(self, FALSE);
 	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
 	if (CONN_DOWN != conn->status)
@@ -2565,6 +2714,14 @@ RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
 		SC_set_error(stmt, STMT_COMMUNICATION_ERROR, "The connection has been lost", __FUNCTION__);
 		return SQL_ERROR;
 	}
+	if (NULL != conn->async_stmt)
+	{
+		SC_set_error(stmt, STMT_SEQUENCE_ERROR, "The connection is busy with an asynchronous execution", func);
+		return FALSE;
+	}
+	CC_complete_copy_stream(conn);
+	CC_complete_read_ahead(conn);
+	conn->session_changed = TRUE;
 	if (CC_started_rbpoint(conn))
 		return TRUE;
 	if (SC_is_readonly(stmt))
@@ -2613,6 +2770,27 @@ static void log_params(int nParams, const Oid *paramTypes, const UCHAR * const *
 	}
 }
 
+static void free_libpq_bind_params(int nParams, Oid *paramTypes, char **paramValues, int *paramLengths, int *paramFormats)
+{
+	int	i;
+
+	if (paramValues)
+	{
+		for (i = 0; i < nParams; i++)
+		{
+			if (paramValues[i] != NULL)
+				free(paramValues[i]);
+		}
+		free(paramValues);
+	}
+	if (paramTypes)
+		free(paramTypes);
+	if (paramLengths)
+		free(paramLengths);
+	if (paramFormats)
+		free(paramFormats);
+}
+
 static
 QResultClass *add_libpq_notice_receiver(StatementClass *stmt, notice_receiver_arg *nrarg)
 {
@@ -2628,6 +2806,33 @@ QResultClass *add_libpq_notice_receiver(StatementClass *stmt, notice_receiver_ar
 	return newres;
 }
 
+/*
+ * Collect the results of a query sent by PQsendQuery*() the same way
+ * PQexec*() does, i.e. return the last one.
+ */
+static PGresult *
+libpq_async_result(PGconn *pqconn)
+{
+	PGresult   *pgres, *last = NULL;
+
+	while (NULL != (pgres = PQgetResult(pqconn)))
+	{
+		if (NULL != last)
+			PQclear(last);
+		last = pgres;
+		switch (PQresultStatus(pgres))
+		{
+			case PGRES_COPY_IN:
+			case PGRES_COPY_OUT:
+			case PGRES_COPY_BOTH:
+				return last;
+			default:
+				break;
+		}
+	}
+	return last;
+}
+
 static QResultClass *
 libpq_bind_and_exec(StatementClass *stmt)
 {
@@ -2646,6 +2851,26 @@ libpq_bind_and_exec(StatementClass *stmt)
 	char	   *cmdtag;
 	char	   *rowcount;
 	notice_receiver_arg	nrarg;
+	BOOL		async_send = FALSE;
+	int			sent = 0;
+
+	if (ASYNC_EXEC_READY == stmt->async_exec)
+	{
+		/* The results of the asynchronous execution have arrived */
+		nParams = 0;
+		newres = stmt->async_res;
+		stmt->async_res = NULL;
+		conn->async_stmt = NULL;
+		nrarg.conn = conn;
+		nrarg.comment = func;
+		nrarg.res = newres;
+		nrarg.stmt = stmt;
+		PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, &nrarg);
+		pgres = libpq_async_result(conn->pqconn);
+		PQsetnonblocking(conn->pqconn, 0);
+		stmt->async_exec = ASYNC_EXEC_NONE;
+		goto async_results;
+	}
 
 	if (!RequestStart(stmt, conn, func))
 		return NULL;
@@ -2686,6 +2911,9 @@ libpq_bind_and_exec(StatementClass *stmt)
 			goto cleanup;
 		}
 	}
+	async_send = (ASYNC_EXEC_REQUESTED == stmt->async_exec &&
+				  !SC_is_fetchcursor(stmt) &&
+				  0 == PQsetnonblocking(conn->pqconn, 1));
 
 	/* 2.5 Prepare and Describe if needed */
 	if (stmt->prepared == PREPARING_TEMPORARILY ||
@@ -2700,18 +2928,28 @@ libpq_bind_and_exec(StatementClass *stmt)
 		}
 
 		pstmt = stmt->processed_statements;
-		QLOG(0, "PQexecParams: %p '%s' nParams=%d\n", conn->pqconn, pstmt->query, nParams);
+		QLOG(0, "%s: %p '%s' nParams=%d\n", async_send ? "PQsendQueryParams" : "PQexecParams", conn->pqconn, pstmt->query, nParams);
 		log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
 		/* set notice receiver */
 		newres = add_libpq_notice_receiver(stmt, &nrarg);
-		pgres = PQexecParams(conn->pqconn,
-							 pstmt->query,
-							 nParams,
-							 paramTypes,
-							 (const char **) paramValues,
-							 paramLengths,
-							 paramFormats,
-							 resultFormat);
+		if (async_send)
+			sent = PQsendQueryParams(conn->pqconn,
+									 pstmt->query,
+									 nParams,
+									 paramTypes,
+									 (const char **) paramValues,
+									 paramLengths,
+									 paramFormats,
+									 resultFormat);
+		else
+			pgres = PQexecParams(conn->pqconn,
+								 pstmt->query,
+								 nParams,
+								 paramTypes,
+								 (const char **) paramValues,
+								 paramLengths,
+								 paramFormats,
+								 resultFormat);
 	}
 	else
 	{
@@ -2727,16 +2965,40 @@ libpq_bind_and_exec(StatementClass *stmt)
 		plan_name = stmt->plan_name ? stmt->plan_name : NULL_STRING;
 
 		/* already prepared */
-		QLOG(0, "PQexecPrepared: %p plan=%s nParams=%d\n", conn->pqconn, plan_name, nParams);
+		QLOG(0, "%s: %p plan=%s nParams=%d\n", async_send ? "PQsendQueryPrepared" : "PQexecPrepared", conn->pqconn, plan_name, nParams);
 		log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
 		/* set notice receiver */
 		newres = add_libpq_notice_receiver(stmt, &nrarg);
-		pgres = PQexecPrepared(conn->pqconn,
-							   plan_name, 	/* portal name == plan name */
-							   nParams,
-							   (const char **) paramValues, paramLengths, paramFormats,
-							   resultFormat);
+		if (async_send)
+			sent = PQsendQueryPrepared(conn->pqconn,
+									   plan_name,
+									   nParams,
+									   (const char **) paramValues, paramLengths, paramFormats,
+									   resultFormat);
+		else
+			pgres = PQexecPrepared(conn->pqconn,
+								   plan_name, 	/* portal name == plan name */
+								   nParams,
+								   (const char **) paramValues, paramLengths, paramFormats,
+								   resultFormat);
 	}
+	if (async_send)
+	{
+		/* the notices are collected by SC_async_exec_ready() from now on */
+		PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+		if (!sent || PQflush(conn->pqconn) < 0)
+		{
+			SC_set_error(stmt, STMT_EXEC_ERROR, PQerrorMessage(conn->pqconn), func);
+			QR_Destructor(newres);
+			goto cleanup;
+		}
+		MYLOG(0, "stmt=%p is executing asynchronously\n", stmt);
+		stmt->async_res = newres;
+		stmt->async_exec = ASYNC_EXEC_SENT;
+		conn->async_stmt = stmt;
+		goto cleanup;
+	}
+async_results:
 	/* reset notice receiver */
 	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
 	if (!(res = nrarg.res))
@@ -2756,6 +3018,7 @@ MYLOG(DETAIL_LOG_LEVEL, "get_Result=%p %p\n", res, SC_get_Result(stmt));
 			cmdtag = PQcmdStatus(pgres);
 			QLOG(0, "\tok: - 'C' - %s\n", cmdtag);
 			QR_set_command(res, cmdtag);
+			CC_check_statement_caches(conn, cmdtag, stmt->statement);
 			if (QR_command_successful(res))
 				QR_set_rstatus(res, PORES_COMMAND_OK);
 
@@ -2808,136 +3071,1021 @@ MYLOG(DETAIL_LOG_LEVEL, "get_Result=%p %p\n", res, SC_get_Result(stmt));
 		QR_Destructor(newres);
 
 cleanup:
+	/* back to blocking mode unless the query is in flight */
+	if (async_send && ASYNC_EXEC_SENT != stmt->async_exec)
+		PQsetnonblocking(conn->pqconn, 0);
 	if (pgres)
 		PQclear(pgres);
-	if (paramValues)
-	{
-		int			i;
-		for (i = 0; i < nParams; i++)
-		{
-			if (paramValues[i] != NULL)
-				free(paramValues[i]);
-		}
-		free(paramValues);
-	}
-	if (paramTypes)
-		free(paramTypes);
-	if (paramLengths)
-		free(paramLengths);
-	if (paramFormats)
-		free(paramFormats);
+	free_libpq_bind_params(nParams, paramTypes, paramValues, paramLengths, paramFormats);
 
 	return res;
 }
 
+#ifdef	LIBPQ_HAS_PIPELINING
+#define	PARAM_ROW_IGNORED(apdopts, row) \
+	((apdopts)->param_operation_ptr && \
+	 SQL_PARAM_IGNORE == (apdopts)->param_operation_ptr[row])
+
 /*
- * Parse a query using libpq.
+ * Execute the statement for every row of the parameter array in libpq
+ * pipeline mode.
  *
- * 'res' is only passed here for error reporting purposes. If an error is
- * encountered, it is set in 'res', and the function returns FALSE.
+ * The rows are sent in segments of batch_size rows terminated by a Sync
+ * and the results of a segment are read before the next one is sent.
+ * The server runs each segment in an implicit transaction (or in the
+ * current one), so an error aborts the whole segment: all of its rows
+ * are reported as SQL_PARAM_ERROR and the remaining rows are left
+ * SQL_PARAM_UNUSED, the same as with the ';'-concatenated batches.
+ *
+ * The first result returned holds the last command tag and the total
+ * number of processed rows. Rows returning tuples (RETURNING) append
+ * their result sets to it.
  */
-static BOOL
-ParseWithLibpq(StatementClass *stmt, const char *plan_name,
-			   const char *query,
-			   Int2 num_params, const char *comment, QResultClass *res)
+static QResultClass *
+libpq_pipeline_exec(StatementClass *stmt)
 {
-	CSTR	func = "ParseWithLibpq";
+	CSTR		func = "libpq_pipeline_exec";
 	ConnectionClass	*conn = SC_get_conn(stmt);
-	Int4		sta_pidx = -1, end_pidx = -1;
-	const char	*cstatus;
+	APDFields	*apdopts = SC_get_APDF(stmt);
+	IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	SQLUSMALLINT	*param_status = ipdopts->param_status_ptr;
+	SQLLEN		start_row, end_row, seg_start, row, rrow;
+	int			nParams = 0;
 	Oid		   *paramTypes = NULL;
-	BOOL		retval = FALSE;
+	char	  **paramValues = NULL;
+	int		   *paramLengths = NULL;
+	int		   *paramFormats = NULL;
+	int			resultFormat;
+	int			nsent, nread, sent;
 	PGresult   *pgres = NULL;
+	ProcessedStmt *pstmt = NULL;
+	const char *plan_name = NULL;
+	QResultClass	*res, *last, *tres;
+	char	   *cmdtag;
+	char	   *rowcount;
+	SQLLEN		total_count = 0;
+	BOOL		failed = FALSE, any_notice = FALSE, row_failed;
+	notice_receiver_arg	nrarg;
 
-	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query);
 	if (!RequestStart(stmt, conn, func))
-		return FALSE;
+		return NULL;
 
-	if (stmt->discard_output_params)
-		num_params = 0;
-	else if (num_params != 0)
+	start_row = stmt->exec_current_row;
+	if (end_row = stmt->exec_end_row, end_row < 0)
+		end_row = (SQLINTEGER) apdopts->paramset_size - 1;
+
+	/* Prepare if needed, the same way as libpq_bind_and_exec() */
+	if (stmt->prepared == PREPARING_TEMPORARILY ||
+		(stmt->prepared == PREPARED_TEMPORARILY && conn->unnamed_prepared_stmt != stmt))
 	{
-#ifdef	NOT_USED
-		sta_pidx += stmt->proc_return;
-#endif /* NOT_USED */
-		int	pidx;
+		if (!stmt->processed_statements)
+		{
+			if (prepareParametersNoDesc(stmt, FALSE, EXEC_PARAM_CAST) == SQL_ERROR)
+				return NULL;
+		}
+		pstmt = stmt->processed_statements;
+	}
+	else
+	{
+		if (stmt->prepared == PREPARING_PERMANENTLY)
+		{
+			if (prepareParameters(stmt, FALSE) == SQL_ERROR)
+				return NULL;
+		}
+		plan_name = stmt->plan_name ? stmt->plan_name : NULL_STRING;
+	}
 
-		sta_pidx = stmt->current_exec_param;
-		if (num_params < 0)
-			end_pidx = stmt->num_params - 1;
-		else
-			end_pidx = sta_pidx + num_params - 1;
-#ifdef	NOT_USED
-		num_params = end_pidx - sta_pidx + 1;
-#endif /* NOT_USED */
-		for (num_params = 0, pidx = sta_pidx - 1;;)
+	/* set notice receiver */
+	if (res = add_libpq_notice_receiver(stmt, &nrarg), NULL == res)
+	{
+		PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
+		return NULL;
+	}
+	last = res;
+	QLOG(0, "PQenterPipelineMode: %p\n", conn->pqconn);
+	if (!PQenterPipelineMode(conn->pqconn))
+	{
+		PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+		QR_Destructor(res);
+		SC_set_error(stmt, STMT_EXEC_ERROR, PQerrorMessage(conn->pqconn), func);
+		return NULL;
+	}
+
+	for (seg_start = start_row; seg_start <= end_row && !failed; seg_start = row)
+	{
+		/* 1. Send a segment */
+		for (row = seg_start, nsent = 0; row <= end_row && nsent < stmt->batch_size; row++)
 		{
-			SC_param_next(stmt, &pidx, NULL, NULL);
-			if (pidx > end_pidx)
+			if (PARAM_ROW_IGNORED(apdopts, row))
+				continue;
+			stmt->exec_current_row = row;
+			/* the caller has counted the first row */
+			if (row > start_row && ipdopts->param_processed_ptr)
+				(*ipdopts->param_processed_ptr)++;
+			if (param_status)
+				param_status[row] = SQL_PARAM_ERROR;
+			if (!build_libpq_bind_params(stmt,
+										 &nParams,
+										 &paramTypes,
+										 &paramValues,
+										 &paramLengths, &paramFormats,
+										 &resultFormat))
+			{
+				if (SC_get_errornumber(stmt) <= 0)
+					SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
+				failed = TRUE;
 				break;
-			else if (pidx < end_pidx)
+			}
+			if (pstmt)
 			{
-				if (0 == num_params)
-					sta_pidx = pidx;
-				num_params++;
+				QLOG(0, "PQsendQueryParams: %p '%s' nParams=%d\n", conn->pqconn, pstmt->query, nParams);
+				log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
+				sent = PQsendQueryParams(conn->pqconn,
+										 pstmt->query,
+										 nParams,
+										 paramTypes,
+										 (const char **) paramValues,
+										 paramLengths,
+										 paramFormats,
+										 resultFormat);
 			}
 			else
 			{
-				num_params++;
+				QLOG(0, "PQsendQueryPrepared: %p plan=%s nParams=%d\n", conn->pqconn, plan_name, nParams);
+				log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
+				sent = PQsendQueryPrepared(conn->pqconn,
+										   plan_name,
+										   nParams,
+										   (const char **) paramValues, paramLengths, paramFormats,
+										   resultFormat);
+			}
+			free_libpq_bind_params(nParams, paramTypes, paramValues, paramLengths, paramFormats);
+			paramTypes = NULL;
+			paramValues = NULL;
+			paramLengths = NULL;
+			paramFormats = NULL;
+			if (!sent)
+			{
+				CC_set_error(conn, CONNECTION_COMMUNICATION_ERROR, PQerrorMessage(conn->pqconn), func);
+				QR_set_rstatus(res, PORES_FATAL_ERROR);
+				failed = TRUE;
 				break;
 			}
+			nsent++;
 		}
-MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
-	}
-
-	/*
-	 * We let the server deduce the right datatype for the parameters, except
-	 * for out parameters, which are sent as VOID.
-	 */
-	if (num_params > 0)
-	{
-		int	i;
-		int j;
-		IPDFields	*ipdopts = SC_get_IPDF(stmt);
-
-		paramTypes = malloc(sizeof(Oid) * num_params);
-		if (paramTypes == NULL)
+		if (failed && row <= end_row)
+			row++;	/* the failed row belongs to this segment */
+		if (0 == nsent)
+			break;
+		if (!PQpipelineSync(conn->pqconn))
 		{
-			SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
-			goto cleanup;
+			CC_set_error(conn, CONNECTION_COMMUNICATION_ERROR, PQerrorMessage(conn->pqconn), func);
+			CC_on_abort(conn, CONN_DEAD);
+			QR_set_rstatus(res, PORES_FATAL_ERROR);
+			failed = TRUE;
+			break;
 		}
 
-		MYLOG(0, "ipdopts->allocated: %d\n", ipdopts->allocated);
-		j = 0;
-		for (i = sta_pidx; i <= end_pidx; i++)
+		/* 2. Receive the results of the segment */
+		for (rrow = seg_start, nread = 0; nread < nsent; rrow++)
 		{
-			if (i < ipdopts->allocated)
+			if (PARAM_ROW_IGNORED(apdopts, rrow))
+				continue;
+			nread++;
+			row_failed = FALSE;
+			stmt->has_notice = 0;
+			if (pgres = PQgetResult(conn->pqconn), NULL == pgres)
 			{
-				if (SQL_PARAM_OUTPUT == ipdopts->parameters[i].paramType)
-					paramTypes[j++] = PG_TYPE_VOID;
-				else
-					paramTypes[j++] = sqltype_to_bind_pgtype(conn,
-															 ipdopts->parameters[i].SQLType);
+				CC_set_error(conn, CONNECTION_NO_RESPONSE, "Could not receive the response, communication down ??", func);
+				CC_on_abort(conn, CONN_DEAD);
+				QR_set_rstatus(res, PORES_FATAL_ERROR);
+				failed = TRUE;
+				break;
 			}
-			else
+			switch (PQresultStatus(pgres))
 			{
-				/* Unknown type of parameter. Let the server decide */
-				paramTypes[j++] = 0;
+				case PGRES_COMMAND_OK:
+					cmdtag = PQcmdStatus(pgres);
+					QLOG(0, "\tok: - 'C' - %s\n", cmdtag);
+					QR_set_command(res, cmdtag);
+					rowcount = PQcmdTuples(pgres);
+					if (rowcount && rowcount[0])
+						total_count += pg_atoi(rowcount);
+					break;
+				case PGRES_TUPLES_OK:
+					if (tres = QR_Constructor(), NULL == tres)
+					{
+						QR_set_rstatus(res, PORES_FATAL_ERROR);
+						row_failed = TRUE;
+						break;
+					}
+					QR_concat(last, tres);
+					last = tres;
+					if (!QR_from_PGresult(tres, stmt, conn, NULL, &pgres))
+						row_failed = TRUE;
+					break;
+				case PGRES_EMPTY_QUERY:
+					break;
+				case PGRES_NONFATAL_ERROR:
+					handle_pgres_error(conn, pgres, func, res, FALSE);
+					break;
+				case PGRES_PIPELINE_ABORTED:
+					/* skipped because of an error in a previous row */
+					row_failed = TRUE;
+					break;
+				case PGRES_BAD_RESPONSE:
+				case PGRES_FATAL_ERROR:
+					handle_pgres_error(conn, pgres, func, res, TRUE);
+					row_failed = TRUE;
+					break;
+				default:
+					QR_set_rstatus(res, PORES_BAD_RESPONSE);
+					CC_set_error(conn, CONNECTION_BACKEND_CRAZY, "Unexpected result status in pipeline mode", func);
+					QLOG(0, "PQgetResult error: - (%d) - %s\n", PQresultStatus(pgres), CC_get_errormsg(conn));
+					row_failed = TRUE;
+					break;
+			}
+			if (pgres)
+			{
+				PQclear(pgres);
+				pgres = NULL;
+			}
+			/* consume the end of the results of this query */
+			while (pgres = PQgetResult(conn->pqconn), NULL != pgres)
+			{
+				PQclear(pgres);
+				pgres = NULL;
+			}
+			if (row_failed)
+				failed = TRUE;
+			else if (param_status)
+				param_status[rrow] = stmt->has_notice ? SQL_PARAM_SUCCESS_WITH_INFO : SQL_PARAM_SUCCESS;
+			if (stmt->has_notice)
+				any_notice = TRUE;
+		}
+		if (nread < nsent)
+			break;	/* the connection is broken */
+		if (pgres = PQgetResult(conn->pqconn), NULL != pgres)
+		{
+			if (PGRES_PIPELINE_SYNC != PQresultStatus(pgres))
+				MYLOG(0, "unexpected result status %d instead of PGRES_PIPELINE_SYNC\n", PQresultStatus(pgres));
+			PQclear(pgres);
+			pgres = NULL;
+		}
+		/* an error rolled back the whole segment */
+		if (failed && param_status)
+		{
+			for (rrow = seg_start; rrow < row; rrow++)
+			{
+				if (SQL_PARAM_UNUSED != param_status[rrow])
+					param_status[rrow] = SQL_PARAM_ERROR;
 			}
 		}
 	}
 
-	if (plan_name == NULL || plan_name[0] == '\0')
-		conn->unnamed_prepared_stmt = NULL;
+	QLOG(0, "PQexitPipelineMode: %p\n", conn->pqconn);
+	if (!PQexitPipelineMode(conn->pqconn))
+		MYLOG(0, "could not exit pipeline mode: %s\n", PQerrorMessage(conn->pqconn));
+	/* reset notice receiver */
+	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
 
-	/* Prepare */
-	QLOG(0, "PQprepare: %p '%s' plan=%s nParams=%d\n", conn->pqconn, query, plan_name, num_params);
-	pgres = PQprepare(conn->pqconn, plan_name, query, num_params, paramTypes);
-	if (PQresultStatus(pgres) != PGRES_COMMAND_OK)
-	{
-		handle_pgres_error(conn, pgres, "ParseWithlibpq", res, TRUE);
-		goto cleanup;
-	}
+	if (!failed && QR_command_successful(res))
+		QR_set_rstatus(res, PORES_COMMAND_OK);
+	res->recent_processed_row_count = total_count;
+	stmt->has_notice = any_notice;
+	stmt->exec_current_row = end_row;
+	free_libpq_bind_params(nParams, paramTypes, paramValues, paramLengths, paramFormats);
+
+	return res;
+}
+#undef	PARAM_ROW_IGNORED
+#endif /* LIBPQ_HAS_PIPELINING */
+
+/*
+ * COPY FROM STDIN for parameter arrays of simple INSERT statements.
+ */
+static const char *
+skip_sql_spaces(const char *p)
+{
+	while (isspace((UCHAR) *p))
+		p++;
+	return p;
+}
+
+static const char *
+skip_sql_keyword(const char *p, const char *keyword)
+{
+	size_t	len = strlen(keyword);
+
+	p = skip_sql_spaces(p);
+	if (strnicmp(p, keyword, len) != 0)
+		return NULL;
+	p += len;
+	if (isalnum((UCHAR) *p) || '_' == *p)
+		return NULL;
+	return skip_sql_spaces(p);
+}
+
+static const char *
+skip_sql_identifier(const char *p)
+{
+	if ('"' == *p)
+	{
+		for (p++; *p; p++)
+		{
+			if ('"' != *p)
+				continue;
+			if ('"' != p[1])
+				return p + 1;
+			p++;
+		}
+		return NULL;
+	}
+	if (!isalpha((UCHAR) *p) && '_' != *p && 0 == (*p & 0x80))
+		return NULL;
+	for (p++; isalnum((UCHAR) *p) || '_' == *p || '$' == *p || 0 != (*p & 0x80); p++)
+		;
+	return p;
+}
+
+/*
+ * If the statement is
+ *	INSERT INTO table (column, ...) VALUES (?, ...)
+ * with a parameter marker for every column, returns the start of the
+ * table name and sets the ends of it and the spans of the column list.
+ * Otherwise returns NULL.
+ */
+static const char *
+parse_copy_insert(const StatementClass *stmt, const char **table_end, const char **cols, const char **cols_end)
+{
+	const char *p = stmt->statement, *table;
+	int		num_cols = 0, num_markers = 0;
+
+	if (NULL == p || STMT_TYPE_INSERT != stmt->statement_type)
+		return NULL;
+	if (p = skip_sql_keyword(p, "INSERT"), NULL == p)
+		return NULL;
+	if (p = skip_sql_keyword(p, "INTO"), NULL == p)
+		return NULL;
+	table = p;
+	for (;;)
+	{
+		if (p = skip_sql_identifier(p), NULL == p)
+			return NULL;
+		if ('.' != *p)
+			break;
+		p++;
+	}
+	*table_end = p;
+	p = skip_sql_spaces(p);
+	if ('(' != *p)
+		return NULL;
+	*cols = p++;
+	for (;; p++)
+	{
+		if (p = skip_sql_identifier(skip_sql_spaces(p)), NULL == p)
+			return NULL;
+		num_cols++;
+		p = skip_sql_spaces(p);
+		if (')' == *p)
+			break;
+		if (',' != *p)
+			return NULL;
+	}
+	*cols_end = ++p;
+	if (p = skip_sql_keyword(p, "VALUES"), NULL == p || '(' != *p)
+		return NULL;
+	for (p++;; p++)
+	{
+		p = skip_sql_spaces(p);
+		if ('?' != *p)
+			return NULL;
+		num_markers++;
+		p = skip_sql_spaces(p + 1);
+		if (')' == *p)
+			break;
+		if (',' != *p)
+			return NULL;
+	}
+	p = skip_sql_spaces(p + 1);
+	if (';' == *p)
+		p = skip_sql_spaces(p + 1);
+	if ('\0' != *p || num_cols != num_markers)
+		return NULL;
+
+	return table;
+}
+
+/*
+ * Returns the COPY command equivalent to the statement (malloc'ed) if
+ * parse_copy_insert() accepts it. Otherwise returns NULL.
+ *
+ * The column list is required because INSERT fills the missing columns
+ * with their defaults while COPY without it expects all the columns.
+ */
+char *
+SC_copy_insert_command(const StatementClass *stmt)
+{
+	const char *table, *table_end, *cols, *cols_end;
+	size_t	len;
+	char	*cmd;
+
+	if (table = parse_copy_insert(stmt, &table_end, &cols, &cols_end), NULL == table)
+		return NULL;
+	len = (table_end - table) + (cols_end - cols) + sizeof("COPY   FROM STDIN");
+	if (cmd = malloc(len), NULL == cmd)
+		return NULL;
+	snprintf(cmd, len, "COPY %.*s %.*s FROM STDIN", (int) (table_end - table), table, (int) (cols_end - cols), cols);
+
+	return cmd;
+}
+
+/*
+ * Does the table rel (an expression of its oid) have rules ? TRUE is
+ * also returned when it can't be told e.g. the table doesn't exist.
+ */
+static BOOL
+table_has_rules(ConnectionClass *conn, const char *rel)
+{
+	PQExpBufferData	query;
+	QResultClass	*res;
+	const char	*value;
+	BOOL		ret = TRUE;
+
+	initPQExpBuffer(&query);
+	appendPQExpBuffer(&query, "select relhasrules from pg_catalog.pg_class where oid = %s", rel);
+	if (PQExpBufferDataBroken(query))
+	{
+		termPQExpBuffer(&query);
+		return ret;
+	}
+	res = CC_send_query(conn, query.data, NULL, READ_ONLY_QUERY, NULL);
+	if (QR_command_maybe_successful(res) && 1 == QR_get_num_total_tuples(res) &&
+	    NULL != (value = QR_get_value_backend_text(res, 0, 0)))
+		ret = ('t' == value[0]);
+	QR_Destructor(res);
+	termPQExpBuffer(&query);
+	return ret;
+}
+
+/*
+ * COPY FROM fires the triggers of the table but doesn't apply its rules,
+ * which INSERT does. Does the table of the statement have rules ? The
+ * answer is kept until the statement is changed.
+ */
+BOOL
+SC_copy_insert_has_rules(StatementClass *stmt)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	const char	*table, *table_end, *cols, *cols_end;
+	char		*escaped, *rel;
+	size_t		len;
+	BOOL		ret = TRUE;
+
+	if (stmt->copy_insert_rules >= 0)
+		return (0 != stmt->copy_insert_rules);
+	/* to_regclass() doesn't raise an error for a missing table */
+	if (!PG_VERSION_GE(conn, 9.4))
+		return ret;
+	if (table = parse_copy_insert(stmt, &table_end, &cols, &cols_end), NULL == table)
+		return ret;
+	if (escaped = identifierEscape((const SQLCHAR *) table, table_end - table, conn, NULL, -1, FALSE), NULL == escaped)
+		return ret;
+	len = strlen(escaped) + sizeof("pg_catalog.to_regclass(E'')");
+	if (rel = malloc(len), NULL != rel)
+	{
+		/* the name is resolved the same way as COPY and INSERT do */
+		snprintf(rel, len, "pg_catalog.to_regclass(%s'%s')",
+				(0 != CC_get_escape(conn) && PG_VERSION_GE(conn, 8.1)) ? "E" : "", escaped);
+		ret = table_has_rules(conn, rel);
+		stmt->copy_insert_rules = ret;
+		free(rel);
+	}
+	free(escaped);
+	MYLOG(0, "%s has rules=%d\n", stmt->statement, ret);
+	return ret;
+}
+
+/*
+ * Does the table ti have rules ? The answer is kept in ti.
+ */
+BOOL
+SC_table_has_rules(StatementClass *stmt, TABLE_INFO *ti)
+{
+	char	rel[16];
+
+	if (TI_checked_hasrules(ti))
+		return TI_has_rules(ti);
+	if (0 == ti->table_oid)
+		return TRUE;
+	SPRINTF_FIXED(rel, "%u", ti->table_oid);
+	if (table_has_rules(SC_get_conn(stmt), rel))
+		TI_set_hasrules(ti);
+	TI_set_hasrules_checked(ti);
+	MYLOG(0, "%s has rules=%d\n", SAFE_NAME(ti->table_name), TI_has_rules(ti));
+	return TI_has_rules(ti);
+}
+
+/* Append a parameter value to a row of COPY text format */
+static void
+append_copy_value(PQExpBuffer buf, const char *value, int len, BOOL binary)
+{
+	static const char hextbl[] = "0123456789abcdef";
+	int	i;
+
+	if (NULL == value)
+	{
+		appendBinaryPQExpBuffer(buf, "\\N", 2);
+		return;
+	}
+	if (binary)
+	{
+		/* only bytea values are sent in binary */
+		appendBinaryPQExpBuffer(buf, "\\\\x", 3);
+		for (i = 0; i < len; i++)
+		{
+			appendPQExpBufferChar(buf, hextbl[((UCHAR) value[i]) >> 4]);
+			appendPQExpBufferChar(buf, hextbl[((UCHAR) value[i]) & 0x0f]);
+		}
+		return;
+	}
+	for (i = 0; i < len; i++)
+	{
+		switch (value[i])
+		{
+			case '\\':
+				appendBinaryPQExpBuffer(buf, "\\\\", 2);
+				break;
+			case '\n':
+				appendBinaryPQExpBuffer(buf, "\\n", 2);
+				break;
+			case '\r':
+				appendBinaryPQExpBuffer(buf, "\\r", 2);
+				break;
+			case '\t':
+				appendBinaryPQExpBuffer(buf, "\\t", 2);
+				break;
+			default:
+				appendPQExpBufferChar(buf, value[i]);
+		}
+	}
+}
+
+#define	COPY_SEND_SIZE	65536
+#define	PARAM_ROW_IGNORED(apdopts, row) \
+	((apdopts)->param_operation_ptr && \
+	 SQL_PARAM_IGNORE == (apdopts)->param_operation_ptr[row])
+
+/*
+ * Load all the rows of the parameter array by COPY FROM STDIN.
+ *
+ * The parameter values are built as for libpq_bind_and_exec() and sent
+ * in COPY text format. COPY is a single command, so the rows succeed or
+ * fail all together. The result looks like that of one INSERT command
+ * which inserted all the rows.
+ */
+static QResultClass *
+libpq_copy_insert_exec(StatementClass *stmt)
+{
+	CSTR		func = "libpq_copy_insert_exec";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	APDFields	*apdopts = SC_get_APDF(stmt);
+	IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	SQLUSMALLINT	*param_status = ipdopts->param_status_ptr;
+	SQLLEN		start_row, end_row, row, last_row;
+	int			nParams = 0, i;
+	Oid		   *paramTypes = NULL;
+	char	  **paramValues = NULL;
+	int		   *paramLengths = NULL;
+	int		   *paramFormats = NULL;
+	int			resultFormat;
+	char	   *copycmd;
+	const char *abortmsg = NULL;
+	PQExpBufferData	buf = {0};
+	PGresult   *pgres = NULL;
+	QResultClass	*res;
+	char	   *rowcount;
+	char		cmdtag[64];
+	BOOL		failed = TRUE;
+	notice_receiver_arg	nrarg;
+
+	if (!RequestStart(stmt, conn, func))
+		return NULL;
+
+	start_row = stmt->exec_current_row;
+	if (end_row = stmt->exec_end_row, end_row < 0)
+		end_row = (SQLINTEGER) apdopts->paramset_size - 1;
+	last_row = start_row - 1;
+	if (copycmd = SC_copy_insert_command(stmt), NULL == copycmd)
+	{
+		SC_set_error(stmt, STMT_INTERNAL_ERROR, "The statement can't be executed by COPY", func);
+		return NULL;
+	}
+
+	/* set notice receiver */
+	if (res = add_libpq_notice_receiver(stmt, &nrarg), NULL == res)
+	{
+		PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
+		free(copycmd);
+		return NULL;
+	}
+	stmt->has_notice = 0;
+	QLOG(0, "PQexec: %p '%s'\n", conn->pqconn, copycmd);
+	pgres = PQexec(conn->pqconn, copycmd);
+	if (PGRES_COPY_IN != PQresultStatus(pgres))
+	{
+		handle_pgres_error(conn, pgres, func, res, TRUE);
+		if (param_status)
+			param_status[start_row] = SQL_PARAM_ERROR;
+		goto cleanup;
+	}
+	PQclear(pgres);
+	pgres = NULL;
+
+	initPQExpBuffer(&buf);
+	for (row = start_row; row <= end_row; row++)
+	{
+		if (PARAM_ROW_IGNORED(apdopts, row))
+			continue;
+		stmt->exec_current_row = last_row = row;
+		/* the caller has counted the first row */
+		if (row > start_row && ipdopts->param_processed_ptr)
+			(*ipdopts->param_processed_ptr)++;
+		if (param_status)
+			param_status[row] = SQL_PARAM_ERROR;
+		if (!build_libpq_bind_params(stmt,
+									 &nParams,
+									 &paramTypes,
+									 &paramValues,
+									 &paramLengths, &paramFormats,
+									 &resultFormat))
+		{
+			if (SC_get_errornumber(stmt) <= 0)
+				SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
+			abortmsg = "could not build the parameter values";
+			break;
+		}
+		for (i = 0; i < nParams; i++)
+		{
+			if (i > 0)
+				appendPQExpBufferChar(&buf, '\t');
+			append_copy_value(&buf, paramValues[i], paramLengths[i], 0 != paramFormats[i]);
+		}
+		appendPQExpBufferChar(&buf, '\n');
+		free_libpq_bind_params(nParams, paramTypes, paramValues, paramLengths, paramFormats);
+		paramTypes = NULL;
+		paramValues = NULL;
+		paramLengths = NULL;
+		paramFormats = NULL;
+		if (PQExpBufferDataBroken(buf))
+		{
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while building COPY data", func);
+			abortmsg = "out of memory";
+			break;
+		}
+		if (buf.len >= COPY_SEND_SIZE)
+		{
+			if (1 != PQputCopyData(conn->pqconn, buf.data, (int) buf.len))
+			{
+				abortmsg = PQerrorMessage(conn->pqconn);
+				break;
+			}
+			resetPQExpBuffer(&buf);
+		}
+	}
+	if (NULL == abortmsg && buf.len > 0 &&
+	    1 != PQputCopyData(conn->pqconn, buf.data, (int) buf.len))
+		abortmsg = PQerrorMessage(conn->pqconn);
+	QLOG(0, "PQputCopyEnd: %p rows=" FORMAT_LEN " %s\n", conn->pqconn, last_row - start_row + 1, abortmsg ? abortmsg : "");
+	if (1 != PQputCopyEnd(conn->pqconn, abortmsg))
+	{
+		CC_set_error(conn, CONNECTION_COMMUNICATION_ERROR, PQerrorMessage(conn->pqconn), func);
+		CC_on_abort(conn, CONN_DEAD);
+		QR_set_rstatus(res, PORES_FATAL_ERROR);
+		goto cleanup;
+	}
+
+	pgres = PQgetResult(conn->pqconn);
+	switch (PQresultStatus(pgres))
+	{
+		case PGRES_COMMAND_OK:
+			QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+			rowcount = PQcmdTuples(pgres);
+			res->recent_processed_row_count = (rowcount && rowcount[0]) ? pg_atoi(rowcount) : 0;
+			/* report it as an INSERT */
+			SPRINTF_FIXED(cmdtag, "INSERT 0 " FORMAT_LEN, res->recent_processed_row_count);
+			QR_set_command(res, cmdtag);
+			if (NULL == abortmsg)
+				failed = FALSE;
+			break;
+		case PGRES_NONFATAL_ERROR:
+			handle_pgres_error(conn, pgres, func, res, FALSE);
+			break;
+		default:
+			handle_pgres_error(conn, pgres, func, res, TRUE);
+			break;
+	}
+	if (!failed && QR_command_successful(res))
+		QR_set_rstatus(res, PORES_COMMAND_OK);
+
+cleanup:
+	if (pgres)
+		PQclear(pgres);
+	/* consume the rest of the results */
+	while (pgres = PQgetResult(conn->pqconn), NULL != pgres)
+		PQclear(pgres);
+	/* reset notice receiver */
+	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+	if (param_status)
+	{
+		for (row = start_row; row <= last_row; row++)
+		{
+			if (PARAM_ROW_IGNORED(apdopts, row))
+				continue;
+			if (failed)
+				param_status[row] = SQL_PARAM_ERROR;
+			else
+				param_status[row] = stmt->has_notice ? SQL_PARAM_SUCCESS_WITH_INFO : SQL_PARAM_SUCCESS;
+		}
+	}
+	stmt->exec_current_row = end_row;
+	termPQExpBuffer(&buf);
+	free_libpq_bind_params(nParams, paramTypes, paramValues, paramLengths, paramFormats);
+	free(copycmd);
+
+	return res;
+}
+#undef	PARAM_ROW_IGNORED
+
+/*
+ * Read the rows of a forward-only read-only SELECT through COPY (...) TO
+ * STDOUT.
+ *
+ * COPY can't take parameters, so the query is the one with the parameter
+ * values embedded by the driver. COPY doesn't report the result columns,
+ * so the query is described with the unnamed statement first. The rows
+ * are copied in binary format if the driver can handle every column in
+ * binary, in text format otherwise. Only the first group of rows is read
+ * here, QR_next_tuple() reads the rest as the application fetches them.
+ *
+ * Returns NULL without setting an error if the query can't be read this
+ * way, the caller should execute it as usual then.
+ */
+static QResultClass *
+libpq_copy_stream_exec(StatementClass *stmt)
+{
+	CSTR		func = "libpq_copy_stream_exec";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ConnInfo	*ci = &(conn->connInfo);
+	const char	*query = stmt->stmt_with_params;
+	PQExpBufferData	copycmd = {0};
+	PGresult   *pgres = NULL;
+	QResultClass	*res = NULL;
+	ColumnInfoClass	*flds;
+	size_t		qlen;
+	int		i, num_fields;
+	char		copy_stream = COPY_STREAM_BINARY;
+	BOOL		succeeded = FALSE;
+
+	if (NULL == query || !RequestStart(stmt, conn, func))
+		return NULL;
+	if (res = QR_Constructor(), NULL == res)
+		return NULL;
+
+	/* the query must be parenthesized without the trailing semicolons */
+	for (qlen = strlen(query); qlen > 0; qlen--)
+	{
+		if (';' != query[qlen - 1] &&
+		    !isspace((UCHAR) query[qlen - 1]))
+			break;
+	}
+	initPQExpBuffer(&copycmd);
+	appendBinaryPQExpBuffer(&copycmd, query, qlen);
+	if (PQExpBufferDataBroken(copycmd))
+	{
+		QR_set_rstatus(res, PORES_NO_MEMORY_ERROR);
+		QR_set_message(res, "Out of memory while building COPY command");
+		goto cleanup;
+	}
+
+	/* Describe the query to get the result columns */
+	conn->unnamed_prepared_stmt = NULL;
+	QLOG(0, "PQprepare: %p '%s' plan= nParams=0\n", conn->pqconn, copycmd.data);
+	pgres = PQprepare(conn->pqconn, "", copycmd.data, 0, NULL);
+	if (PGRES_COMMAND_OK != PQresultStatus(pgres))
+	{
+		handle_pgres_error(conn, pgres, func, res, TRUE);
+		goto cleanup;
+	}
+	PQclear(pgres);
+	QLOG(0, "\tPQdescribePrepared: %p plan_name=\n", conn->pqconn);
+	pgres = PQdescribePrepared(conn->pqconn, "");
+	if (PGRES_COMMAND_OK != PQresultStatus(pgres))
+	{
+		handle_pgres_error(conn, pgres, func, res, TRUE);
+		goto cleanup;
+	}
+	if (PQnfields(pgres) <= 0)
+	{
+		MYLOG(0, "no result columns, can't be read through COPY\n");
+		SC_no_copystream(stmt);
+		QR_Destructor(res);
+		res = NULL;
+		goto cleanup;
+	}
+	if (!QR_from_PGresult(res, stmt, conn, SC_cursor_name(stmt), &pgres))
+		goto cleanup;
+	flds = QR_get_fields(res);
+	num_fields = QR_NumResultCols(res);
+	for (i = 0; i < num_fields; i++)
+	{
+		if (BINRES_UNSUPPORTED == binary_result_handling(CI_get_oid(flds, i)))
+		{
+			copy_stream = COPY_STREAM_TEXT;
+			break;
+		}
+	}
+	if (COPY_STREAM_BINARY == copy_stream)
+	{
+		for (i = 0; i < num_fields; i++)
+		{
+			if (BINRES_DECODE == binary_result_handling(CI_get_oid(flds, i)))
+				CI_get_format(flds, i) = 1;
+		}
+	}
+	PQclear(pgres);
+	pgres = NULL;
+
+	/* Start the COPY */
+	resetPQExpBuffer(&copycmd);
+	appendPQExpBuffer(&copycmd, "COPY (");
+	appendBinaryPQExpBuffer(&copycmd, query, qlen);
+	appendPQExpBuffer(&copycmd, ") TO STDOUT%s",
+			COPY_STREAM_BINARY == copy_stream ? " (FORMAT binary)" : NULL_STRING);
+	if (PQExpBufferDataBroken(copycmd))
+	{
+		QR_set_rstatus(res, PORES_NO_MEMORY_ERROR);
+		QR_set_message(res, "Out of memory while building COPY command");
+		goto cleanup;
+	}
+	QLOG(0, "PQexec: %p '%s'\n", conn->pqconn, copycmd.data);
+	pgres = PQexec(conn->pqconn, copycmd.data);
+	if (PGRES_COPY_OUT != PQresultStatus(pgres))
+	{
+		handle_pgres_error(conn, pgres, func, res, TRUE);
+		goto cleanup;
+	}
+	PQclear(pgres);
+	pgres = NULL;
+
+	res->copy_stream = copy_stream;
+	res->cache_size = res->cmd_fetch_size = ci->drivers.fetch_max;
+	conn->copy_stream_res = res;
+	if (QR_read_copy_rows(res, ci->drivers.fetch_max) < 0)
+		goto cleanup;
+	SC_set_fetchcursor(stmt);
+	succeeded = TRUE;
+
+cleanup:
+	if (pgres)
+		PQclear(pgres);
+	termPQExpBuffer(&copycmd);
+	if (res && !succeeded && QR_command_successful(res))
+		QR_set_rstatus(res, PORES_FATAL_ERROR);
+
+	return res;
+}
+
+/*
+ * Determine the parameter types to send with the Parse request.
+ *
+ * Returns the number of parameters and sets a malloc'ed array of the types
+ * to *types, or -1 on memory allocation failure.
+ */
+static int
+get_parse_param_types(StatementClass *stmt, Int2 num_params, Oid **types)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	Int4		sta_pidx = -1, end_pidx = -1;
+	Oid		   *paramTypes = NULL;
+
+	*types = NULL;
+	if (stmt->discard_output_params)
+		num_params = 0;
+	else if (num_params != 0)
+	{
+#ifdef	NOT_USED
+		sta_pidx += stmt->proc_return;
+#endif /* NOT_USED */
+		int	pidx;
+
+		sta_pidx = stmt->current_exec_param;
+		if (num_params < 0)
+			end_pidx = stmt->num_params - 1;
+		else
+			end_pidx = sta_pidx + num_params - 1;
+#ifdef	NOT_USED
+		num_params = end_pidx - sta_pidx + 1;
+#endif /* NOT_USED */
+		for (num_params = 0, pidx = sta_pidx - 1;;)
+		{
+			SC_param_next(stmt, &pidx, NULL, NULL);
+			if (pidx > end_pidx)
+				break;
+			else if (pidx < end_pidx)
+			{
+				if (0 == num_params)
+					sta_pidx = pidx;
+				num_params++;
+			}
+			else
+			{
+				num_params++;
+				break;
+			}
+		}
+MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
+	}
+
+	/*
+	 * We let the server deduce the right datatype for the parameters, except
+	 * for out parameters, which are sent as VOID.
+	 */
+	if (num_params > 0)
+	{
+		int	i;
+		int j;
+		IPDFields	*ipdopts = SC_get_IPDF(stmt);
+
+		paramTypes = malloc(sizeof(Oid) * num_params);
+		if (paramTypes == NULL)
+			return -1;
+
+		MYLOG(0, "ipdopts->allocated: %d\n", ipdopts->allocated);
+		j = 0;
+		for (i = sta_pidx; i <= end_pidx; i++)
+		{
+			if (i < ipdopts->allocated)
+			{
+				if (SQL_PARAM_OUTPUT == ipdopts->parameters[i].paramType)
+					paramTypes[j++] = PG_TYPE_VOID;
+				else
+					paramTypes[j++] = sqltype_to_bind_pgtype(conn,
+															 ipdopts->parameters[i].SQLType);
+			}
+			else
+			{
+				/* Unknown type of parameter. Let the server decide */
+				paramTypes[j++] = 0;
+			}
+		}
+	}
+
+	*types = paramTypes;
+	return num_params;
+}
+
+/*
+ * Parse a query using libpq.
+ *
+ * 'res' is only passed here for error reporting purposes. If an error is
+ * encountered, it is set in 'res', and the function returns FALSE.
+ */
+static BOOL
+ParseWithLibpq(StatementClass *stmt, const char *plan_name,
+			   const char *query,
+			   Int2 num_params, const char *comment, QResultClass *res)
+{
+	CSTR	func = "ParseWithLibpq";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	const char	*cstatus;
+	Oid		   *paramTypes = NULL;
+	BOOL		retval = FALSE;
+	PGresult   *pgres = NULL;
+
+	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query);
+	if (!RequestStart(stmt, conn, func))
+		return FALSE;
+
+	if (num_params = get_parse_param_types(stmt, num_params, &paramTypes), num_params < 0)
+	{
+		SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
+		goto cleanup;
+	}
+
+	if (plan_name == NULL || plan_name[0] == '\0')
+		conn->unnamed_prepared_stmt = NULL;
+
+	/* Prepare */
+	QLOG(0, "PQprepare: %p '%s' plan=%s nParams=%d\n", conn->pqconn, query, plan_name, num_params);
+	pgres = PQprepare(conn->pqconn, plan_name, query, num_params, paramTypes);
+	if (PQresultStatus(pgres) != PGRES_COMMAND_OK)
+	{
+		handle_pgres_error(conn, pgres, "ParseWithlibpq", res, TRUE);
+		goto cleanup;
+	}
 	cstatus = PQcmdStatus(pgres);
 	QLOG(0, "\tok: - 'C' - %s\n", cstatus);
 	if (stmt->plan_name)
@@ -2987,6 +4135,9 @@ ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
 	int			i;
 	Oid			oid;
 	SQLSMALLINT paramType;
+	Oid		   *cacheTypes = NULL;
+	int			num_cache_params = -1;
+	BOOL		desc_cached = FALSE, describe_only = FALSE;
 
 	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query_param);
 	if (!RequestStart(stmt, conn, func))
@@ -3000,6 +4151,63 @@ ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
 		return NULL;
 	}
 
+	/*
+	 * Named plans of single statements may be shared with the other
+	 * statements via the connection's prepared statement cache.
+	 */
+	if (conn->connInfo.prepared_cache_size > 0 &&
+	    NULL != plan_name && plan_name[0] &&
+	    NULL != stmt->processed_statements &&
+	    NULL == stmt->processed_statements->next &&
+	    !stmt->discard_output_params)
+	{
+		PREPARED_INFO	*pinfo;
+		char		cache_name[PLAN_NAME_SIZE];
+
+		if (num_cache_params = get_parse_param_types(stmt, num_params, &cacheTypes), num_cache_params < 0)
+		{
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for parameter types", func);
+			goto cleanup;
+		}
+		if (pinfo = CC_lookup_prepared(conn, query_param, (Int2) num_cache_params, cacheTypes), NULL != pinfo)
+		{
+			SC_set_planname(stmt, pinfo->plan_name);
+			SC_set_prepared(stmt, PREPARED_PERMANENTLY);
+			pgres = pinfo->desc;
+			desc_cached = TRUE;
+			goto described;
+		}
+		CC_prepared_cache_name(conn, cache_name, sizeof(cache_name));
+		SC_set_planname(stmt, cache_name);
+		plan_name = stmt->plan_name;
+	}
+	/*
+	 * The unnamed statement is parsed here only to be described, and the
+	 * description of the same query may be cached by the connection.
+	 */
+	else if (conn->connInfo.describe_cache_size > 0 &&
+		 (NULL == plan_name || !plan_name[0]))
+	{
+		describe_only = TRUE;
+		if (num_cache_params = get_parse_param_types(stmt, num_params, &cacheTypes), num_cache_params < 0)
+		{
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for parameter types", func);
+			goto cleanup;
+		}
+		if (pgres = CC_lookup_described(conn, query_param, (Int2) num_cache_params, cacheTypes), NULL != pgres)
+		{
+			/*
+			 * Nothing is parsed, so the execution will parse the query
+			 * as if another statement took the unnamed statement.
+			 */
+			if (conn->unnamed_prepared_stmt == stmt)
+				conn->unnamed_prepared_stmt = NULL;
+			SC_set_prepared(stmt, PREPARED_TEMPORARILY);
+			desc_cached = TRUE;
+			goto described;
+		}
+	}
+
 	/*
 	 * We need to do Prepare + Describe as two different round-trips to the
 	 * server, while before we switched to use libpq, we used to send a Parse
@@ -3032,7 +4240,17 @@ ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
 			MYLOG(0, "PQdescribePrepared: error - %s\n", CC_get_errormsg(conn));
 			goto cleanup;
 	}
+	if (num_cache_params < 0)
+		;
+	else if (describe_only)
+	{
+		if (CC_add_described(conn, query_param, (Int2) num_cache_params, cacheTypes, pgres))
+			desc_cached = TRUE;
+	}
+	else if (CC_add_prepared(conn, query_param, (Int2) num_cache_params, cacheTypes, plan_name, pgres))
+		desc_cached = TRUE;
 
+described:
 	/* Extract parameter information from the result set */
 	num_p = PQnparams(pgres);
 MYLOG(DETAIL_LOG_LEVEL, "num_params=%d info=%d\n", stmt->num_params, num_p);
@@ -3124,8 +4342,10 @@ MYLOG(DETAIL_LOG_LEVEL, "num_params=%d info=%d\n", stmt->num_params, num_p);
 	}
 
 cleanup:
-	if (pgres)
+	if (pgres && !desc_cached)
 		PQclear(pgres);
+	if (cacheTypes)
+		free(cacheTypes);
 
 	return res;
 }
@@ -3172,6 +4392,38 @@ MYLOG(0, "set %p STMT_FINISHED\n", self);
 	return exeSet;
 }
 
+/*
+ *	Poll the asynchronous execution of the statement.
+ *	Returns TRUE when the results can be read without blocking.
+ */
+BOOL	SC_async_exec_ready(StatementClass *self)
+{
+	ConnectionClass	*conn = SC_get_conn(self);
+	PGconn	*pqconn = conn->pqconn;
+	notice_receiver_arg	nrarg;
+	BOOL	ready = TRUE;
+
+	if (ASYNC_EXEC_SENT != self->async_exec)
+		return TRUE;
+	if (NULL != pqconn)
+	{
+		/* NOTICEs may arrive before the results */
+		nrarg.conn = conn;
+		nrarg.comment = __FUNCTION__;
+		nrarg.res = self->async_res;
+		nrarg.stmt = self;
+		PQsetNoticeReceiver(pqconn, receive_libpq_notice, &nrarg);
+		/* let PQgetResult() report the communication error if any */
+		if (PQflush(pqconn) >= 0 && PQconsumeInput(pqconn))
+			ready = !PQisBusy(pqconn);
+		PQsetNoticeReceiver(pqconn, receive_libpq_notice, NULL);
+	}
+	MYLOG(DETAIL_LOG_LEVEL, "%p ready=%d\n", self, ready);
+	if (ready)
+		self->async_exec = ASYNC_EXEC_READY;
+	return ready;
+}
+
 #ifdef	NOT_USED
 BOOL	SC_SetCancelRequest(StatementClass *self)
 {
@@ -172,8 +172,22 @@ enum
 typedef enum {
 	DIRECT_EXEC,
 	DEFFERED_EXEC,
-	LAST_EXEC
+	LAST_EXEC,
+	PIPELINE_EXEC,	/* all the rows at once in libpq pipeline mode */
+	COPY_EXEC	/* all the rows at once by COPY FROM STDIN */
 } EXEC_TYPE;
+/* Is the execution processing all the rows of the parameter array ? */
+#define	EXEC_ALL_ROWS(type)	(PIPELINE_EXEC == (type) || COPY_EXEC == (type))
+
+/*	State of the asynchronous execution (SQL_ATTR_ASYNC_ENABLE) */
+enum
+{
+	ASYNC_EXEC_NONE = 0
+	,ASYNC_EXEC_REQUESTED	/* send the query without waiting for the results */
+	,ASYNC_EXEC_SENT	/* the query was sent, the results are awaited */
+	,ASYNC_EXEC_READY	/* the results have arrived, to be read */
+};
+#define	SC_async_exec_pending(a)	(ASYNC_EXEC_SENT <= (a)->async_exec)
 
 #define	PG_NUM_NORMAL_KEYS	2
 
@@ -230,6 +244,8 @@ struct StatementClass_
 	SQLLEN		currTuple;	/* current absolute row number (GetData,
 						 * SetPos, SQLFetch) */
 	GetDataInfo	gdata_info;
+	ColumnPlan	*col_plans;	/* conversion plans of the bound columns */
+	Int2		num_col_plans;
 	SQLLEN		save_rowset_size;	/* saved rowset size in case of
 							 * change/FETCH_NEXT */
 	SQLLEN		rowset_start;	/* start of rowset (an absolute row
@@ -271,6 +287,7 @@ struct StatementClass_
 	po_ind_t	external;	/* Allocated via SQLAllocHandle() */
 	po_ind_t	transition_status;	/* Transition status */
 	po_ind_t	multi_statement; /* -1:unknown 0:single 1:multi */
+	po_ind_t	copy_insert_rules; /* -1:unknown 0:none 1:the table has rules */
 	po_ind_t	rb_or_tc;	/* rollback on error */
 	po_ind_t	discard_output_params;	 /* discard output parameters on parse stage */
 	po_ind_t	cancel_info;	/* cancel information */
@@ -305,6 +322,10 @@ struct StatementClass_
 	EXEC_TYPE	exec_type;
 	int		count_of_deffered;
 	PQExpBufferData	stmt_deferred;
+	//	for asynchronous execution
+	po_ind_t	async_exec;	/* ASYNC_EXEC_xxxx */
+	po_ind_t	async_in_trans;	/* was in a transaction before the execution ? */
+	QResultClass	*async_res;	/* collects the notices until the results arrive */
 	/* SQL_NEED_DATA Callback list */
 	StatementClass	*execute_delegate;
 	StatementClass	*execute_parent;
@@ -442,6 +463,9 @@ enum
 #define SC_set_fetchcursor(a)	((a)->miscinfo |= (1L << 1))
 #define SC_no_fetchcursor(a)	((a)->miscinfo &= ~(1L << 1))
 #define SC_is_fetchcursor(a)	(((a)->miscinfo & (1L << 1)) != 0)
+#define SC_set_copystream(a)	((a)->miscinfo |= (1L << 2))
+#define SC_no_copystream(a)	((a)->miscinfo &= ~(1L << 2))
+#define SC_is_copystream(a)	(((a)->miscinfo & (1L << 2)) != 0)
 #define SC_miscinfo_clear(a)	((a)->miscinfo = 0)
 #define SC_set_with_hold(a)	((a)->execinfo |= 1L)
 #define SC_set_without_hold(a)	((a)->execinfo &= (~1L))
@@ -524,7 +548,11 @@ void		SC_set_rowset_start(StatementClass *self, SQLLEN, BOOL);
 void		SC_inc_rowset_start(StatementClass *self, SQLLEN);
 RETCODE		SC_initialize_stmts(StatementClass *self, BOOL);
 RETCODE		SC_execute(StatementClass *self);
+char		*SC_copy_insert_command(const StatementClass *self);
+BOOL		SC_copy_insert_has_rules(StatementClass *self);
+BOOL		SC_table_has_rules(StatementClass *self, TABLE_INFO *ti);
 RETCODE		SC_fetch(StatementClass *self);
+SQLLEN		SC_fetch_by_column(StatementClass *self, SQLLEN nrows, BOOL *truncated);
 void		SC_free_params(StatementClass *self, char option);
 void		SC_log_error(const char *func, const char *desc, const StatementClass *self);
 time_t		SC_get_time(StatementClass *self);
@@ -536,6 +564,10 @@ RETCODE		SC_pos_delete(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index,
 RETCODE		SC_pos_refresh(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index);
 RETCODE		SC_pos_fetch(StatementClass *self, const PG_BM *pg_bm);
 RETCODE		SC_pos_add(StatementClass *self, SQLSETPOSIROW irow);
+BOOL		SC_pos_rows_settable(StatementClass *self, SQLSETPOSIROW nrows, SQLSMALLINT operation);
+RETCODE		SC_pos_add_rows(StatementClass *self, SQLSETPOSIROW nrows, int *processed);
+RETCODE		SC_pos_update_rows(StatementClass *self, SQLSETPOSIROW nrows, const SQLULEN *index, const KeySet *keysets, int *processed);
+RETCODE		SC_pos_delete_rows(StatementClass *self, SQLSETPOSIROW nrows, const SQLULEN *index, const KeySet *keysets, int *processed);
 RETCODE		SC_fetch_by_bookmark(StatementClass *self);
 int		SC_Create_bookmark(StatementClass *stmt, BindInfoClass *bookmark, Int4 row_pos, Int4 currTuple, const KeySet *keyset);
 PG_BM		SC_Resolve_bookmark(const ARDFields *opts, Int4 idx);
@@ -547,6 +579,7 @@ void		SC_scanQueryAndCountParams(const char *, const ConnectionClass *,
 
 BOOL	SC_IsExecuting(const StatementClass *self);
 BOOL	SC_SetExecuting(StatementClass *self, BOOL on);
+BOOL	SC_async_exec_ready(StatementClass *self);
 BOOL	SC_SetCancelRequest(StatementClass *self);
 BOOL	SC_AcceptedCancelRequest(const StatementClass *self);
 
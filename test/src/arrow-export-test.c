@@ -0,0 +1,214 @@
+/*
+ * Test exporting results as Arrow arrays with SQL_ATTR_PGOPT_ARROW_BATCH,
+ * from the full result and with the declare/fetch mode.
+ */
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "../../pgapifunc.h"
+#include "../../arrow.h"
+
+static HSTMT	hstmt = SQL_NULL_HSTMT;
+
+static void
+exec_sql(const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+}
+
+static int
+is_valid(const struct ArrowArray *array, int64_t row)
+{
+	const uint8_t *validity = array->buffers[0];
+
+	return NULL == validity || 0 != (validity[row / 8] & (1 << (row % 8)));
+}
+
+/*
+ * Print a value the way a consumer would read it. The strings may be
+ * exported as binaries with the ANSI driver, so both are printed quoted
+ * unless they have non-printable bytes.
+ */
+static void
+print_value(const struct ArrowSchema *schema, const struct ArrowArray *array, int64_t row)
+{
+	const char *format = schema->format;
+	const void *values = array->buffers[1];
+
+	if (!is_valid(array, row))
+		printf("NULL");
+	else if (strcmp(format, "b") == 0)
+		printf("%s", (((const uint8_t *) values)[row / 8] & (1 << (row % 8))) ? "true" : "false");
+	else if (strcmp(format, "s") == 0)
+		printf("%d", ((const int16_t *) values)[row]);
+	else if (strcmp(format, "i") == 0 || strcmp(format, "tdD") == 0)
+		printf("%d", ((const int32_t *) values)[row]);
+	else if (strcmp(format, "I") == 0)
+		printf("%u", ((const uint32_t *) values)[row]);
+	else if (strcmp(format, "l") == 0 || strncmp(format, "tt", 2) == 0 ||
+			 strncmp(format, "ts", 2) == 0)
+		printf("%lld", (long long) ((const int64_t *) values)[row]);
+	else if (strcmp(format, "f") == 0)
+		printf("%g", ((const float *) values)[row]);
+	else if (strcmp(format, "g") == 0)
+		printf("%g", ((const double *) values)[row]);
+	else if (strcmp(format, "u") == 0 || strcmp(format, "z") == 0)
+	{
+		const int32_t *offsets = values;
+		const unsigned char *data = array->buffers[2];
+		int32_t		i, start = offsets[row], end = offsets[row + 1];
+
+		for (i = start; i < end && isprint(data[i]); i++)
+			;
+		if (i == end)
+			printf("'%.*s'", (int) (end - start), (const char *) data + start);
+		else
+		{
+			printf("\\x");
+			for (i = start; i < end; i++)
+				printf("%02x", data[i]);
+		}
+	}
+	else
+		printf("unexpected format %s", format);
+}
+
+static int
+fetch_batch(int64_t max_rows, int print_schema)
+{
+	SQLRETURN	rc;
+	PG_ARROW_BATCH	batch;
+	int64_t		i, row;
+
+	memset(&batch, 0, sizeof(batch));
+	batch.max_rows = max_rows;
+	rc = SQLGetStmtAttr(hstmt, SQL_ATTR_PGOPT_ARROW_BATCH, &batch, sizeof(batch), NULL);
+	if (SQL_NO_DATA == rc)
+	{
+		printf("no more rows\n");
+		return 0;
+	}
+	CHECK_STMT_RESULT(rc, "SQLGetStmtAttr ARROW_BATCH failed", hstmt);
+
+	if (strcmp(batch.schema.format, "+s") != 0 ||
+		batch.schema.n_children != batch.array.n_children)
+		printf("unexpected struct\n");
+	if (print_schema)
+	{
+		printf("schema:");
+		for (i = 0; i < batch.schema.n_children; i++)
+		{
+			const char *format = batch.schema.children[i]->format;
+
+			/* strings may be binaries with the ANSI driver */
+			if (strcmp(format, "u") == 0 || strcmp(format, "z") == 0)
+				format = "u|z";
+			printf(" %s:%s", batch.schema.children[i]->name, format);
+		}
+		printf("\n");
+	}
+	printf("batch of %d rows\n", (int) batch.array.length);
+	for (row = 0; row < batch.array.length; row++)
+	{
+		printf(" ");
+		for (i = 0; i < batch.array.n_children; i++)
+		{
+			printf(" %s=", batch.schema.children[i]->name);
+			print_value(batch.schema.children[i], batch.array.children[i], row);
+		}
+		printf("\n");
+	}
+
+	batch.array.release(&batch.array);
+	batch.schema.release(&batch.schema);
+	if (batch.array.release || batch.schema.release)
+		printf("not released\n");
+
+	return 1;
+}
+
+static void
+export_result(void)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	id;
+	SQLLEN		ind;
+
+	exec_sql("SELECT * FROM arrowtest ORDER BY id");
+	fetch_batch(2, 1);
+
+	/* SQLFetch continues from the batch, and the batch from SQLFetch */
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &id, 0, &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("SQLFetch: id=%d\n", (int) id);
+
+	while (fetch_batch(2, 0))
+		;
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+
+	test_connect_ext("BoolsAsChar=0;UseDeclareFetch=0");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	exec_sql("CREATE TEMPORARY TABLE arrowtest (id int2, i4 int4, i8 int8, "
+			 "f4 float4, f8 float8, b bool, d date, t time, ts timestamp, "
+			 "tz timestamptz, n numeric, s text, by bytea)");
+	exec_sql("INSERT INTO arrowtest VALUES "
+			 "(1, 100000, 10000000000, 1.5, 2.25, true, '2020-02-29', "
+			 "'12:34:56.789', '2020-02-29 12:34:56.789', "
+			 "'2020-02-29 12:34:56.789+02', 123.456, 'one', '\\x00ff'), "
+			 "(2, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL), "
+			 "(3, -2147483648, -9223372036854775808, -0.5, 1e100, false, "
+			 "'1969-12-31', '00:00:00', '1969-12-31 23:59:59.999999', "
+			 "'1970-01-01 00:00:00+00', -0.001, '', '\\x'), "
+			 "(4, 0, 0, 0, 0, true, '0044-03-15 BC', '23:59:59.999999', "
+			 "'infinity', '-infinity', 0, 'four', '\\x414243'), "
+			 "(5, 42, 42, 3.25, -3.25, false, '9999-12-31', '01:02:03', "
+			 "'2000-01-01 00:00:00', '2000-01-01 00:00:00-09:30', 42, 'five', '\\x05')");
+
+	printf("Full result\n");
+	export_result();
+
+	/* unsigned values, and years after 9999 */
+	printf("Wide values\n");
+	exec_sql("SELECT 4294967295::oid AS o, '3000000000'::xid AS x, "
+			 "'12345-06-07'::date AS d, '12345-06-07 08:09:10'::timestamp AS ts, "
+			 "'294276-12-31 00:00:00'::timestamp AS tmax");
+	fetch_batch(1, 1);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	printf("Declare/fetch\n");
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_PGOPT_USE_DECLAREFETCH, (SQLPOINTER) 1, 0);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr USE_DECLAREFETCH failed", conn);
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_PGOPT_FETCH, (SQLPOINTER) 3, 0);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr FETCH failed", conn);
+	export_result();
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
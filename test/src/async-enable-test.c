@@ -1,9 +1,10 @@
 /*
  * Test SQL_ATTR_ASYNC_ENABLE handling.
  *
- * Verifies that setting SQL_ATTR_ASYNC_ENABLE to SQL_ASYNC_ENABLE_ON
- * returns SQL_ERROR (since async is not supported), and that setting
- * SQL_ASYNC_ENABLE_OFF succeeds.
+ * Verifies that SQL_ASYNC_ENABLE_ON is accepted, that a statement executed
+ * asynchronously returns SQL_STILL_EXECUTING until its results arrive, that
+ * it can be cancelled while executing, and that SQL_ASYNC_ENABLE_OFF
+ * brings back the synchronous execution.
  */
 #include <string.h>
 #include <stdio.h>
@@ -11,15 +12,54 @@
 
 #include "common.h"
 
+static void
+print_async_enable(HSTMT hstmt)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	async_enable;
+
+	rc = SQLGetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE,
+						&async_enable, SQL_IS_UINTEGER, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetStmtAttr SQL_ATTR_ASYNC_ENABLE failed", hstmt);
+	printf("async_enable: %s\n",
+		   async_enable == SQL_ASYNC_ENABLE_OFF ? "SQL_ASYNC_ENABLE_OFF" :
+		   async_enable == SQL_ASYNC_ENABLE_ON ? "SQL_ASYNC_ENABLE_ON" :
+		   "other");
+}
+
+/*
+ * Call SQLExecute until it returns something else than SQL_STILL_EXECUTING.
+ */
+static SQLRETURN
+execute_and_poll(HSTMT hstmt, int *polls)
+{
+	SQLRETURN	rc;
+
+	*polls = 0;
+	while (SQL_STILL_EXECUTING == (rc = SQLExecute(hstmt)))
+		(*polls)++;
+	return rc;
+}
+
 int
 main(int argc, char **argv)
 {
 	SQLRETURN	rc;
 	HSTMT		hstmt = SQL_NULL_HSTMT;
-	SQLINTEGER	async_enable;
+	SQLUINTEGER	async_mode;
+	char		param[20] = "async";
+	SQLLEN		cbParam = SQL_NTS;
+	SQLCHAR		sqlstate[6];
+	int			polls;
 
 	test_connect();
 
+	rc = SQLGetInfo(conn, SQL_ASYNC_MODE, &async_mode, sizeof(async_mode), NULL);
+	CHECK_CONN_RESULT(rc, "SQLGetInfo SQL_ASYNC_MODE failed", conn);
+	printf("async mode: %s\n",
+		   async_mode == SQL_AM_STATEMENT ? "SQL_AM_STATEMENT" :
+		   async_mode == SQL_AM_NONE ? "SQL_AM_NONE" : "other");
+
 	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
 	if (!SQL_SUCCEEDED(rc))
 	{
@@ -28,36 +68,71 @@ main(int argc, char **argv)
 	}
 
 	/*
-	 * Test 1: Setting SQL_ASYNC_ENABLE_ON should fail with SQL_ERROR
+	 * Test 1: Setting SQL_ASYNC_ENABLE_ON should succeed
 	 */
 	printf("Setting SQL_ATTR_ASYNC_ENABLE = SQL_ASYNC_ENABLE_ON\n");
 	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE,
 						(SQLPOINTER) SQL_ASYNC_ENABLE_ON, SQL_IS_UINTEGER);
-	if (rc == SQL_ERROR)
-		printf("ok, got SQL_ERROR as expected\n");
-	else
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr SQL_ASYNC_ENABLE_ON failed", hstmt);
+	print_async_enable(hstmt);
+
+	/*
+	 * Test 2: The execution returns SQL_STILL_EXECUTING until the results
+	 * have arrived
+	 */
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT pg_sleep(0.5) IS NULL, ?::text", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+						  SQL_C_CHAR,	/* value type */
+						  SQL_CHAR,		/* param type */
+						  20,			/* column size */
+						  0,			/* dec digits */
+						  param,		/* param value ptr */
+						  0,			/* buffer len */
+						  &cbParam		/* StrLen_or_IndPtr */);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = execute_and_poll(hstmt, &polls);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	printf("got SQL_STILL_EXECUTING: %s\n", polls > 0 ? "yes" : "no");
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/*
+	 * Test 3: Cancel the asynchronous execution
+	 */
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT pg_sleep(10) IS NULL, ?::text", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLExecute(hstmt);
+	printf("SQLExecute returned %s\n",
+		   rc == SQL_STILL_EXECUTING ? "SQL_STILL_EXECUTING" : "other");
+	rc = SQLCancel(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLCancel failed", hstmt);
+	rc = execute_and_poll(hstmt, &polls);
+	if (rc != SQL_ERROR)
 		printf("unexpected result: %d\n", rc);
+	else
+	{
+		SQLGetDiagRec(SQL_HANDLE_STMT, hstmt, 1, sqlstate, NULL, NULL, 0, NULL);
+		printf("cancelled: %s\n", sqlstate);
+	}
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
 
 	/*
-	 * Test 2: Setting SQL_ASYNC_ENABLE_OFF should succeed
+	 * Test 4: Setting SQL_ASYNC_ENABLE_OFF executes synchronously again
 	 */
 	printf("Setting SQL_ATTR_ASYNC_ENABLE = SQL_ASYNC_ENABLE_OFF\n");
 	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE,
 						(SQLPOINTER) SQL_ASYNC_ENABLE_OFF, SQL_IS_UINTEGER);
 	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr SQL_ASYNC_ENABLE_OFF failed", hstmt);
-	printf("ok\n");
-
-	/*
-	 * Test 3: Getting SQL_ATTR_ASYNC_ENABLE should return SQL_ASYNC_ENABLE_OFF
-	 */
-	printf("Getting SQL_ATTR_ASYNC_ENABLE\n");
-	rc = SQLGetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE,
-						&async_enable, SQL_IS_UINTEGER, NULL);
-	CHECK_STMT_RESULT(rc, "SQLGetStmtAttr SQL_ATTR_ASYNC_ENABLE failed", hstmt);
-	printf("async_enable: %s\n",
-		   async_enable == SQL_ASYNC_ENABLE_OFF ? "SQL_ASYNC_ENABLE_OFF" :
-		   async_enable == SQL_ASYNC_ENABLE_ON ? "SQL_ASYNC_ENABLE_ON" :
-		   "other");
+	print_async_enable(hstmt);
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT pg_sleep(0.1) IS NULL, ?::text", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = execute_and_poll(hstmt, &polls);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	printf("got SQL_STILL_EXECUTING: %s\n", polls > 0 ? "yes" : "no");
+	print_result(hstmt);
 
 	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
 	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
@@ -0,0 +1,242 @@
+/*
+ * Test results in binary format (BinaryResults=1).
+ *
+ * The same prepared query is fetched in text and in binary format, into
+ * bound columns of the natural C types and with SQLGetData(SQL_C_CHAR),
+ * and the values must be the same. The rows include NULLs, the limits
+ * of the integer types, infinities, NaN and BC dates and timestamps.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define NROWS	5
+#define NCOLS	12
+#define VALLEN	128
+
+static const char *query =
+	"SELECT i2, i4, i8, f4, f8, b, n, d, t, ts, u, by FROM (VALUES "
+	"(1, 1::int2, 100000::int4, 10000000000::int8, 1.5::float4, 0.1::float8, true,"
+	" 12345.678::numeric, '2024-02-29'::date, '12:34:56.5'::time,"
+	" '2024-02-29 12:34:56.123456'::timestamp,"
+	" 'a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11'::uuid, '\\x0001ff'::bytea), "
+	"(2, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL), "
+	"(3, -32768, -2147483648, -9223372036854775808, 'Infinity', '-Infinity', false,"
+	" -0.001, 'infinity', '00:00:00', '-infinity',"
+	" '00000000-0000-0000-0000-000000000000', ''), "
+	"(4, 32767, 2147483647, 9223372036854775807, 'NaN', 1e300, false,"
+	" 'NaN', '0044-03-15 BC', '24:00:00', '0044-03-15 12:30:00.25 BC',"
+	" 'ffffffff-ffff-ffff-ffff-ffffffffffff', '\\xdeadbeef'), "
+	"(5, 0, 0, 0, -0.25, 123456789.125, true,"
+	" 0.000, '0001-01-01 BC', '23:59:59.999999', '0001-12-31 23:59:59.999999 BC',"
+	" '12345678-9abc-def0-1234-56789abcdef0', '\\x00')"
+	") AS v(k, i2, i4, i8, f4, f8, b, n, d, t, ts, u, by) WHERE k >= ? ORDER BY k";
+
+static const char *colnames[NCOLS] =
+	{"int2", "int4", "int8", "float4", "float8", "bool", "numeric", "date", "time", "timestamp", "uuid", "bytea"};
+
+/* the C type each column is bound to */
+static const SQLSMALLINT ctypes[NCOLS] =
+	{SQL_C_SSHORT, SQL_C_SLONG, SQL_C_SBIGINT, SQL_C_FLOAT, SQL_C_DOUBLE, SQL_C_BIT,
+	 SQL_C_CHAR, SQL_C_TYPE_DATE, SQL_C_CHAR, SQL_C_TYPE_TIMESTAMP, SQL_C_GUID, SQL_C_BINARY};
+
+/* [0]: text format, [1]: binary format */
+static char bound[2][NROWS][NCOLS][VALLEN];
+static char chars[2][NROWS][NCOLS][VALLEN];
+
+static void
+format_double(char *out, double d, int prec)
+{
+	if (isnan(d))
+		snprintf(out, VALLEN, "NaN");
+	else
+		snprintf(out, VALLEN, "%.*g", prec, d);
+}
+
+/* Render the bound value of the C type as a string */
+static void
+format_bound(char *out, SQLSMALLINT ctype, const void *buf, SQLLEN ind)
+{
+	int			i;
+
+	if (SQL_NULL_DATA == ind)
+	{
+		snprintf(out, VALLEN, "NULL");
+		return;
+	}
+	switch (ctype)
+	{
+		case SQL_C_SSHORT:
+			snprintf(out, VALLEN, "%d", *(const SQLSMALLINT *) buf);
+			break;
+		case SQL_C_SLONG:
+			snprintf(out, VALLEN, "%d", (int) *(const SQLINTEGER *) buf);
+			break;
+		case SQL_C_SBIGINT:
+			snprintf(out, VALLEN, "%lld", (long long) *(const SQLBIGINT *) buf);
+			break;
+		case SQL_C_FLOAT:
+			format_double(out, *(const SQLREAL *) buf, 9);
+			break;
+		case SQL_C_DOUBLE:
+			format_double(out, *(const SQLDOUBLE *) buf, 17);
+			break;
+		case SQL_C_BIT:
+			snprintf(out, VALLEN, "%d", *(const unsigned char *) buf);
+			break;
+		case SQL_C_TYPE_DATE:
+			{
+				const SQL_DATE_STRUCT *ds = buf;
+
+				snprintf(out, VALLEN, "%d-%d-%d", ds->year, ds->month, ds->day);
+			}
+			break;
+		case SQL_C_TYPE_TIMESTAMP:
+			{
+				const SQL_TIMESTAMP_STRUCT *ts = buf;
+
+				snprintf(out, VALLEN, "%d-%d-%d %d:%d:%d.%u",
+						 ts->year, ts->month, ts->day,
+						 ts->hour, ts->minute, ts->second,
+						 (unsigned int) ts->fraction);
+			}
+			break;
+		case SQL_C_GUID:
+			{
+				const SQLGUID *g = buf;
+
+				snprintf(out, VALLEN, "%08x-%04x-%04x-%02x%02x",
+						 (unsigned int) g->Data1, g->Data2, g->Data3,
+						 g->Data4[0], g->Data4[1]);
+				for (i = 2; i < 8; i++)
+					snprintf(out + strlen(out), VALLEN - strlen(out), "%02x", g->Data4[i]);
+			}
+			break;
+		case SQL_C_BINARY:
+			out[0] = '\0';
+			for (i = 0; i < ind && i < (VALLEN - 1) / 2; i++)
+				snprintf(out + 2 * i, VALLEN - 2 * i, "%02x", ((const unsigned char *) buf)[i]);
+			break;
+		default:
+			snprintf(out, VALLEN, "%s", (const char *) buf);
+			break;
+	}
+}
+
+static HSTMT
+execute_query(void)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLSMALLINT	numcols;
+	static SQLINTEGER	minkey = 0;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLPrepare(hstmt, (SQLCHAR *) query, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	/* the result columns are known before the execution */
+	rc = SQLNumResultCols(hstmt, &numcols);
+	CHECK_STMT_RESULT(rc, "SQLNumResultCols failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER,
+						  0, 0, &minkey, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	return hstmt;
+}
+
+static void
+fetch_values(int format)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt;
+	char		buf[NCOLS][VALLEN];
+	SQLLEN		ind[NCOLS];
+	int			row, col;
+
+	/* into bound columns */
+	hstmt = execute_query();
+	for (col = 0; col < NCOLS; col++)
+	{
+		rc = SQLBindCol(hstmt, col + 1, ctypes[col], buf[col], VALLEN, &ind[col]);
+		CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	}
+	for (row = 0; row < NROWS; row++)
+	{
+		memset(buf, 0, sizeof(buf));
+		rc = SQLFetch(hstmt);
+		if (SQL_NO_DATA == rc)
+			break;
+		for (col = 0; col < NCOLS; col++)
+		{
+			if (SQL_SUCCEEDED(rc))
+				format_bound(bound[format][row][col], ctypes[col], buf[col], ind[col]);
+			else
+				snprintf(bound[format][row][col], VALLEN, "error");
+		}
+	}
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* by SQLGetData(SQL_C_CHAR) */
+	hstmt = execute_query();
+	for (row = 0; row < NROWS; row++)
+	{
+		rc = SQLFetch(hstmt);
+		if (SQL_NO_DATA == rc)
+			break;
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		for (col = 0; col < NCOLS; col++)
+		{
+			rc = SQLGetData(hstmt, col + 1, SQL_C_CHAR, chars[format][row][col], VALLEN, &ind[col]);
+			if (!SQL_SUCCEEDED(rc))
+				snprintf(chars[format][row][col], VALLEN, "error");
+			else if (SQL_NULL_DATA == ind[col])
+				snprintf(chars[format][row][col], VALLEN, "NULL");
+		}
+	}
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	int			row, col, nmismatch;
+
+	test_connect_ext("BinaryResults=0");
+	fetch_values(0);
+	test_disconnect();
+
+	test_connect_ext("BinaryResults=1");
+	fetch_values(1);
+	test_disconnect();
+
+	for (row = 0; row < NROWS; row++)
+	{
+		nmismatch = 0;
+		for (col = 0; col < NCOLS; col++)
+		{
+			if (strcmp(bound[0][row][col], bound[1][row][col]) != 0)
+			{
+				printf("row %d %s bound: text \"%s\" binary \"%s\"\n", row + 1, colnames[col], bound[0][row][col], bound[1][row][col]);
+				nmismatch++;
+			}
+			if (strcmp(chars[0][row][col], chars[1][row][col]) != 0)
+			{
+				printf("row %d %s as char: text \"%s\" binary \"%s\"\n", row + 1, colnames[col], chars[0][row][col], chars[1][row][col]);
+				nmismatch++;
+			}
+		}
+		printf("row %d: %d mismatches\n", row + 1, nmismatch);
+	}
+
+	return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * Test SQLBulkOperations() on whole rowsets, which are added, updated
+ * and deleted with one statement.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define	ROWSET	4
+#define	BOOKMARK_SIZE	14
+
+static SQLUSMALLINT	rowStatus[ROWSET];
+
+static void
+print_row_status(const char *operation)
+{
+	int		i;
+
+	printf("%s:", operation);
+	for (i = 0; i < ROWSET; i++)
+		printf(" %d", rowStatus[i]);
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	HSTMT		hstmt2 = SQL_NULL_HSTMT;
+	int			i;
+	SQLINTEGER	colvalues1[ROWSET];
+	SQLINTEGER	colvalues2[ROWSET];
+	SQLLEN		indColvalues1[ROWSET];
+	SQLLEN		indColvalues2[ROWSET];
+	char		bookmarks[ROWSET][BOOKMARK_SIZE];
+	SQLLEN		bookmark_inds[ROWSET];
+
+	test_connect_ext("UpdatableCursors=1");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	printf("Creating test table bulkoperations_rowset\n");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE bulkoperations_rowset(i int4, orig serial)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO bulkoperations_rowset(i) SELECT g FROM generate_series(1, 10) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CONCURRENCY,
+						(SQLPOINTER) SQL_CONCUR_ROWVER, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+						(SQLPOINTER) SQL_CURSOR_KEYSET_DRIVEN, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_USE_BOOKMARKS,
+						(SQLPOINTER) SQL_UB_VARIABLE, SQL_IS_UINTEGER);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, (SQLPOINTER) rowStatus, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLBindCol(hstmt, 0, SQL_C_VARBOOKMARK, bookmarks, BOOKMARK_SIZE, bookmark_inds);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_LONG, colvalues1, 0, indColvalues1);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_LONG, colvalues2, 0, indColvalues2);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT * FROM bulkoperations_rowset ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	/* Update the first rowset */
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, 1);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	for (i = 0; i < ROWSET; i++)
+		colvalues1[i] += 100;
+	rc = SQLBulkOperations(hstmt, SQL_UPDATE_BY_BOOKMARK);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+	print_row_status("update");
+
+	/* Delete the second rowset */
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, 5);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	rc = SQLBulkOperations(hstmt, SQL_DELETE_BY_BOOKMARK);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+	print_row_status("delete");
+
+	/* Add a rowset, letting the serial column default */
+	for (i = 0; i < ROWSET; i++)
+	{
+		colvalues1[i] = 1001 + i;
+		indColvalues1[i] = 0;
+		indColvalues2[i] = SQL_IGNORE;
+	}
+	rc = SQLBulkOperations(hstmt, SQL_ADD);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+	print_row_status("add");
+
+	/* Fetch the added rows by their bookmarks */
+	rc = SQLBulkOperations(hstmt, SQL_FETCH_BY_BOOKMARK);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+	for (i = 0; i < ROWSET; i++)
+		printf("added row: %d - %d\n", (int) colvalues1[i], (int) colvalues2[i]);
+
+	/* Add a rowset of which a BEFORE INSERT trigger skips some rows */
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt2);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *)
+		"CREATE OR REPLACE FUNCTION bulkoperations_skip_odd() RETURNS TRIGGER"
+		" AS $$"
+		" BEGIN"
+		"  IF NEW.i % 2 = 1 THEN RETURN NULL; END IF;"
+		"  RETURN NEW;"
+		" END;"
+		" $$ LANGUAGE plpgsql", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "create function failed", hstmt2);
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *)
+		"CREATE TRIGGER bulkoperations_skip_odd"
+		" BEFORE INSERT ON bulkoperations_rowset"
+		" FOR EACH ROW EXECUTE PROCEDURE bulkoperations_skip_odd()", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "create trigger failed", hstmt2);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt2);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt2);
+	for (i = 0; i < ROWSET; i++)
+	{
+		colvalues1[i] = 2001 + i;
+		indColvalues1[i] = 0;
+		indColvalues2[i] = SQL_IGNORE;
+	}
+	rc = SQLBulkOperations(hstmt, SQL_ADD);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+	print_row_status("add with trigger");
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	printf("\nQuerying the table again\n");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT * FROM bulkoperations_rowset ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * Test sending and fetching bytea values of the sizes around the blocks
+ * of the hex encoding and decoding, and a large one.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+static HSTMT	hstmt = SQL_NULL_HSTMT;
+
+static const SQLLEN sizes[] = {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000, 3 * 1024 * 1024 + 7};
+
+static void
+fill_value(unsigned char *buf, SQLLEN len)
+{
+	SQLLEN		i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = (unsigned char) (i * 7 + len);
+}
+
+static void
+close_stmt(void)
+{
+	SQLRETURN	rc;
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt RESET_PARAMS failed", hstmt);
+}
+
+static void
+test_size(SQLLEN len)
+{
+	SQLRETURN	rc;
+	unsigned char *value = malloc(len + 1);
+	char	   *hex = malloc(2 * len + 1);
+	char	   *buf = malloc(4 * len + 4);
+	SQLWCHAR   *wbuf;
+	SQLLEN		ind, valind, hexind, i;
+	char		ok[20];
+	int			binary_ok, char_ok, wchar_ok;
+
+	fill_value(value, len);
+	for (i = 0; i < len; i++)
+		sprintf(hex + 2 * i, "%02x", value[i]);
+	hex[2 * len] = '\0';
+
+	/* send the value as a bytea parameter and let the server check it */
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+						  SQL_LONGVARBINARY, len, 0, value, len, &valind);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	valind = len;
+	hexind = SQL_NTS;
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR,
+						  SQL_LONGVARCHAR, 2 * len + 1, 0, hex, 2 * len + 1, &hexind);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT ?::bytea = decode(?, 'hex')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, ok, sizeof(ok), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	close_stmt();
+
+	/* fetch it back as binary, char and wchar */
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR,
+						  SQL_LONGVARCHAR, 2 * len + 1, 0, hex, 2 * len + 1, &hexind);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT decode(?, 'hex')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+
+	rc = SQLGetData(hstmt, 1, SQL_C_BINARY, buf, 4 * len + 4, &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	binary_ok = (ind == len && 0 == memcmp(buf, value, len));
+
+	/* the hex digits come in upper case */
+	for (i = 0; i < 2 * len; i++)
+		if (hex[i] >= 'a')
+			hex[i] -= 'a' - 'A';
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, 4 * len + 4, &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	char_ok = (ind == 2 * len && 0 == strcmp(buf, hex));
+
+	rc = SQLGetData(hstmt, 1, SQL_C_WCHAR, buf, 4 * len + 4, &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	wbuf = (SQLWCHAR *) buf;
+	wchar_ok = (ind == 2 * len * sizeof(SQLWCHAR));
+	for (i = 0; wchar_ok && i < 2 * len; i++)
+		wchar_ok = (wbuf[i] == (SQLWCHAR) (unsigned char) hex[i]);
+	close_stmt();
+
+	printf("%d bytes: parameter %s, binary %s, char %s, wchar %s\n",
+		   (int) len, ok,
+		   binary_ok ? "ok" : "mismatch",
+		   char_ok ? "ok" : "mismatch",
+		   wchar_ok ? "ok" : "mismatch");
+	free(value);
+	free(hex);
+	free(buf);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	int			i;
+
+	test_connect_ext("UseServerSidePrepare=0");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	CHECK_STMT_RESULT(rc, "SQLAllocHandle failed", hstmt);
+
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+		test_size(sizes[i]);
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
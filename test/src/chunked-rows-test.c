@@ -0,0 +1,104 @@
+/*
+ * Test reading results in chunks of Fetch rows (libpq chunked-rows mode,
+ * or single-row mode with older libpq versions).
+ *
+ * The results cross several chunk boundaries, and one query fails in the
+ * middle of its rows.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+static void
+print_sqlstate(const char *what, HSTMT hstmt)
+{
+	SQLCHAR		sqlstate[6];
+
+	SQLGetDiagRec(SQL_HANDLE_STMT, hstmt, 1, sqlstate, NULL, NULL, 0, NULL);
+	printf("%s failed with %s\n", what, sqlstate);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	id[5];
+	SQLLEN		cbLen[5];
+	SQLULEN		rowsFetched;
+	int			totalRows = 0;
+
+	/* chunks of 7 rows */
+	test_connect_ext("UseDeclareFetch=0;Fetch=7");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	/* 4 full chunks and a partial one */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, 'row ' || g FROM generate_series(1, 30) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* exactly 3 chunks, then a result in the same query */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 21) g; SELECT 'second ' || g FROM generate_series(1, 9) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLMoreResults(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLMoreResults failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* rowsets of 5 which don't line up with the chunks */
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 5, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_ARRAY_SIZE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &rowsFetched, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROWS_FETCHED_PTR failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, &id, 0, cbLen);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 23) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		totalRows += (int) rowsFetched;
+		printf("fetched rows=%d, first=%d, last=%d, total rows=%d\n", (int) rowsFetched, (int) id[0], (int) id[rowsFetched - 1], totalRows);
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_ARRAY_SIZE failed", hstmt);
+
+	/* an error after 2 chunks have been received */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, 100 / (17 - g) FROM generate_series(1, 30) g", SQL_NTS);
+	if (SQL_SUCCEEDED(rc))
+	{
+		printf("the query succeeded unexpectedly\n");
+		exit(1);
+	}
+	print_sqlstate("the query", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* the connection is still usable */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 8) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Test the column information cache used by Parse=1, when there are
+ * more tables than the cache can hold, and after its explicit refresh.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "../../pgapifunc.h"
+
+static HSTMT	hstmt = SQL_NULL_HSTMT;
+
+static void
+exec_sql(const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+print_meta(const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result_meta(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+
+	test_connect_ext("Parse=1;ColumnInfoCacheSize=2");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	exec_sql("CREATE TEMPORARY TABLE colicache1 (a int4 NOT NULL, b varchar(10))");
+	exec_sql("CREATE TEMPORARY TABLE colicache2 (c int2, d int8 NOT NULL)");
+	exec_sql("CREATE TEMPORARY TABLE colicache3 (e varchar(5) NOT NULL)");
+
+	/* More tables than the cache holds, then the first one again */
+	print_meta("SELECT * FROM colicache1");
+	print_meta("SELECT * FROM colicache2");
+	print_meta("SELECT * FROM colicache3");
+	print_meta("SELECT * FROM colicache1");
+	print_meta("SELECT d, a FROM colicache2, colicache1 WHERE c = a");
+
+	/* DDL the driver doesn't notice, then an explicit refresh */
+	exec_sql("DO $$BEGIN ALTER TABLE colicache1 ALTER COLUMN b SET NOT NULL; END$$");
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_PGOPT_REFRESH_COLUMN_INFO, (SQLPOINTER) 1, 0);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr REFRESH_COLUMN_INFO failed", conn);
+	print_meta("SELECT * FROM colicache1");
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
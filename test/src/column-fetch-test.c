@@ -0,0 +1,126 @@
+/*
+ * Test fetching rowsets into column-wise bound arrays, with NULLs and
+ * truncated values, from a full result and from a COPY stream read a
+ * block at a time.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	ROWSET	100
+
+static HSTMT	hstmt = SQL_NULL_HSTMT;
+
+static void
+exec_sql(const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+}
+
+static void
+fetch_rowsets(const char *label)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	id[ROWSET];
+	SQLLEN		idind[ROWSET];
+	SQLBIGINT	b[ROWSET];
+	SQLLEN		bind[ROWSET];
+	SQLDOUBLE	f[ROWSET];
+	SQLLEN		find[ROWSET];
+	SQLSMALLINT	s[ROWSET];
+	char		t[ROWSET][6];
+	SQLLEN		tind[ROWSET];
+	SQLULEN		nrows, i;
+	int			rowset;
+
+	printf("%s\n", label);
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	exec_sql("CREATE TEMPORARY TABLE colfetch (id int4, b int8, f float8, s int2, t text)");
+	exec_sql("INSERT INTO colfetch SELECT g, g * 1000000000000, "
+			 "CASE WHEN g % 7 = 0 THEN NULL ELSE g / 4.0 END, -g, "
+			 "CASE WHEN g % 7 = 0 THEN NULL ELSE 'row ' || g END "
+			 "FROM generate_series(1, 250) g");
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER) SQL_BIND_BY_COLUMN, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_BIND_TYPE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_ARRAY_SIZE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &nrows, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROWS_FETCHED_PTR failed", hstmt);
+
+	exec_sql("SELECT id, b, f, s, t FROM colfetch ORDER BY id");
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, id, 0, idind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_SBIGINT, b, 0, bind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 3, SQL_C_DOUBLE, f, 0, find);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	/* no length nor indicator */
+	rc = SQLBindCol(hstmt, 4, SQL_C_SSHORT, s, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 5, SQL_C_CHAR, t, sizeof(t[0]), tind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	for (rowset = 1; ; rowset++)
+	{
+		long long	idsum = 0, bsum = 0;
+		double		fsum = 0;
+		int			ssum = 0, nulls = 0, truncated = 0;
+
+		rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0);
+		if (SQL_NO_DATA == rc)
+			break;
+		CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+		for (i = 0; i < nrows; i++)
+		{
+			if (idind[i] != sizeof(SQLINTEGER) || bind[i] != sizeof(SQLBIGINT))
+				printf("row %d: unexpected length\n", (int) id[i]);
+			idsum += id[i];
+			bsum += b[i];
+			ssum += s[i];
+			if (SQL_NULL_DATA == find[i])
+				nulls++;
+			else
+				fsum += f[i];
+			if (SQL_NULL_DATA != tind[i] && tind[i] >= (SQLLEN) sizeof(t[0]))
+				truncated++;
+			if ((SQL_NULL_DATA == tind[i]) != (SQL_NULL_DATA == find[i]))
+				printf("row %d: unexpected NULL\n", (int) id[i]);
+		}
+		printf("rowset %d: %s, %d rows, id %lld, b %lld, f %g, s %d, %d NULLs, %d truncated, last '%s'\n",
+			   rowset, SQL_SUCCESS == rc ? "success" : "with info",
+			   (int) nrows, idsum, bsum, fsum, ssum, nulls, truncated,
+			   t[nrows - 1]);
+	}
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+	hstmt = SQL_NULL_HSTMT;
+}
+
+int main(int argc, char **argv)
+{
+	test_connect();
+	fetch_rowsets("Full result");
+	test_disconnect();
+
+	/* the rows are read 30 at a time, fewer than a rowset */
+	test_connect_ext("CopyStream=1;Fetch=30");
+	fetch_rowsets("CopyStream");
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
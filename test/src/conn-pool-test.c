@@ -0,0 +1,131 @@
+/*
+ * Test the driver-internal connection pool (ConnPoolSize option).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+static void
+pool_connect(const char *extraparams)
+{
+	SQLRETURN	rc;
+	SQLCHAR		dsn[1024];
+	SQLCHAR		str[1024];
+	SQLSMALLINT	strl;
+
+	snprintf((char *) dsn, sizeof(dsn), "DSN=%s;ConnPoolSize=1;%s",
+			 get_test_dsn(), extraparams);
+	rc = SQLDriverConnect(conn, NULL, dsn, SQL_NTS,
+						  str, sizeof(str), &strl,
+						  SQL_DRIVER_COMPLETE);
+	CHECK_CONN_RESULT(rc, "SQLDriverConnect failed", conn);
+	printf("connected\n");
+}
+
+static void
+pool_disconnect(void)
+{
+	SQLRETURN	rc;
+
+	rc = SQLDisconnect(conn);
+	CHECK_CONN_RESULT(rc, "SQLDisconnect failed", conn);
+	printf("disconnected\n");
+}
+
+static void
+exec_stmt(const char *sql)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	CHECK_CONN_RESULT(rc, "failed to allocate stmt handle", conn);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+static void
+get_value(const char *sql, char *buf, SQLLEN buflen)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLLEN		ind;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	CHECK_CONN_RESULT(rc, "failed to allocate stmt handle", conn);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, buflen, &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+#define	PID_QUERY	"SELECT pg_backend_pid()"
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	char		pid[32], pid2[32], work_mem[64], value[64];
+
+	SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &env);
+	SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (void *) SQL_OV_ODBC3, 0);
+	SQLAllocHandle(SQL_HANDLE_DBC, env, &conn);
+
+	/* The session state is discarded before the connection is reused */
+	pool_connect("");
+	get_value(PID_QUERY, pid, sizeof(pid));
+	get_value("SHOW work_mem", work_mem, sizeof(work_mem));
+	exec_stmt("SET work_mem = '1234kB'");
+	exec_stmt("CREATE TEMPORARY TABLE pooltmp (i int4)");
+	pool_disconnect();
+
+	pool_connect("");
+	get_value(PID_QUERY, pid2, sizeof(pid2));
+	printf("same server connection: %s\n", strcmp(pid, pid2) == 0 ? "yes" : "no");
+	get_value("SHOW work_mem", value, sizeof(value));
+	printf("work_mem reset: %s\n", strcmp(work_mem, value) == 0 ? "yes" : "no");
+	get_value("SELECT count(*) FROM pg_class WHERE relname = 'pooltmp' AND relpersistence = 't'", value, sizeof(value));
+	printf("temporary tables: %s\n", value);
+	pool_disconnect();
+
+	/* A connection left in a transaction is rolled back and reused */
+	pool_connect("");
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, 0);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr failed", conn);
+	exec_stmt("SET LOCAL work_mem = '2345kB'");
+	pool_disconnect();
+
+	pool_connect("");
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_ON, 0);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr failed", conn);
+	get_value(PID_QUERY, pid2, sizeof(pid2));
+	printf("same server connection: %s\n", strcmp(pid, pid2) == 0 ? "yes" : "no");
+	get_value("SHOW work_mem", value, sizeof(value));
+	printf("work_mem reset: %s\n", strcmp(work_mem, value) == 0 ? "yes" : "no");
+	pool_disconnect();
+
+	/* The health check doesn't change the key of the pool */
+	pool_connect("PoolHealthCheck=1");
+	get_value(PID_QUERY, pid2, sizeof(pid2));
+	printf("same server connection: %s\n", strcmp(pid, pid2) == 0 ? "yes" : "no");
+	pool_disconnect();
+
+	/* Different per datasource settings don't share connections */
+	pool_connect("ConnSettings={SET work_mem = '3456kB'}");
+	get_value(PID_QUERY, pid2, sizeof(pid2));
+	printf("same server connection: %s\n", strcmp(pid, pid2) == 0 ? "yes" : "no");
+	get_value("SHOW work_mem", value, sizeof(value));
+	printf("work_mem: %s\n", value);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
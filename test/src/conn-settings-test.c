@@ -2,15 +2,35 @@
  * Test connection settings parsing.
  */
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "common.h"
 
 int
 main(void)
 {
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
 	printf("Testing client_encoding extraction at end of ConnSettings...\n");
 	test_connect_ext("ConnSettings=set+client_encoding+to+UTF8");
 	test_disconnect();
 
+	/* ODBC escapes in ConnSettings are converted as in other statements */
+	printf("Testing ODBC escapes in ConnSettings...\n");
+	test_connect_ext("ConnSettings=CREATE+TEMPORARY+TABLE+connsettings_escape+AS+SELECT+%7Bfn+ucase('abc')%7D+AS+u,+%7Bd+'2020-01-02'%7D+AS+d%3BSET+application_name+TO+'conn-settings-test'");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT u, d, current_setting('application_name') FROM connsettings_escape", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+	test_disconnect();
+
 	return 0;
 }
@@ -0,0 +1,224 @@
+/*
+ * Test that the conversions of the bound columns follow the changes of
+ * the bindings and of the result columns between the fetches.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	ROWSET	3
+
+static HSTMT	hstmt = SQL_NULL_HSTMT;
+
+static void
+exec_sql(const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+}
+
+static void
+close_stmt(void)
+{
+	SQLRETURN	rc;
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt UNBIND failed", hstmt);
+}
+
+static void
+bind_col(SQLUSMALLINT col, SQLSMALLINT ctype, SQLPOINTER buf, SQLLEN buflen, SQLLEN *ind)
+{
+	SQLRETURN	rc;
+
+	rc = SQLBindCol(hstmt, col, ctype, buf, buflen, ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+}
+
+static void
+fetch(void)
+{
+	SQLRETURN	rc;
+
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+}
+
+static void
+print_long(const char *label, SQLINTEGER val, SQLLEN ind)
+{
+	if (SQL_NULL_DATA == ind)
+		printf("%s=NULL", label);
+	else
+		printf("%s=%d", label, (int) val);
+}
+
+static void
+print_double(const char *label, SQLDOUBLE val, SQLLEN ind)
+{
+	if (SQL_NULL_DATA == ind)
+		printf("%s=NULL", label);
+	else
+		printf("%s=%g", label, val);
+}
+
+static void
+print_bigint(const char *label, SQLBIGINT val, SQLLEN ind)
+{
+	if (SQL_NULL_DATA == ind)
+		printf("%s=NULL", label);
+	else
+		printf("%s=%lld", label, (long long) val);
+}
+
+static void
+print_char(const char *label, const char *val, SQLLEN ind)
+{
+	if (SQL_NULL_DATA == ind)
+		printf("%s=NULL", label);
+	else
+		printf("%s='%s'", label, val);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	id, id2;
+	SQLLEN		idind, id2ind;
+	SQLDOUBLE	f;
+	SQLREAL		fr;
+	SQLLEN		find;
+	SQLBIGINT	b;
+	SQLLEN		bind;
+	char		t[20], idc[20];
+	SQLLEN		tind, idcind;
+	struct
+	{
+		SQLINTEGER	id;
+		SQLLEN		idind;
+		SQLDOUBLE	n;
+		SQLLEN		nind;
+		char		t[20];
+		SQLLEN		tind;
+	}			rows[ROWSET + 1];
+	SQLULEN		nrows, i;
+	SQLULEN		offset;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	exec_sql("CREATE TEMPORARY TABLE plantest (id int4, f float8, n numeric, b int8, t text)");
+	exec_sql("INSERT INTO plantest VALUES "
+			 "(1, 1.5, 10.25, 10000000000, 'one'), "
+			 "(2, NULL, NULL, NULL, 'two'), "
+			 "(3, -2.25, -3, -5, 'three'), "
+			 "(4, 0.125, 4.75, 4, 'four'), "
+			 "(5, 100, 5, 5, 'five')");
+
+	/* Rebind between the fetches */
+	printf("Rebinding\n");
+	exec_sql("SELECT id, f, b, t FROM plantest ORDER BY id");
+	bind_col(1, SQL_C_SLONG, &id, 0, &idind);
+	bind_col(2, SQL_C_DOUBLE, &f, 0, &find);
+	bind_col(3, SQL_C_SBIGINT, &b, 0, &bind);
+	bind_col(4, SQL_C_CHAR, t, sizeof(t), &tind);
+	for (i = 0; i < 2; i++)
+	{
+		fetch();
+		print_long("id", id, idind);
+		print_double(" f", f, find);
+		print_bigint(" b", b, bind);
+		print_char(" t", t, tind);
+		printf("\n");
+	}
+
+	/* another C type */
+	bind_col(1, SQL_C_CHAR, idc, sizeof(idc), &idcind);
+	bind_col(2, SQL_C_FLOAT, &fr, 0, &find);
+	fetch();
+	print_char("id", idc, idcind);
+	print_double(" f", fr, find);
+	printf("\n");
+
+	/* another buffer of the same C type */
+	bind_col(1, SQL_C_SLONG, &id2, 0, &id2ind);
+	fetch();
+	print_long("id", id2, id2ind);
+	print_double(" f", fr, find);
+	printf("\n");
+
+	/* no length nor indicator */
+	id = -1;
+	bind_col(1, SQL_C_SLONG, &id, 0, NULL);
+	fetch();
+	print_long("id", id, 0);
+	printf("\n");
+	close_stmt();
+
+	/* Row-wise binding of the rowsets, with the bind offset */
+	printf("Row-wise binding\n");
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER) sizeof(rows[0]), 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_BIND_TYPE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_ARRAY_SIZE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &nrows, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROWS_FETCHED_PTR failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_BIND_OFFSET_PTR, (SQLPOINTER) &offset, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_BIND_OFFSET_PTR failed", hstmt);
+	exec_sql("SELECT id, n, t FROM plantest ORDER BY id");
+	bind_col(1, SQL_C_SLONG, &rows[0].id, 0, &rows[0].idind);
+	bind_col(2, SQL_C_DOUBLE, &rows[0].n, 0, &rows[0].nind);
+	bind_col(3, SQL_C_CHAR, rows[0].t, sizeof(rows[0].t), &rows[0].tind);
+	for (offset = 0; offset <= sizeof(rows[0]); offset += sizeof(rows[0]))
+	{
+		memset(rows, 0, sizeof(rows));
+		fetch();
+		printf("offset %d: %d rows\n", (int) (offset / sizeof(rows[0])), (int) nrows);
+		for (i = 0; i <= ROWSET; i++)
+		{
+			printf("  ");
+			print_long("id", rows[i].id, rows[i].idind);
+			print_double(" n", rows[i].n, rows[i].nind);
+			print_char(" t", rows[i].t, rows[i].tind);
+			printf("\n");
+		}
+	}
+	close_stmt();
+
+	/* The same bindings for another result */
+	printf("Another result\n");
+	offset = 0;
+	exec_sql("SELECT b % 1000000, f, t FROM plantest ORDER BY id");
+	bind_col(1, SQL_C_SLONG, &rows[0].id, 0, &rows[0].idind);
+	bind_col(2, SQL_C_DOUBLE, &rows[0].n, 0, &rows[0].nind);
+	bind_col(3, SQL_C_CHAR, rows[0].t, sizeof(rows[0].t), &rows[0].tind);
+	memset(rows, 0, sizeof(rows));
+	fetch();
+	printf("%d rows\n", (int) nrows);
+	for (i = 0; i < nrows; i++)
+	{
+		printf("  ");
+		print_long("b", rows[i].id, rows[i].idind);
+		print_double(" f", rows[i].n, rows[i].nind);
+		print_char(" t", rows[i].t, rows[i].tind);
+		printf("\n");
+	}
+	close_stmt();
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Test converting the ISO DateStyle output of dates, times, timestamps
+ * and intervals to the ODBC structs.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	NUM_ROWS	10000
+
+static HSTMT	hstmt = SQL_NULL_HSTMT;
+
+static void
+exec_sql(const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+}
+
+static void
+close_stmt(void)
+{
+	SQLRETURN	rc;
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt UNBIND failed", hstmt);
+}
+
+static void
+fetch_timestamp(const char *value)
+{
+	SQLRETURN	rc;
+	SQL_TIMESTAMP_STRUCT	ts;
+	SQLLEN		ind;
+	char		sql[100];
+
+	snprintf(sql, sizeof(sql), "SELECT %s", value);
+	exec_sql(sql);
+	rc = SQLBindCol(hstmt, 1, SQL_C_TYPE_TIMESTAMP, &ts, sizeof(ts), &ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("%s: %d-%02d-%02d %02d:%02d:%02d fraction=%d\n", value,
+		   (int) ts.year, (int) ts.month, (int) ts.day,
+		   (int) ts.hour, (int) ts.minute, (int) ts.second,
+		   (int) ts.fraction);
+	close_stmt();
+}
+
+static void
+fetch_interval(const char *value)
+{
+	SQLRETURN	rc;
+	SQL_INTERVAL_STRUCT	iv;
+	SQLLEN		ind;
+	char		sql[100];
+
+	snprintf(sql, sizeof(sql), "SELECT %s", value);
+	exec_sql(sql);
+	rc = SQLBindCol(hstmt, 1, SQL_C_INTERVAL_DAY_TO_SECOND, &iv, sizeof(iv), &ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("%s: sign=%d day=%d hour=%d min=%d sec=%d frac=%d\n", value,
+		   (int) iv.interval_sign,
+		   (int) iv.intval.day_second.day,
+		   (int) iv.intval.day_second.hour,
+		   (int) iv.intval.day_second.minute,
+		   (int) iv.intval.day_second.second,
+		   (int) iv.intval.day_second.fraction);
+	close_stmt();
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	SQL_DATE_STRUCT	ds;
+	SQL_TIME_STRUCT	tms;
+	SQL_TIMESTAMP_STRUCT	ts;
+	SQLINTEGER	parts[7];
+	SQLLEN		ind, partinds[7];
+	int			i, nrows, mismatches;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	CHECK_STMT_RESULT(rc, "SQLAllocHandle failed", hstmt);
+
+	exec_sql("SET intervalstyle=postgres");
+	close_stmt();
+	exec_sql("SET timezone=UTC");
+	close_stmt();
+
+	fetch_timestamp("'2024-03-15 12:34:56.123456'::timestamp");
+	fetch_timestamp("'2024-03-15 12:34:56'::timestamp");
+	fetch_timestamp("'2024-03-15 12:34:56.5+00'::timestamptz");
+	fetch_timestamp("'0044-03-15 10:00:00 BC'::timestamp");
+	fetch_timestamp("'infinity'::timestamp");
+	fetch_timestamp("'-infinity'::timestamp");
+
+	exec_sql("SELECT '2024-02-29'::date, '23:59:59.999999'::time");
+	rc = SQLBindCol(hstmt, 1, SQL_C_TYPE_DATE, &ds, sizeof(ds), &ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_TYPE_TIME, &tms, sizeof(tms), &ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("date: %d-%02d-%02d\n", (int) ds.year, (int) ds.month, (int) ds.day);
+	printf("time: %02d:%02d:%02d\n", (int) tms.hour, (int) tms.minute, (int) tms.second);
+	close_stmt();
+
+	fetch_interval("'3 days 04:05:06.5'::interval");
+	fetch_interval("'-3 days -04:05:06'::interval");
+	fetch_interval("'04:05:06'::interval");
+
+	/* Compare many timestamps with the fields the server extracts */
+	exec_sql("SELECT ts, extract(year from ts)::int, extract(month from ts)::int,"
+			 " extract(day from ts)::int, extract(hour from ts)::int,"
+			 " extract(minute from ts)::int, floor(extract(second from ts))::int,"
+			 " extract(microseconds from ts)::int % 1000000"
+			 " FROM (SELECT timestamp '1999-12-31 23:00:00' + g * interval '37 minutes 13.217 seconds' AS ts"
+			 " FROM generate_series(1, 10000) g) s");
+	rc = SQLBindCol(hstmt, 1, SQL_C_TYPE_TIMESTAMP, &ts, sizeof(ts), &ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	for (i = 0; i < 7; i++)
+	{
+		rc = SQLBindCol(hstmt, i + 2, SQL_C_SLONG, &parts[i], 0, &partinds[i]);
+		CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	}
+	for (nrows = mismatches = 0; SQL_NO_DATA != (rc = SQLFetch(hstmt)); nrows++)
+	{
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		if (ts.year != parts[0] || ts.month != parts[1] ||
+			ts.day != parts[2] || ts.hour != parts[3] ||
+			ts.minute != parts[4] || ts.second != parts[5] ||
+			ts.fraction != (SQLUINTEGER) parts[6] * 1000)
+			mismatches++;
+	}
+	printf("%d rows, %d mismatches\n", nrows, mismatches);
+	if (nrows != NUM_ROWS)
+		printf("expected %d rows\n", NUM_ROWS);
+	close_stmt();
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
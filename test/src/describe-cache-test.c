@@ -0,0 +1,176 @@
+/*
+ * Test the connection-wide cache of query descriptions.
+ *
+ * Describing a prepared statement before its execution should follow DDL,
+ * changes of search_path, rollbacks and commits undoing SET LOCAL, whether
+ * the description comes from the server or from the cache. DDL inside a
+ * function is not detected, which shows that the cache is used at all.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+exec_sql(const char *sql)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+/*
+ * Prepare the query in a new statement handle and print its result
+ * columns, then execute it if param is positive.
+ */
+static void
+describe(const char *query, SQLINTEGER param)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLSMALLINT	numcols, i;
+	SQLCHAR		colname[64], typename[64];
+	SQLLEN		cbParam = sizeof(param);
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) query, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+
+	rc = SQLNumResultCols(hstmt, &numcols);
+	CHECK_STMT_RESULT(rc, "SQLNumResultCols failed", hstmt);
+	printf("%d columns:", numcols);
+	for (i = 1; i <= numcols; i++)
+	{
+		rc = SQLDescribeCol(hstmt, i, colname, sizeof(colname), NULL, NULL, NULL, NULL, NULL);
+		CHECK_STMT_RESULT(rc, "SQLDescribeCol failed", hstmt);
+		rc = SQLColAttribute(hstmt, i, SQL_DESC_TYPE_NAME, typename, sizeof(typename), NULL, NULL);
+		CHECK_STMT_RESULT(rc, "SQLColAttribute failed", hstmt);
+		printf(" %s %s", colname, typename);
+	}
+	printf("\n");
+
+	if (param > 0)
+	{
+		rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+							  SQL_C_LONG,	/* value type */
+							  SQL_INTEGER,	/* param type */
+							  0,			/* column size */
+							  0,			/* dec digits */
+							  &param,		/* param value ptr */
+							  0,			/* buffer len */
+							  &cbParam		/* StrLen_or_IndPtr */);
+		CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+		rc = SQLExecute(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+		print_result(hstmt);
+	}
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+/*
+ * DDL executed inside a function isn't detected, so the cached
+ * description becomes stale. This shows whether the cache is used.
+ */
+static void
+ddl_in_function(void)
+{
+	exec_sql("CREATE TEMPORARY TABLE descfunc (id int4)");
+	exec_sql("CREATE OR REPLACE FUNCTION descfunc_add_column() RETURNS void AS $$"
+			 " BEGIN ALTER TABLE descfunc ADD COLUMN f float8; END;"
+			 " $$ LANGUAGE plpgsql");
+	describe("SELECT * FROM descfunc WHERE id = ?", 0);
+	exec_sql("SELECT descfunc_add_column()");
+	describe("SELECT * FROM descfunc WHERE id = ?", 0);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+
+	test_connect_ext("DescribeCacheSize=2;UseServerSidePrepare=0");
+
+	exec_sql("CREATE TEMPORARY TABLE desctest (id int4, t text)");
+	exec_sql("INSERT INTO desctest VALUES (1, 'one'), (2, 'two')");
+
+	/* The same query twice, the second description may be cached */
+	printf("Describe twice\n");
+	describe("SELECT * FROM desctest WHERE id = ?", 0);
+	describe("SELECT * FROM desctest WHERE id = ?", 1);
+
+	/* DDL */
+	printf("ALTER TABLE\n");
+	exec_sql("ALTER TABLE desctest ADD COLUMN n numeric");
+	describe("SELECT * FROM desctest WHERE id = ?", 2);
+
+	/* Rollback of DDL */
+	printf("Rollback\n");
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr AUTOCOMMIT failed", conn);
+	exec_sql("ALTER TABLE desctest DROP COLUMN t");
+	describe("SELECT * FROM desctest WHERE id = ?", 0);
+	rc = SQLEndTran(SQL_HANDLE_DBC, conn, SQL_ROLLBACK);
+	CHECK_CONN_RESULT(rc, "SQLEndTran failed", conn);
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_ON, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr AUTOCOMMIT failed", conn);
+	describe("SELECT * FROM desctest WHERE id = ?", 0);
+
+	/* The temporary table hides testtab1 unless search_path says otherwise */
+	printf("search_path\n");
+	exec_sql("CREATE TEMPORARY TABLE testtab1 (x int2)");
+	describe("SELECT * FROM testtab1", 0);
+	exec_sql("SET search_path = public, pg_temp");
+	describe("SELECT * FROM testtab1", 0);
+	exec_sql("RESET search_path");
+	describe("SELECT * FROM testtab1", 0);
+
+	/* COMMIT undoes SET LOCAL */
+	printf("SET LOCAL\n");
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr AUTOCOMMIT failed", conn);
+	exec_sql("SET LOCAL search_path = public, pg_temp");
+	describe("SELECT * FROM testtab1", 0);
+	rc = SQLEndTran(SQL_HANDLE_DBC, conn, SQL_COMMIT);
+	CHECK_CONN_RESULT(rc, "SQLEndTran failed", conn);
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_ON, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr AUTOCOMMIT failed", conn);
+	describe("SELECT * FROM testtab1", 0);
+
+	/* SET which isn't the first statement of the query */
+	printf("search_path in a multi-statement query\n");
+	exec_sql("SELECT 1; SET search_path = public, pg_temp");
+	describe("SELECT * FROM testtab1", 0);
+	exec_sql("RESET search_path");
+	describe("SELECT * FROM testtab1", 0);
+
+	printf("DDL in a function with the cache\n");
+	ddl_in_function();
+	test_disconnect();
+
+	printf("DDL in a function without the cache\n");
+	test_connect_ext("DescribeCacheSize=0;UseServerSidePrepare=0");
+	ddl_in_function();
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
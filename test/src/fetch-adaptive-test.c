@@ -0,0 +1,98 @@
+/*
+ * Test the adaptive sizing of the FETCH blocks of declare/fetch cursors
+ * (FetchTargetBytes option).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+/*
+ * Read all the rows of a query, checking that the second column, if any,
+ * has the expected length.
+ */
+static void
+fetch_all(HSTMT hstmt, const char *sql, SQLLEN width)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	id;
+	char		buf[2048];
+	SQLLEN		ind;
+	long		rows = 0, sum = 0;
+	int			complete = 1;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &id, 0, &ind);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		rows++;
+		sum += id;
+		if (width > 0)
+		{
+			rc = SQLGetData(hstmt, 2, SQL_C_CHAR, buf, sizeof(buf), &ind);
+			CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+			if (ind != width || (SQLLEN) strspn(buf, "x") != width)
+				complete = 0;
+		}
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("rows: %ld, sum: %ld", rows, sum);
+	if (width > 0)
+		printf(", values complete: %s", complete ? "yes" : "no");
+	printf("\n");
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	id[7];
+	SQLLEN		cbLen[7];
+	SQLULEN		rowsFetched;
+	int			totalRows = 0;
+
+	/* blocks of 5 rows at first, growing up to 4kB or 64 rows */
+	test_connect_ext("UseDeclareFetch=1;FetchTargetBytes=4096;FetchMinRows=5;FetchMaxRows=64;FetchReadAhead=50");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	/* narrow rows */
+	fetch_all(hstmt, "SELECT g FROM generate_series(1, 300) g", 0);
+
+	/* wide rows */
+	fetch_all(hstmt, "SELECT g, repeat('x', 1000) FROM generate_series(1, 50) g", 1000);
+
+	/* block cursor */
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 7, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_ARRAY_SIZE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &rowsFetched, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROWS_FETCHED_PTR failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, &id, 0, cbLen);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 60) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		totalRows += (int) rowsFetched;
+		printf("fetched rows=%d, first=%d, total rows=%d\n", (int) rowsFetched, (int) id[0], totalRows);
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * Test reading ahead the next FETCH of declare/fetch cursors
+ * (FetchReadAhead option).
+ *
+ * A sequence bumped by every row the cursor produces shows how many rows
+ * the server has sent when another statement takes the connection.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+static HSTMT
+alloc_stmt(void)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	return hstmt;
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt, hstmt2;
+	SQLSMALLINT	colids[1] = { 1 };
+	SQLINTEGER	id[5];
+	SQLLEN		cbLen[5];
+	SQLULEN		rowsFetched;
+	int			totalRows = 0;
+	SQLCHAR		sqlstate[6];
+
+	/* read 10 rows at a time, send the next FETCH at the half */
+	test_connect_ext("UseDeclareFetch=1;Fetch=10;FetchReadAhead=50");
+	hstmt = alloc_stmt();
+	hstmt2 = alloc_stmt();
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, 'row ' || g FROM generate_series(1, 25) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* another statement on the connection while a FETCH is in flight */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 30) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result_series(hstmt, colids, 1, 17, FALSE);
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "SELECT 'other statement'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+	print_result(hstmt2);
+	rc = SQLFreeStmt(hstmt2, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt2);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* closing the statement with a FETCH in flight */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 100) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result_series(hstmt, colids, 1, 8, FALSE);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT 'after close'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* block cursor */
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 5, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_ARRAY_SIZE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &rowsFetched, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROWS_FETCHED_PTR failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, &id, 0, cbLen);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g FROM generate_series(1, 42) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		totalRows += (int) rowsFetched;
+		printf("fetched rows=%d, first=%d, total rows=%d\n", (int) rowsFetched, (int) id[0], totalRows);
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	test_disconnect();
+
+	/* rows read ahead, and a failing statement while a FETCH is in flight */
+	test_connect_ext("UseDeclareFetch=1;Fetch=10;FetchReadAhead=50;Protocol=7.4-2");
+	hstmt = alloc_stmt();
+	hstmt2 = alloc_stmt();
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "CREATE TEMPORARY SEQUENCE readahead_seq", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+	rc = SQLFreeStmt(hstmt2, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt2);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, nextval('readahead_seq') FROM generate_series(1, 30) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result_series(hstmt, colids, 1, 17, FALSE);
+	/* 20 without the read-ahead */
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "SELECT last_value FROM readahead_seq", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+	print_result(hstmt2);
+	rc = SQLFreeStmt(hstmt2, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt2);
+
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "SELECT 1/0", SQL_NTS);
+	if (SQL_SUCCEEDED(rc))
+	{
+		printf("SELECT 1/0 succeeded\n");
+		exit(1);
+	}
+	rc = SQLGetDiagRec(SQL_HANDLE_STMT, hstmt2, 1, sqlstate, NULL, NULL, 0, NULL);
+	printf("SELECT 1/0 failed with %s\n", sqlstate);
+	rc = SQLFreeStmt(hstmt2, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt2);
+	/* the statement is rolled back, the cursor is still usable */
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
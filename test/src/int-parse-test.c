@@ -0,0 +1,184 @@
+/*
+ * Test converting the text of integer columns to the integer C types,
+ * at the boundaries of the types and with narrowing conversions.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	NUM_ROWS	10000
+#define	ROWSET		100
+
+static HSTMT	hstmt = SQL_NULL_HSTMT;
+
+static void
+exec_sql(const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+}
+
+static void
+close_stmt(void)
+{
+	SQLRETURN	rc;
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt UNBIND failed", hstmt);
+}
+
+static void
+fetch_value(const char *value, SQLSMALLINT ctype, const char *ctypename)
+{
+	SQLRETURN	rc;
+	union
+	{
+		SQLSCHAR	ti;
+		SQLCHAR		uti;
+		SQLSMALLINT	si;
+		SQLUSMALLINT	usi;
+		SQLINTEGER	i;
+		SQLUINTEGER	ui;
+		SQLBIGINT	bi;
+		SQLUBIGINT	ubi;
+		SQLDOUBLE	d;
+	}			buf;
+	SQLLEN		ind;
+	char		sql[100];
+
+	snprintf(sql, sizeof(sql), "SELECT %s", value);
+	exec_sql(sql);
+	rc = SQLBindCol(hstmt, 1, ctype, &buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("%s as %s: ", value, ctypename);
+	if (SQL_NULL_DATA == ind)
+		printf("NULL\n");
+	else switch (ctype)
+	{
+		case SQL_C_STINYINT:
+			printf("%d\n", (int) buf.ti);
+			break;
+		case SQL_C_UTINYINT:
+			printf("%u\n", (unsigned int) buf.uti);
+			break;
+		case SQL_C_SSHORT:
+			printf("%d\n", (int) buf.si);
+			break;
+		case SQL_C_USHORT:
+			printf("%u\n", (unsigned int) buf.usi);
+			break;
+		case SQL_C_SLONG:
+			printf("%d\n", (int) buf.i);
+			break;
+		case SQL_C_ULONG:
+			printf("%u\n", (unsigned int) buf.ui);
+			break;
+		case SQL_C_SBIGINT:
+			printf("%lld\n", (long long) buf.bi);
+			break;
+		case SQL_C_UBIGINT:
+			printf("%llu\n", (unsigned long long) buf.ubi);
+			break;
+		case SQL_C_DOUBLE:
+			printf("%g\n", (double) buf.d);
+			break;
+	}
+	close_stmt();
+}
+
+#define	FETCH_VALUE(value, ctype)	fetch_value(value, ctype, #ctype)
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	SQLBIGINT	ids[ROWSET];
+	SQLINTEGER	vals[ROWSET];
+	SQLLEN		idinds[ROWSET], valinds[ROWSET];
+	SQLULEN		nfetched, i;
+	int			nrows, nulls, mismatches;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	CHECK_STMT_RESULT(rc, "SQLAllocHandle failed", hstmt);
+
+	FETCH_VALUE("(-32768)::int2", SQL_C_SSHORT);
+	FETCH_VALUE("32767::int2", SQL_C_SSHORT);
+	FETCH_VALUE("(-1)::int2", SQL_C_USHORT);
+	FETCH_VALUE("300::int2", SQL_C_UTINYINT);
+	FETCH_VALUE("(-129)::int2", SQL_C_STINYINT);
+	FETCH_VALUE("(-2147483648)::int4", SQL_C_SLONG);
+	FETCH_VALUE("2147483647::int4", SQL_C_SLONG);
+	FETCH_VALUE("(-1)::int4", SQL_C_ULONG);
+	FETCH_VALUE("70000::int4", SQL_C_SSHORT);
+	FETCH_VALUE("2147483647::int4", SQL_C_SBIGINT);
+	FETCH_VALUE("(-9223372036854775808)::int8", SQL_C_SBIGINT);
+	FETCH_VALUE("9223372036854775807::int8", SQL_C_SBIGINT);
+	FETCH_VALUE("(-1)::int8", SQL_C_UBIGINT);
+	FETCH_VALUE("9223372036854775807::int8", SQL_C_UBIGINT);
+	FETCH_VALUE("4294967295::oid", SQL_C_ULONG);
+	FETCH_VALUE("4294967295::oid", SQL_C_SBIGINT);
+	FETCH_VALUE("NULL::int8", SQL_C_SBIGINT);
+
+	/* Text and numeric values are decoded up to the first non-digit */
+	FETCH_VALUE("' +42abc'::text", SQL_C_SLONG);
+	FETCH_VALUE("12.7::numeric", SQL_C_SLONG);
+	FETCH_VALUE("-12.7::numeric", SQL_C_SBIGINT);
+	FETCH_VALUE("'99999999999999999999'::text", SQL_C_SBIGINT);
+	FETCH_VALUE("'-99999999999999999999'::text", SQL_C_SBIGINT);
+	FETCH_VALUE("'18446744073709551615'::text", SQL_C_UBIGINT);
+	FETCH_VALUE("'18446744073709551616'::text", SQL_C_UBIGINT);
+	FETCH_VALUE("'abc'::text", SQL_C_SBIGINT);
+
+	FETCH_VALUE("1.5::float8", SQL_C_DOUBLE);
+	FETCH_VALUE("(-2.5e-3)::float8", SQL_C_DOUBLE);
+	FETCH_VALUE("'-Infinity'::float8", SQL_C_DOUBLE);
+
+	/* Compare a bound bigint column with the values computed here */
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_ARRAY_SIZE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &nfetched, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROWS_FETCHED_PTR failed", hstmt);
+	exec_sql("SELECT g * 922337203685477::int8 - 4611686018427387904,"
+			 " CASE WHEN g % 7 = 0 THEN NULL ELSE -g END"
+			 " FROM generate_series(1, 10000) g");
+	rc = SQLBindCol(hstmt, 1, SQL_C_SBIGINT, ids, 0, idinds);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_SLONG, vals, 0, valinds);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	nrows = nulls = mismatches = 0;
+	while (SQL_NO_DATA != (rc = SQLFetch(hstmt)))
+	{
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		for (i = 0; i < nfetched; i++)
+		{
+			nrows++;
+			if (ids[i] != nrows * (SQLBIGINT) 922337203685477 - (SQLBIGINT) 4611686018427387904)
+				mismatches++;
+			if (SQL_NULL_DATA == valinds[i])
+				nulls++;
+			else if (vals[i] != -nrows)
+				mismatches++;
+		}
+	}
+	printf("%d rows, %d nulls, %d mismatches\n", nrows, nulls, mismatches);
+	if (nrows != NUM_ROWS)
+		printf("expected %d rows\n", NUM_ROWS);
+	close_stmt();
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
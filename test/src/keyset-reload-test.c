@@ -0,0 +1,125 @@
+/*
+ * Test reloading the rowsets of keyset-driven cursors, with plain and
+ * inherited tables.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	ROWSET	50
+
+static HSTMT	hstmte = SQL_NULL_HSTMT;
+
+static void
+exec_other(const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmte, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmte);
+	rc = SQLFreeStmt(hstmte, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmte);
+}
+
+/*
+ * Fetch a rowset and print the rows whose id is a multiple of every.
+ */
+static void
+fetch_rowset(HSTMT hstmt, SQLLEN offset, int every)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	id[ROWSET];
+	SQLLEN		idind[ROWSET];
+	char		val[ROWSET][20];
+	SQLLEN		valind[ROWSET];
+	SQLULEN		nrows, i;
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &nrows, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROWS_FETCHED_PTR failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, id, 0, idind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_CHAR, val, sizeof(val[0]), valind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, offset);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	printf("absolute %d: %d rows\n", (int) offset, (int) nrows);
+	for (i = 0; i < nrows; i++)
+	{
+		if (id[i] % every == 0)
+			printf("  %d '%s'\n", (int) id[i], val[i]);
+	}
+}
+
+static void
+open_cursor(HSTMT hstmt, const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CONCURRENCY, (SQLPOINTER) SQL_CONCUR_ROWVER, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr CONCURRENCY failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) SQL_CURSOR_KEYSET_DRIVEN, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr CURSOR_TYPE failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr ROW_ARRAY_SIZE failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	test_connect_ext("UpdatableCursors=1");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmte);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	exec_other("CREATE TEMPORARY TABLE keyset_reload (id int4 PRIMARY KEY, val text)");
+	exec_other("INSERT INTO keyset_reload SELECT g, 'val ' || g FROM generate_series(1, 200) g");
+
+	/* The whole rowsets are reloaded when scrolling */
+	printf("Plain table\n");
+	open_cursor(hstmt, "SELECT id, val FROM keyset_reload ORDER BY id");
+	fetch_rowset(hstmt, 1, 25);
+	fetch_rowset(hstmt, 151, 25);
+	exec_other("UPDATE keyset_reload SET val = 'updated ' || id WHERE id % 20 = 0");
+	fetch_rowset(hstmt, 101, 10);
+	fetch_rowset(hstmt, 1, 10);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* The rows of different tables may share the same ctid */
+	exec_other("CREATE TEMPORARY TABLE keyset_parent (id int4, val text)");
+	exec_other("CREATE TEMPORARY TABLE keyset_child () INHERITS (keyset_parent)");
+	exec_other("INSERT INTO keyset_parent SELECT g, 'parent ' || g FROM generate_series(1, 3) g");
+	exec_other("INSERT INTO keyset_child SELECT g + 100, 'child ' || g FROM generate_series(1, 3) g");
+
+	printf("Inherited tables\n");
+	open_cursor(hstmt, "SELECT id, val FROM keyset_parent ORDER BY id");
+	fetch_rowset(hstmt, 1, 1);
+	fetch_rowset(hstmt, 4, 1);
+	fetch_rowset(hstmt, 1, 1);
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmte);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmte);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
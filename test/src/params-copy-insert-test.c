@@ -0,0 +1,114 @@
+/*
+ * Test loading parameter arrays of simple INSERT statements with
+ * COPY FROM STDIN (CopyInsert option).
+ *
+ * COPY doesn't apply rules, so the rows of a table with rules are
+ * inserted by INSERT.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	ARRAYSIZE	5
+
+static void
+print_status(SQLRETURN rc, HSTMT hstmt, SQLUSMALLINT status[])
+{
+	SQLLEN	rowcount = 0;
+	int		i;
+
+	printf("insert into test_copy returns %d\n", rc);
+	if (SQL_SUCCEEDED(rc))
+	{
+		rc = SQLRowCount(hstmt, &rowcount);
+		CHECK_STMT_RESULT(rc, "SQLRowCount failed", hstmt);
+		printf("row count=%d\n", (int) rowcount);
+	}
+	for (i = 0; i < ARRAYSIZE; i++)
+	{
+		printf("row %d status=%s\n", i,
+			(status[i] == SQL_PARAM_SUCCESS ? "success" :
+			(status[i] == SQL_PARAM_UNUSED ? "unused" :
+			(status[i] == SQL_PARAM_ERROR ? "error" :
+			(status[i] == SQL_PARAM_SUCCESS_WITH_INFO ? "success_with_info" : "????")))));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	ids[ARRAYSIZE] = { 1, 2, 3, 4, 5 };
+	SQLLEN		idind[ARRAYSIZE];
+	SQLCHAR		texts[ARRAYSIZE][20] = { "plain", "tab\there", "new\nline", "back\\slash", "" };
+	SQLLEN		textind[ARRAYSIZE] = { SQL_NTS, SQL_NTS, SQL_NTS, SQL_NTS, SQL_NULL_DATA };
+	SQLCHAR		bins[ARRAYSIZE][4] = { { 0x01, 0x02 }, { 0x5c, 0x09 }, { 0x0a, 0x00 }, { 0xff }, { 0 } };
+	SQLLEN		binind[ARRAYSIZE] = { 2, 2, 2, 1, SQL_NULL_DATA };
+	SQLUSMALLINT	status[ARRAYSIZE];
+	int		i;
+
+	test_connect_ext("CopyInsert=1");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "create temporary table test_copy(id int4 primary key, t text, b bytea)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "create table failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "create temporary table test_copy_ruled(id int4, t text, b bytea)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "create table failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "create temporary table test_copy_log(id int4)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "create table failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "create rule test_copy_ruled_log as on insert to test_copy_ruled do also insert into test_copy_log values (new.id)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "create rule failed", hstmt);
+
+	for (i = 0; i < ARRAYSIZE; i++)
+		idind[i] = sizeof(SQLINTEGER);
+	SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) ARRAYSIZE, 0);
+	SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_STATUS_PTR, status, 0);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, ids, 0, idind);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter 1 failed", hstmt);
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, sizeof(texts[0]), 0, texts, sizeof(texts[0]), textind);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter 2 failed", hstmt);
+	rc = SQLBindParameter(hstmt, 3, SQL_PARAM_INPUT, SQL_C_BINARY, SQL_VARBINARY, sizeof(bins[0]), 0, bins, sizeof(bins[0]), binind);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter 3 failed", hstmt);
+
+	/* All the rows are loaded at once */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy (id, t, b) VALUES (?, ?, ?)", SQL_NTS);
+	print_status(rc, hstmt, status);
+
+	/* A duplicate key fails all the rows */
+	ids[0] = 6;
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy (id, t, b) VALUES (?, ?, ?)", SQL_NTS);
+	print_status(rc, hstmt, status);
+
+	/* A table with a rule, which COPY would skip */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy_ruled (id, t, b) VALUES (?, ?, ?)", SQL_NTS);
+	printf("insert into test_copy_ruled returns %d\n", rc);
+	for (i = 0; i < ARRAYSIZE; i++)
+		printf("row %d status=%s\n", i, status[i] == SQL_PARAM_SUCCESS ? "success" : "not success");
+
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) 1, 0);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT (SELECT count(*) FROM test_copy_ruled), (SELECT count(*) FROM test_copy_log)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, replace(replace(replace(t, E'\\t', '<TAB>'), E'\\n', '<NL>'), E'\\\\', '<BS>'), encode(b, 'hex') FROM test_copy ORDER BY id", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
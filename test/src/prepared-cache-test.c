@@ -0,0 +1,122 @@
+/*
+ * Test the connection-wide cache of prepared statements.
+ *
+ * Statement handles which prepare the same query share the server-side
+ * plan, and the least recently used plan is deallocated when the cache
+ * is full. DDL and changes of search_path discard the shared plans.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+exec_sql(const char *sql)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+static void
+run_prepared(const char *query, SQLINTEGER param)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLLEN		cbParam = sizeof(param);
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) query, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+						  SQL_C_LONG,	/* value type */
+						  SQL_INTEGER,	/* param type */
+						  0,			/* column size */
+						  0,			/* dec digits */
+						  &param,		/* param value ptr */
+						  0,			/* buffer len */
+						  &cbParam		/* StrLen_or_IndPtr */);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	print_result(hstmt);
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+static void
+count_plans(const char *pattern)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	char		query[256];
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	snprintf(query, sizeof(query), "SELECT count(*) FROM pg_prepared_statements WHERE statement LIKE '%s%%'", pattern);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) query, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	int		i;
+
+	test_connect_ext("PreparedCacheSize=2");
+
+	/* The same query from different statement handles */
+	for (i = 1; i <= 3; i++)
+		run_prepared("SELECT id, t FROM testtab1 WHERE id = ?", i);
+	count_plans("SELECT id, t FROM testtab1 WHERE id = ");
+
+	/* Push the first query out of the cache and run it again */
+	run_prepared("SELECT t FROM testtab1 WHERE id = ?", 1);
+	run_prepared("SELECT id FROM testtab1 WHERE id > ?", 1);
+	run_prepared("SELECT id, t FROM testtab1 WHERE id = ?", 2);
+
+	/* The shared plan follows DDL */
+	exec_sql("CREATE TEMPORARY TABLE prepddl (id int4)");
+	exec_sql("INSERT INTO prepddl VALUES (1)");
+	run_prepared("SELECT * FROM prepddl WHERE id = ?", 1);
+	exec_sql("ALTER TABLE prepddl ADD COLUMN t text DEFAULT 'added'");
+	run_prepared("SELECT * FROM prepddl WHERE id = ?", 1);
+
+	/* and search_path */
+	exec_sql("CREATE TEMPORARY TABLE testtab1 (id int4, t text)");
+	exec_sql("INSERT INTO testtab1 VALUES (1, 'temporary')");
+	run_prepared("SELECT id, t FROM testtab1 WHERE id = ?", 1);
+	exec_sql("SET search_path = public, pg_temp");
+	run_prepared("SELECT id, t FROM testtab1 WHERE id = ?", 1);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
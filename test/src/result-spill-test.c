@@ -0,0 +1,118 @@
+/*
+ * Test spilling the rows of a result to a temporary file
+ * (SpillThreshold option).
+ */
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	SPILL_QUERY	"SELECT g, 'row ' || g || ' ' || repeat('x', 50), g / 4.0::float8, (g / 8.0)::numeric(10,3) FROM generate_series(1, 3000) g"
+
+/*
+ * The conversions of float and numeric values replace the decimal point
+ * in place when the locale's one isn't '.', so try such a locale.
+ */
+static void
+set_comma_locale(void)
+{
+	static const char *locales[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR", NULL};
+	int		i;
+
+	for (i = 0; NULL != locales[i]; i++)
+	{
+		if (NULL != setlocale(LC_NUMERIC, locales[i]))
+			return;
+	}
+}
+
+static void
+print_row(HSTMT hstmt, const char *label)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	id;
+	char		buf[100], num[20], *p;
+	SQLDOUBLE	f;
+	SQLLEN		ind;
+
+	rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &id, 0, &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	rc = SQLGetData(hstmt, 2, SQL_C_CHAR, buf, 20, &ind);
+	if (!SQL_SUCCEEDED(rc))
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	set_comma_locale();
+	rc = SQLGetData(hstmt, 3, SQL_C_DOUBLE, &f, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	rc = SQLGetData(hstmt, 4, SQL_C_CHAR, num, sizeof(num), NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	setlocale(LC_NUMERIC, "C");
+	if (NULL != (p = strchr(num, ',')))
+		*p = '.';
+	printf("%s: %d '%s' (%d) %g %s\n", label, (int) id, buf, (int) ind, f, num);
+}
+
+static void
+fetch_scroll(HSTMT hstmt, SQLSMALLINT orientation, SQLLEN offset, const char *label)
+{
+	SQLRETURN	rc;
+
+	rc = SQLFetchScroll(hstmt, orientation, offset);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	print_row(hstmt, label);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	id;
+	SQLLEN		ind;
+	long		rows = 0, sum = 0;
+
+	/* the rows beyond 64kB go to the temporary file */
+	test_connect_ext("SpillThreshold=64");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	/* read forward */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) SPILL_QUERY, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &id, 0, &ind);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		rows++;
+		sum += id;
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("rows: %ld, sum: %ld\n", rows, sum);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* scroll back and forth through the spilled blocks */
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) SQL_CURSOR_STATIC, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr CURSOR_TYPE failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) SPILL_QUERY, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	fetch_scroll(hstmt, SQL_FETCH_ABSOLUTE, 2500, "absolute 2500");
+	fetch_scroll(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_scroll(hstmt, SQL_FETCH_ABSOLUTE, 10, "absolute 10");
+	fetch_scroll(hstmt, SQL_FETCH_LAST, 0, "last");
+	fetch_scroll(hstmt, SQL_FETCH_FIRST, 0, "first");
+	fetch_scroll(hstmt, SQL_FETCH_RELATIVE, 1000, "relative 1000");
+	fetch_scroll(hstmt, SQL_FETCH_NEXT, 0, "next");
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * Test the UTF-8 <-> UTF-16 conversions of the Unicode driver with
+ * strings mixing runs of ASCII characters of various lengths, line feeds
+ * and non-ASCII characters, surrogate pairs included.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	MAXLEN	1000
+
+static HSTMT	hstmt = SQL_NULL_HSTMT;
+
+/* ASCII characters, LF, é, €, U+1F600 */
+static const char *pieces[] = {"a", "\n", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80"};
+
+static int		ncompared = 0;
+
+static void
+append_piece(int piece, int count, char *utf8, SQLWCHAR *utf16, int *ulen, BOOL lfconv)
+{
+	int			i;
+
+	for (i = 0; i < count; i++)
+	{
+		strcat(utf8, 0 == piece ? (i % 26 == 25 ? "z" : "a") : pieces[piece]);
+		switch (piece)
+		{
+			case 0:
+				utf16[(*ulen)++] = (i % 26 == 25 ? 'z' : 'a');
+				break;
+			case 1:
+				if (lfconv)
+					utf16[(*ulen)++] = '\r';
+				utf16[(*ulen)++] = '\n';
+				break;
+			case 2:
+				utf16[(*ulen)++] = 0xe9;
+				break;
+			case 3:
+				utf16[(*ulen)++] = 0x20ac;
+				break;
+			case 4:
+				utf16[(*ulen)++] = 0xd83d;
+				utf16[(*ulen)++] = 0xde00;
+				break;
+		}
+	}
+}
+
+static void
+fetch_and_compare(const char *utf8, const SQLWCHAR *expected, int ulen)
+{
+	SQLRETURN	rc;
+	SQLWCHAR	buf[MAXLEN * 2];
+	SQLLEN		ind;
+	char		sql[MAXLEN * 2];
+
+	snprintf(sql, sizeof(sql), "SELECT '%s'", utf8);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_WCHAR, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	if (ind != (SQLLEN) (ulen * sizeof(SQLWCHAR)) ||
+		memcmp(buf, expected, ulen * sizeof(SQLWCHAR)) != 0 ||
+		0 != buf[ulen])
+		printf("mismatch for \"%s\"\n", utf8);
+	ncompared++;
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/* the statement text goes through the SQLWCHAR -> UTF-8 conversion */
+static void
+execw_and_compare(const SQLWCHAR *literal, int ulen)
+{
+	SQLRETURN	rc;
+	SQLWCHAR	sql[MAXLEN * 2], buf[MAXLEN * 2];
+	SQLLEN		ind;
+	int			i, len = 0;
+	const char *select = "SELECT '";
+
+	for (i = 0; select[i]; i++)
+		sql[len++] = select[i];
+	memcpy(sql + len, literal, ulen * sizeof(SQLWCHAR));
+	len += ulen;
+	sql[len++] = '\'';
+	sql[len] = 0;
+	rc = SQLExecDirectW(hstmt, sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirectW failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_WCHAR, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	if (ind != (SQLLEN) (ulen * sizeof(SQLWCHAR)) ||
+		memcmp(buf, literal, ulen * sizeof(SQLWCHAR)) != 0)
+		printf("mismatch for a %d characters statement\n", len);
+	ncompared++;
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	char		utf8[MAXLEN * 2];
+	SQLWCHAR	utf16[MAXLEN * 2];
+	int			run, piece, ulen;
+
+	test_connect_ext("LFConversion=1");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	CHECK_STMT_RESULT(rc, "SQLAllocHandle failed", hstmt);
+
+	/* runs of ASCII characters around the block size, then the others */
+	for (run = 0; run <= 40; run++)
+	{
+		for (piece = 1; piece < sizeof(pieces) / sizeof(pieces[0]); piece++)
+		{
+			utf8[0] = '\0';
+			ulen = 0;
+			append_piece(0, run, utf8, utf16, &ulen, TRUE);
+			append_piece(piece, 2, utf8, utf16, &ulen, TRUE);
+			append_piece(0, 40 - run, utf8, utf16, &ulen, TRUE);
+			append_piece(piece, 1, utf8, utf16, &ulen, TRUE);
+			fetch_and_compare(utf8, utf16, ulen);
+
+			/* no LF in the statement text */
+			if (1 == piece)
+				continue;
+			ulen = 0;
+			utf8[0] = '\0';
+			append_piece(0, run, utf8, utf16, &ulen, FALSE);
+			append_piece(piece, 2, utf8, utf16, &ulen, FALSE);
+			append_piece(0, 40 - run, utf8, utf16, &ulen, FALSE);
+			execw_and_compare(utf16, ulen);
+		}
+	}
+	/* a long one */
+	utf8[0] = '\0';
+	ulen = 0;
+	append_piece(0, 700, utf8, utf16, &ulen, TRUE);
+	append_piece(4, 1, utf8, utf16, &ulen, TRUE);
+	append_piece(0, 100, utf8, utf16, &ulen, TRUE);
+	fetch_and_compare(utf8, utf16, ulen);
+	execw_and_compare(utf16, ulen);
+	printf("%d strings compared\n", ncompared);
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -19,9 +19,19 @@
 struct TupleField_
 {
 	Int4	len;		/* PG length of the current Tuple */
+	char	borrowed;	/* value is owned by the result (arena or PGresult) */
 	void	*value;		/* an array representing the value */
 };
 
+/*	free the value unless it is borrowed from the result */
+#define	TUPLE_FREE_VALUE(t) \
+do { \
+	if ((t)->value && !(t)->borrowed) \
+		free((t)->value); \
+	(t)->value = NULL; \
+	(t)->borrowed = FALSE; \
+} while (0)
+
 /*	keyset(TID + OID) info */
 struct KeySet_
 {
@@ -227,6 +227,7 @@ LINK32_FLAGS=$(LINK32_FLAGS) /libpath:"$(PG_LIB)"
 !ENDIF
 
 LINK32_OBJS= \
+	"$(INTDIR)\arrow.obj" \
 	"$(INTDIR)\bind.obj" \
 	"$(INTDIR)\columninfo.obj" \
 	"$(INTDIR)\connection.obj" \
@@ -122,6 +122,140 @@ int get_convtype(void)
 
 static int little_endian = -1;
 
+/*
+ *	ASCII fast paths of the utf8 <-> ucs2 conversions.
+ *
+ *	The runs of ASCII characters are converted 16 at a time with SSE2
+ *	on x86-64 (when SQLWCHAR is 2 bytes) and the other characters one
+ *	by one by the loops below.
+ */
+#if	defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define	UTF_SIMD
+#include <emmintrin.h>
+#endif
+
+/*
+ * Returns the length of the leading run of str[0..len) consisting of
+ * the ASCII characters other than NUL (and LF if lfconv), and stores
+ * them widened into ucs2str, bufcount SQLWCHARs at most.
+ */
+static SQLLEN
+utf8_ascii_run(const UCHAR *str, SQLLEN len, BOOL lfconv,
+			   SQLWCHAR *ucs2str, SQLULEN bufcount)
+{
+	SQLLEN	n = 0;
+
+#ifdef	UTF_SIMD
+	__m128i	zero = _mm_setzero_si128();
+	__m128i	lf = _mm_set1_epi8(lfconv ? PG_LINEFEED : 0);
+	__m128i	x;
+	int		special;
+
+	for (; n + 16 <= len; n += 16)
+	{
+		x = _mm_loadu_si128((const __m128i *) (str + n));
+		special = _mm_movemask_epi8(_mm_or_si128(x,
+					_mm_or_si128(_mm_cmpeq_epi8(x, zero), _mm_cmpeq_epi8(x, lf))));
+		if (0 != special)
+			break;
+		if (2 == sizeof(SQLWCHAR) && (SQLULEN) n + 16 <= bufcount)
+		{
+			_mm_storeu_si128((__m128i *) (ucs2str + n), _mm_unpacklo_epi8(x, zero));
+			_mm_storeu_si128((__m128i *) (ucs2str + n + 8), _mm_unpackhi_epi8(x, zero));
+		}
+		else
+		{
+			SQLLEN	i;
+
+			for (i = n; i < n + 16 && (SQLULEN) i < bufcount; i++)
+				ucs2str[i] = str[i];
+		}
+	}
+#endif /* UTF_SIMD */
+	for (; n < len; n++)
+	{
+		if (0 == str[n] || 0 != (str[n] & 0x80) ||
+		    (lfconv && PG_LINEFEED == str[n]))
+			break;
+		if ((SQLULEN) n < bufcount)
+			ucs2str[n] = str[n];
+	}
+	return n;
+}
+
+/*
+ * Returns the length of the leading run of ucs2str[0..len) consisting
+ * of the ASCII characters other than NUL, and stores them into utf8str.
+ */
+static SQLLEN
+ucs2_ascii_run(const SQLWCHAR *ucs2str, SQLLEN len, char *utf8str)
+{
+	SQLLEN	n = 0;
+
+#ifdef	UTF_SIMD
+	if (2 == sizeof(SQLWCHAR))
+	{
+		__m128i	zero = _mm_setzero_si128();
+		__m128i	nonascii = _mm_set1_epi16((short) 0xff80);
+		__m128i	x1, x2, bad;
+
+		for (; n + 16 <= len; n += 16)
+		{
+			x1 = _mm_loadu_si128((const __m128i *) (ucs2str + n));
+			x2 = _mm_loadu_si128((const __m128i *) (ucs2str + n + 8));
+			bad = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi16(x1, zero), _mm_cmpeq_epi16(x2, zero)),
+				_mm_andnot_si128(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(x1, x2), nonascii), zero),
+								 _mm_cmpeq_epi16(zero, zero)));
+			if (0 != _mm_movemask_epi8(bad))
+				break;
+			if (utf8str)
+				_mm_storeu_si128((__m128i *) (utf8str + n), _mm_packus_epi16(x1, x2));
+		}
+	}
+#endif /* UTF_SIMD */
+	for (; n < len; n++)
+	{
+		if (0 == ucs2str[n] || 0 != (ucs2str[n] & 0xffffff80))
+			break;
+		if (utf8str)
+			utf8str[n] = (char) ucs2str[n];
+	}
+	return n;
+}
+
+/*
+ * The exact length of the result of ucs2_to_utf8().
+ */
+static SQLLEN
+ucs2_utf8_len(const SQLWCHAR *ucs2str, SQLLEN ilen)
+{
+	SQLLEN	i, len = 0, n;
+
+	for (i = 0; i < ilen; i++)
+	{
+		if (0 < (n = ucs2_ascii_run(ucs2str + i, ilen - i, NULL)))
+		{
+			len += n;
+			i += n - 1;
+		}
+		else if (!ucs2str[i])
+			break;
+		else if ((ucs2str[i] & byte3check) == 0)
+			len += 2;
+		else if (surrog1_bits == (ucs2str[i] & surrog_check) &&
+			 i + 1 < ilen &&
+			 surrog2_bits == (ucs2str[i + 1] & surrog_check))
+		{
+			len += 4;
+			i++;
+		}
+		else
+			len += 3;
+	}
+	return len;
+}
+
 SQLULEN	ucs2strlen(const SQLWCHAR *ucs2str)
 {
 	SQLULEN	len;
@@ -149,17 +283,25 @@ MYLOG(0, "%p ilen=" FORMAT_LEN " ", ucs2str, ilen);
 	if (ilen < 0)
 		ilen = ucs2strlen(ucs2str);
 MYPRINTF(0, " newlen=" FORMAT_LEN, ilen);
-	utf8str = (char *) malloc(ilen * 4 + 1);
+	utf8str = (char *) malloc(ucs2_utf8_len(ucs2str, ilen) + 1);
 	if (utf8str)
 	{
 		int	i = 0;
 		UInt2	byte2code;
 		Int4	byte4code, surrd1, surrd2;
 		const SQLWCHAR	*wstr;
+		SQLLEN	n;
 
 		for (i = 0, wstr = ucs2str; i < ilen; i++, wstr++)
 		{
-			if (!*wstr)
+			if (!lower_identifier &&
+			    0 < (n = ucs2_ascii_run(wstr, ilen - i, utf8str + len)))
+			{
+				len += (int) n;
+				i += (int) n - 1;
+				wstr += n - 1;
+			}
+			else if (!*wstr)
 				break;
 			else if (0 == (*wstr & 0xffffff80)) /* ASCII */
 			{
@@ -264,6 +406,7 @@ utf8_to_ucs2_lf(const char *utf8str, SQLLEN ilen, BOOL lfconv,
 {
 	int			i;
 	SQLULEN		rtn, ocount, wcode;
+	SQLLEN		n;
 	const UCHAR *str;
 
 MYLOG(DETAIL_LOG_LEVEL, "ilen=" FORMAT_LEN " bufcount=" FORMAT_ULEN, ilen, bufcount);
@@ -279,7 +422,16 @@ MYPRINTF(DETAIL_LOG_LEVEL, " string=%s", utf8str);
 		ilen = strlen(utf8str);
 	for (i = 0, ocount = 0, str = (SQLCHAR *) utf8str; i < ilen && *str;)
 	{
-		if ((*str & 0x80) == 0)
+		if ((*str & 0x80) == 0 && !(lfconv && PG_LINEFEED == *str))
+		{
+			n = utf8_ascii_run(str, ilen - i, lfconv,
+					ucs2str ? ucs2str + ocount : NULL,
+					ocount < bufcount ? bufcount - ocount : 0);
+			ocount += n;
+			i += (int) n;
+			str += n;
+		}
+		else if ((*str & 0x80) == 0)
 		{
 			if (lfconv && PG_LINEFEED == *str &&
 			    (i == 0 || PG_CARRIAGE_RETURN != str[-1]))